@@ -36,6 +36,7 @@ DEFINE_uint64(run_for_seconds, 10, "Keep the experiment running for x seconds");
 DEFINE_uint64(warmup_for_seconds, 10, "Warmup for x seconds");
 // -------------------------------------------------------------------------------------
 DEFINE_bool(contention_split, true, "");
+DEFINE_bool(btree_skewed_splits, true, "Split nodes 100/0 or 90/10 instead of in the middle when keys are inserted in ascending order");
 DEFINE_uint64(cm_update_on, 7, "as exponent of 2");
 DEFINE_uint64(cm_period, 14, "as exponent of 2");
 DEFINE_uint64(cm_slowpath_threshold, 1, "");
@@ -43,8 +44,11 @@ DEFINE_uint64(cm_slowpath_threshold, 1, "");
 DEFINE_bool(xmerge, false, "");
 DEFINE_uint64(xmerge_k, 5, "");
 DEFINE_double(xmerge_target_pct, 80, "");
+DEFINE_bool(compaction, false, "Background thread that walks the leaves of all B-Trees, merges underfull ones and shrinks the height");
+DEFINE_uint64(compaction_leaves_per_second, 1000, "Rate limit of the background compaction");
 // -------------------------------------------------------------------------------------
 DEFINE_bool(optimistic_scan, true, "Jump to next leaf directly if the pointer in the parent has not changed");
+DEFINE_uint64(scan_readahead_max, 0, "Range scans read up to this many evicted leaves ahead asynchronously, the depth adapts to the scan speed (0: disabled)");
 DEFINE_bool(measure_time, false, "");
 // -------------------------------------------------------------------------------------
 DEFINE_double(tmp1, 0.0, "for ad-hoc experiments");
@@ -60,6 +64,14 @@ DEFINE_bool(btree_print_tuples_count, false, "Print # tuples in each BTree in de
 DEFINE_bool(btree_prefix_compression, true, "");
 DEFINE_bool(btree_heads, true, "Enable heads optimization in lowerBound search");
 DEFINE_int64(btree_hints, 1, "0: disabled 1: serial 1: AVX512");
+DEFINE_bool(btree_heads_array, false, "New nodes keep a contiguous copy of the slot heads at the end of the page for SIMD search");
+DEFINE_int64(btree_heads_simd, 0, "Heads array and fingerprints search kernel 0: best available 1: scalar 2: AVX2 3: AVX512 4: NEON");
+DEFINE_bool(btree_fingerprints, false, "New leaves keep a 1-byte hash per key at the end of the page to answer equality lookups with SIMD compares");
+DEFINE_bool(btree_ahi, false, "Adaptive hash index: point lookups of hot keys go straight to the leaf that held them last time");
+DEFINE_uint64(btree_ahi_entries, 1 << 16, "Adaptive hash index entries per tree (rounded up to a power of two)");
+DEFINE_uint64(merge_buffer_keys, 1024, "Keys with pending merge operands a worker keeps per tree before it applies them to the tree");
+DEFINE_bool(blob_cool_after_use, true, "Cool BLOB pages right after each access so that they are evicted before tree pages");
+DEFINE_double(vlog_gc_dead_pct, 50, "Value log segments with at least this share of dead bytes are relocated by the garbage collection (%)");
 DEFINE_bool(nc_reallocation, false, "Reallocate hot pages in non-clustered btree index");
 // -------------------------------------------------------------------------------------
 DEFINE_bool(bulk_insert, false, "");
@@ -84,11 +96,24 @@ DEFINE_bool(wal_fsync, false, "");
 DEFINE_int64(wal_variant, 0, "");
 DEFINE_uint64(wal_log_writers, 1, "");
 DEFINE_uint64(wal_buffer_size, 1024 * 1024 * 10, "");
+DEFINE_uint64(wal_gct_max_wait_us, 0, "Group committer (wal_variant=0) sleeps until a batch of WAL is pending or this deadline passed, 0: busy loop");
+DEFINE_uint64(wal_gct_batch_kib, 64, "Pending WAL that wakes the sleeping group committer, initial value if it is tuned");
+DEFINE_uint64(wal_gct_p99_target_us, 0, "Tune the batch of the sleeping group committer toward this p99 commit latency, 0: fixed batch");
+DEFINE_bool(wal_compression, false, "Group committer (wal_variant=0) writes the WAL of each worker as LZ4 blocks");
+DEFINE_string(wal_spill_dir, "/tmp", "Transactions that outgrow wal_buffer_size spill their older WAL entries to an unlinked file here");
 // -------------------------------------------------------------------------------------
 DEFINE_string(isolation_level, "si", "options: ru (READ_UNCOMMITTED), rc (READ_COMMITTED), si (SNAPSHOT_ISOLATION), ser (SERIALIZABLE)");
 DEFINE_bool(mv, true, "Multi-version");
 DEFINE_uint64(si_refresh_rate, 0, "");
 DEFINE_bool(todo, true, "");
+DEFINE_bool(cc_read_start_ts, true, "Snapshots start at the current clock value, only commits increment it. false: every start increments it too");
+DEFINE_bool(cc_lwm_thread, true, "A background thread publishes the LWMs instead of randomly chosen committing workers");
+DEFINE_uint64(cc_lwm_interval_us, 100, "Pause of the LWM thread between two rounds");
+DEFINE_uint64(cc_gc_threads, 0, "Background threads that purge the versions of the workers. 0: every worker purges its own when committing");
+DEFINE_uint64(cc_gc_batch_ts, 1024, "Timestamps a GC thread advances the purged range of a worker by in one batch");
+DEFINE_uint64(cc_gc_batch_pause_us, 0, "Pause of a GC thread between two batches, limits the rate of purging");
+DEFINE_bool(cc_lock_wait, false, "Write-write conflicts wait for the running transaction holding the tuple instead of aborting (wait-die)");
+DEFINE_uint64(cc_lock_wait_us, 10000, "Longest wait for one conflicting transaction before aborting");
 // -------------------------------------------------------------------------------------
 DEFINE_bool(vi, true, "BTree with SI using in-place version");
 DEFINE_bool(vi_delta, true, "");
@@ -116,6 +141,9 @@ DEFINE_double(garbage_in_page_pct, 15, "Threshold to trigger page-wise garbage c
 DEFINE_uint64(vi_max_chain_length, 1000, "");
 DEFINE_uint64(todo_batch_size, 1024, "");
 DEFINE_bool(history_tree_inserts, true, "");
+DEFINE_bool(history_log, false, "Keep the versions in per-worker in-memory logs, the history trees only take those that do not fit");
+DEFINE_uint64(history_log_segment_kib, 1024, "");
+DEFINE_uint64(history_log_mib, 256, "Per worker and kind of version, beyond that the versions go to the history trees");
 // -------------------------------------------------------------------------------------
 DEFINE_bool(persist, false, "");
 DEFINE_bool(recover, false, "");
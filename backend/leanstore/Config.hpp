@@ -26,6 +26,7 @@ DECLARE_bool(crc_check);
 DECLARE_uint32(print_debug_interval_s);
 // -------------------------------------------------------------------------------------
 DECLARE_bool(contention_split);
+DECLARE_bool(btree_skewed_splits);
 DECLARE_uint64(cm_update_on);
 DECLARE_uint64(cm_period);
 DECLARE_uint64(cm_slowpath_threshold);
@@ -33,8 +34,11 @@ DECLARE_uint64(cm_slowpath_threshold);
 DECLARE_bool(xmerge);
 DECLARE_uint64(xmerge_k);
 DECLARE_double(xmerge_target_pct);
+DECLARE_bool(compaction);
+DECLARE_uint64(compaction_leaves_per_second);
 // -------------------------------------------------------------------------------------
 DECLARE_bool(optimistic_scan);
+DECLARE_uint64(scan_readahead_max);
 DECLARE_bool(measure_time);
 // -------------------------------------------------------------------------------------
 DECLARE_string(zipf_path);
@@ -56,6 +60,14 @@ DECLARE_bool(btree_print_tuples_count);
 DECLARE_bool(btree_prefix_compression);
 DECLARE_int64(btree_hints);
 DECLARE_bool(btree_heads);
+DECLARE_bool(btree_heads_array);
+DECLARE_int64(btree_heads_simd);
+DECLARE_bool(btree_fingerprints);
+DECLARE_bool(btree_ahi);
+DECLARE_uint64(btree_ahi_entries);
+DECLARE_uint64(merge_buffer_keys);
+DECLARE_bool(blob_cool_after_use);
+DECLARE_double(vlog_gc_dead_pct);
 DECLARE_bool(nc_reallocation);
 DECLARE_bool(bulk_insert);
 // -------------------------------------------------------------------------------------
@@ -78,11 +90,24 @@ DECLARE_bool(wal_fsync);
 DECLARE_int64(wal_variant);
 DECLARE_uint64(wal_log_writers);
 DECLARE_uint64(wal_buffer_size);
+DECLARE_uint64(wal_gct_max_wait_us);
+DECLARE_uint64(wal_gct_batch_kib);
+DECLARE_uint64(wal_gct_p99_target_us);
+DECLARE_bool(wal_compression);
+DECLARE_string(wal_spill_dir);
 // -------------------------------------------------------------------------------------
 DECLARE_string(isolation_level);
 DECLARE_bool(mv);
 DECLARE_uint64(si_refresh_rate);
 DECLARE_bool(todo);
+DECLARE_bool(cc_read_start_ts);
+DECLARE_bool(cc_lwm_thread);
+DECLARE_uint64(cc_lwm_interval_us);
+DECLARE_uint64(cc_gc_threads);
+DECLARE_uint64(cc_gc_batch_ts);
+DECLARE_uint64(cc_gc_batch_pause_us);
+DECLARE_bool(cc_lock_wait);
+DECLARE_uint64(cc_lock_wait_us);
 // -------------------------------------------------------------------------------------
 DECLARE_bool(vi);
 DECLARE_bool(vi_delta);
@@ -110,6 +135,9 @@ DECLARE_double(garbage_in_page_pct);
 DECLARE_uint64(vi_max_chain_length);
 DECLARE_uint64(todo_batch_size);
 DECLARE_bool(history_tree_inserts);
+DECLARE_bool(history_log);
+DECLARE_uint64(history_log_segment_kib);
+DECLARE_uint64(history_log_mib);
 // -------------------------------------------------------------------------------------
 DECLARE_bool(persist);
 DECLARE_bool(recover);
@@ -1,5 +1,6 @@
 #pragma once
 #include "Units.hpp"
+#include "leanstore/utils/FunctionRef.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
 #include <functional>
@@ -9,6 +10,8 @@ namespace leanstore
 {
 // -------------------------------------------------------------------------------------
 enum class OP_RESULT : u8 { OK = 0, NOT_FOUND = 1, DUPLICATE = 2, ABORT_TX = 3, NOT_ENOUGH_SPACE = 4, OTHER = 5 };
+// ADD and MAX take and combine native s64 values, APPEND concatenates the operand to the value
+enum class MergeOperator : u8 { ADD = 0, MAX = 1, APPEND = 2 };
 struct UpdateSameSizeInPlaceDescriptor {
    u8 count = 0;
    struct Slot {
@@ -40,24 +43,19 @@ struct UpdateSameSizeInPlaceDescriptor {
 };
 // -------------------------------------------------------------------------------------
 // Interface
+// Per-tuple callbacks are taken as FunctionRef: they are only called during the operation, so there is nothing to allocate or copy
+using LookupCallback = utils::FunctionRef<void(const u8* value, u16 value_length)>;
+using UpdateCallback = utils::FunctionRef<void(u8* value, u16 value_size)>;
+using ScanCallback = utils::FunctionRef<bool(const u8* key, u16 key_length, const u8* value, u16 value_length)>;
 class KVInterface
 {
   public:
-   virtual OP_RESULT lookup(u8* key, u16 key_length, std::function<void(const u8*, u16)> payload_callback) = 0;
+   virtual OP_RESULT lookup(u8* key, u16 key_length, LookupCallback payload_callback) = 0;
    virtual OP_RESULT insert(u8* key, u16 key_length, u8* value, u16 value_length) = 0;
-   virtual OP_RESULT updateSameSizeInPlace(u8* key,
-                                           u16 key_length,
-                                           std::function<void(u8* value, u16 value_size)>,
-                                           UpdateSameSizeInPlaceDescriptor&) = 0;
+   virtual OP_RESULT updateSameSizeInPlace(u8* key, u16 key_length, UpdateCallback, UpdateSameSizeInPlaceDescriptor&) = 0;
    virtual OP_RESULT remove(u8* key, u16 key_length) = 0;
-   virtual OP_RESULT scanAsc(u8* start_key,
-                             u16 key_length,
-                             std::function<bool(const u8* key, u16 key_length, const u8* value, u16 value_length)>,
-                             std::function<void()>) = 0;
-   virtual OP_RESULT scanDesc(u8* start_key,
-                              u16 key_length,
-                              std::function<bool(const u8* key, u16 key_length, const u8* value, u16 value_length)>,
-                              std::function<void()>) = 0;
+   virtual OP_RESULT scanAsc(u8* start_key, u16 key_length, ScanCallback, std::function<void()>) = 0;
+   virtual OP_RESULT scanDesc(u8* start_key, u16 key_length, ScanCallback, std::function<void()>) = 0;
    // -------------------------------------------------------------------------------------
    virtual u64 countPages() = 0;
    virtual u64 countEntries() = 0;
@@ -67,6 +65,12 @@ class KVInterface
    virtual OP_RESULT prefixLookupForPrev(u8*, u16, std::function<void(const u8*, u16, const u8*, u16)>) { return OP_RESULT::OTHER; }
    virtual OP_RESULT append(std::function<void(u8*)>, u16, std::function<void(u8*)>, u16, std::unique_ptr<u8[]>&) { return OP_RESULT::OTHER; }
    virtual OP_RESULT rangeRemove(u8*, u16, u8*, u16, [[maybe_unused]] bool page_wise = true) { return OP_RESULT::OTHER; }
+   // Replace the whole value, the new one may be longer or shorter. upsert inserts the key when it does not exist yet
+   virtual OP_RESULT update(u8*, u16, u8*, u16) { return OP_RESULT::OTHER; }
+   virtual OP_RESULT upsert(u8*, u16, u8*, u16) { return OP_RESULT::OTHER; }
+   // Blind write: records the operand without reading the value, it is combined with the value the next time the key is read.
+   // A missing key is created with the operand as its value. Not transactional: an abort does not take the operand back
+   virtual OP_RESULT merge(u8*, u16, u8*, u16, MergeOperator) { return OP_RESULT::OTHER; }
 };
 // -------------------------------------------------------------------------------------
 using Slice = std::basic_string_view<u8>;
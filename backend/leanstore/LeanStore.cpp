@@ -86,7 +86,12 @@ LeanStore::LeanStore()
    BMC::global_bf = buffer_manager.get();
    // -------------------------------------------------------------------------------------
    DTRegistry::global_dt_registry.registerDatastructureType(0, storage::btree::BTreeLL::getMeta());
+   DTRegistry::global_dt_registry.registerDatastructureType(1, storage::btree::BTreeFixedGeneric::getMeta());
    DTRegistry::global_dt_registry.registerDatastructureType(2, storage::btree::BTreeVI::getMeta());
+   DTRegistry::global_dt_registry.registerDatastructureType(3, storage::blob::BlobStore::getMeta());
+   DTRegistry::global_dt_registry.registerDatastructureType(4, storage::blob::ValueLog::getMeta());
+   DTRegistry::global_dt_registry.registerDatastructureType(5, storage::hashing::HashTable::getMeta());
+   DTRegistry::global_dt_registry.registerDatastructureType(6, storage::blob::QueueDT::getMeta());
    // -------------------------------------------------------------------------------------
    if (FLAGS_recover) {
       deserializeState();
@@ -100,7 +105,12 @@ LeanStore::LeanStore()
    }
    // -------------------------------------------------------------------------------------
    history_tree = std::make_unique<cr::HistoryTree>();
-   cr_manager = make_unique<cr::CRManager>(*history_tree.get(), ssd_fd, end_of_block_device);
+   cr::HistoryTreeInterface* versions_space = history_tree.get();
+   if (FLAGS_history_log) {
+      history_log = std::make_unique<cr::HistoryLog>(*history_tree, FLAGS_worker_threads);
+      versions_space = history_log.get();
+   }
+   cr_manager = make_unique<cr::CRManager>(*versions_space, ssd_fd, end_of_block_device);
    cr::CRManager::global = cr_manager.get();
    cr_manager->scheduleJobSync(0, [&]() {
       history_tree->update_btrees = std::make_unique<leanstore::storage::btree::BTreeLL*[]>(FLAGS_worker_threads);
@@ -113,6 +123,9 @@ LeanStore::LeanStore()
    });
    // -------------------------------------------------------------------------------------
    buffer_manager->startBackgroundThreads();
+   if (FLAGS_compaction) {
+      startCompactionThread();
+   }
 }
 // -------------------------------------------------------------------------------------
 void LeanStore::startProfilingThread()
@@ -241,12 +254,70 @@ void LeanStore::startProfilingThread()
    profiling_thread.detach();
 }
 // -------------------------------------------------------------------------------------
+// Visits one leaf of every B-Tree per round and sleeps after each leaf to stay within FLAGS_compaction_leaves_per_second.
+// Progress is reported through the dt_compaction_* columns of the DT table
+void LeanStore::startCompactionThread()
+{
+   std::thread compaction_thread([&]() {
+      pthread_setname_np(pthread_self(), "compaction");
+      cr::CRManager::global->registerMeAsSpecialWorker();
+      const auto pause = std::chrono::nanoseconds(1000000000ull / std::max<u64>(FLAGS_compaction_leaves_per_second, 1));
+      std::unordered_map<DTID, std::string> cursors;
+      std::vector<std::tuple<DTID, storage::btree::BTreeLL*>> btrees;
+      while (bg_threads_keep_running) {
+         btrees.clear();
+         {
+            auto& registry = DTRegistry::global_dt_registry;
+            std::unique_lock guard(registry.mutex);
+            for (auto& [dt_id, dt] : registry.dt_instances_ht) {
+               if (std::get<0>(dt) == 0) {
+                  btrees.emplace_back(dt_id, reinterpret_cast<storage::btree::BTreeLL*>(std::get<1>(dt)));
+               } else if (std::get<0>(dt) == 2) {
+                  btrees.emplace_back(dt_id, reinterpret_cast<storage::btree::BTreeVI*>(std::get<1>(dt)));
+               }
+            }
+         }
+         if (btrees.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+         }
+         for (auto& [dt_id, btree] : btrees) {
+            if (!bg_threads_keep_running) {
+               break;
+            }
+            // Trees are registered right before they are created, leave new ones alone until the next round
+            if (cursors.try_emplace(dt_id).second) {
+               continue;
+            }
+            if (btree->compactionStep(cursors[dt_id])) {
+               // End of a pass, collect the value log like leaves, one segment per pause
+               while (bg_threads_keep_running && btree->collectValueLog()) {
+                  std::this_thread::sleep_for(pause);
+               }
+            }
+            std::this_thread::sleep_for(pause);
+         }
+      }
+      bg_threads_counter--;
+   });
+   bg_threads_counter++;
+   compaction_thread.detach();
+}
+// -------------------------------------------------------------------------------------
 storage::btree::BTreeLL& LeanStore::registerBTreeLL(string name, storage::btree::BTreeGeneric::Config config)
 {
    assert(btrees_ll.find(name) == btrees_ll.end());
    auto& btree = btrees_ll[name];
    DTID dtid = DTRegistry::global_dt_registry.registerDatastructureInstance(0, reinterpret_cast<void*>(&btree), name);
-   btree.create(dtid, config);
+   storage::blob::ValueLog* value_log = nullptr;
+   if (config.separate_values) {
+      const string value_log_name = name + "_vlog";
+      value_log = &value_logs[value_log_name];
+      // The buffer manager treats it like any BLOB store, through the base class
+      DTID value_log_dtid = DTRegistry::global_dt_registry.registerDatastructureInstance(
+          4, reinterpret_cast<void*>(static_cast<storage::blob::BlobStore*>(value_log)), value_log_name);
+      value_log->create(value_log_dtid, {.enable_wal = config.enable_wal});
+   }
+   btree.create(dtid, config, value_log);
    return btree;
 }
 
@@ -261,6 +332,35 @@ storage::btree::BTreeVI& LeanStore::registerBTreeVI(string name, storage::btree:
    return btree;
 }
 // -------------------------------------------------------------------------------------
+storage::blob::BlobStore& LeanStore::registerBlobStore(string name, storage::blob::BlobStore::Config config)
+{
+   assert(blob_stores.find(name) == blob_stores.end());
+   auto& blob_store = blob_stores[name];
+   DTID dtid = DTRegistry::global_dt_registry.registerDatastructureInstance(3, reinterpret_cast<void*>(&blob_store), name);
+   blob_store.create(dtid, config);
+   return blob_store;
+}
+// -------------------------------------------------------------------------------------
+storage::hashing::HashTable& LeanStore::registerHashTable(string name, storage::hashing::HashTable::Config config)
+{
+   assert(hash_tables.find(name) == hash_tables.end());
+   auto& hash_table = hash_tables[name];
+   DTID dtid = DTRegistry::global_dt_registry.registerDatastructureInstance(5, reinterpret_cast<void*>(&hash_table), name);
+   hash_table.create(dtid, config);
+   return hash_table;
+}
+// -------------------------------------------------------------------------------------
+storage::blob::QueueDT& LeanStore::registerQueue(string name, storage::blob::QueueDT::Config config)
+{
+   assert(queues.find(name) == queues.end());
+   auto& queue = queues[name];
+   // The buffer manager treats it like any BLOB store, through the base class
+   DTID dtid = DTRegistry::global_dt_registry.registerDatastructureInstance(
+       6, reinterpret_cast<void*>(static_cast<storage::blob::BlobStore*>(&queue)), name);
+   queue.create(dtid, config);
+   return queue;
+}
+// -------------------------------------------------------------------------------------
 u64 LeanStore::getConfigHash()
 {
    return config_hash;
@@ -301,19 +401,14 @@ void LeanStore::serializeState()
    d.AddMember("buffer_manager", bm_serialized, allocator);
    // -------------------------------------------------------------------------------------
    rs::Value dts(rs::kArrayType);
-   for (auto& dt : DTRegistry::global_dt_registry.dt_instances_ht) {
-      if (std::get<2>(dt.second).substr(0, 1) == "_") {
-         continue;
-      }
+   auto serializeDT = [&](const std::string& dt_name, DTType dt_type, DTID dt_id, const std::unordered_map<std::string, std::string>& serialized_dt_map) {
       rs::Value dt_json_object(rs::kObjectType);
-      const DTID dt_id = dt.first;
       rs::Value name;
-      name.SetString(std::get<2>(dt.second).c_str(), std::get<2>(dt.second).length(), allocator);
+      name.SetString(dt_name.c_str(), dt_name.length(), allocator);
       dt_json_object.AddMember("name", name, allocator);
-      dt_json_object.AddMember("type", rs::Value(std::get<0>(dt.second)), allocator);
+      dt_json_object.AddMember("type", rs::Value(dt_type), allocator);
       dt_json_object.AddMember("id", rs::Value(dt_id), allocator);
       // -------------------------------------------------------------------------------------
-      std::unordered_map<std::string, std::string> serialized_dt_map = DTRegistry::global_dt_registry.serialize(dt_id);
       rs::Value dt_serialized(rs::kObjectType);
       for (const auto& [key, value] : serialized_dt_map) {
          rs::Value k, v;
@@ -324,6 +419,16 @@ void LeanStore::serializeState()
       dt_json_object.AddMember("serialized", dt_serialized, allocator);
       // -------------------------------------------------------------------------------------
       dts.PushBack(dt_json_object, allocator);
+   };
+   for (auto& dt : DTRegistry::global_dt_registry.dt_instances_ht) {
+      if (std::get<2>(dt.second).substr(0, 1) == "_") {
+         continue;
+      }
+      serializeDT(std::get<2>(dt.second), std::get<0>(dt.second), dt.first, DTRegistry::global_dt_registry.serialize(dt.first));
+   }
+   // BTreeFixed instances that were recovered but never retrieved in this run
+   for (auto& [dt_name, recovered] : btrees_fixed_recovered) {
+      serializeDT(dt_name, 1, std::get<0>(recovered), std::get<1>(recovered));
    }
    d.AddMember("registered_datastructures", dts, allocator);
    // -------------------------------------------------------------------------------------
@@ -395,11 +500,37 @@ void LeanStore::deserializeState()
       } else if (dt_type == 2) {
          auto& btree = btrees_vi[dt_name];
          DTRegistry::global_dt_registry.registerDatastructureInstance(2, reinterpret_cast<void*>(&btree), dt_name, dt_id);
+      } else if (dt_type == 3) {
+         auto& blob_store = blob_stores[dt_name];
+         DTRegistry::global_dt_registry.registerDatastructureInstance(3, reinterpret_cast<void*>(&blob_store), dt_name, dt_id);
+      } else if (dt_type == 4) {
+         auto& value_log = value_logs[dt_name];
+         DTRegistry::global_dt_registry.registerDatastructureInstance(
+             4, reinterpret_cast<void*>(static_cast<storage::blob::BlobStore*>(&value_log)), dt_name, dt_id);
+      } else if (dt_type == 5) {
+         auto& hash_table = hash_tables[dt_name];
+         DTRegistry::global_dt_registry.registerDatastructureInstance(5, reinterpret_cast<void*>(&hash_table), dt_name, dt_id);
+      } else if (dt_type == 6) {
+         auto& queue = queues[dt_name];
+         DTRegistry::global_dt_registry.registerDatastructureInstance(
+             6, reinterpret_cast<void*>(static_cast<storage::blob::BlobStore*>(&queue)), dt_name, dt_id);
+      } else if (dt_type == 1) {
+         // Registered and deserialized by retrieveBTreeFixed once the key and value types are known
+         btrees_fixed_recovered[dt_name] = {dt_id, serialized_dt_map};
+         continue;
       } else {
          UNREACHABLE();
       }
       DTRegistry::global_dt_registry.deserialize(dt_id, serialized_dt_map);
    }
+   // Value logs are named after their tree, see registerBTreeLL. Unlike the graveyards of BTreeVI they are persisted, the leaves
+   // point into them
+   for (auto& [name, btree] : btrees_ll) {
+      auto value_log = value_logs.find(name + "_vlog");
+      if (value_log != value_logs.end()) {
+         btree.value_log = &value_log->second;
+      }
+   }
 }
 // -------------------------------------------------------------------------------------
 void LeanStore::deserializeFlags()
@@ -446,8 +577,25 @@ LeanStore::~LeanStore()
             cout << endl;
          }
       }
+      for (auto& iter : btrees_fixed) {
+         cout << "BTreeFixed: " << iter.first << ", dt_id= " << iter.second->dt_id << ", height= " << iter.second->height;
+         if (FLAGS_btree_print_tuples_count) {
+            auto& kv = dynamic_cast<KVInterface&>(*iter.second);
+            cr_manager->scheduleJobSync(0, [&]() { cout << ", #tuples= " << kv.countEntries() << endl; });
+         } else {
+            cout << endl;
+         }
+      }
    }
    // -------------------------------------------------------------------------------------
+   // Pending merge operands only live in memory
+   cr_manager->scheduleJobSync(0, [&]() {
+      for (auto& iter : btrees_ll) {
+         iter.second.foldPendingMerges();
+      }
+   });
+   cr_manager->stopGarbageCollectors();
+   // -------------------------------------------------------------------------------------
    bg_threads_keep_running = false;
    while (bg_threads_counter) {
    }
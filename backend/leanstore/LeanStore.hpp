@@ -1,10 +1,16 @@
 #pragma once
 #include "Config.hpp"
+#include "leanstore/concurrency-recovery/HistoryLog.hpp"
 #include "leanstore/concurrency-recovery/HistoryTree.hpp"
 #include "leanstore/profiling/tables/ConfigsTable.hpp"
+#include "leanstore/storage/blob/BlobStore.hpp"
+#include "leanstore/storage/blob/QueueDT.hpp"
+#include "leanstore/storage/blob/ValueLog.hpp"
+#include "leanstore/storage/btree/BTreeFixed.hpp"
 #include "leanstore/storage/btree/BTreeLL.hpp"
 #include "leanstore/storage/btree/BTreeVI.hpp"
 #include "leanstore/storage/buffer-manager/BufferManager.hpp"
+#include "leanstore/storage/hashing/HashTable.hpp"
 #include "rapidjson/document.h"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
@@ -24,6 +30,13 @@ class LeanStore
    // Poor man catalog
    std::unordered_map<string, storage::btree::BTreeLL> btrees_ll;
    std::unordered_map<string, storage::btree::BTreeVI> btrees_vi;
+   std::unordered_map<string, std::unique_ptr<storage::btree::BTreeFixedGeneric>> btrees_fixed;
+   // BTreeFixed instances found by deserializeState, their key/value types are only known once they are retrieved
+   std::unordered_map<string, std::tuple<DTID, std::unordered_map<std::string, std::string>>> btrees_fixed_recovered;
+   std::unordered_map<string, storage::blob::BlobStore> blob_stores;
+   std::unordered_map<string, storage::blob::ValueLog> value_logs;  // of the BTreeLLs with Config::separate_values
+   std::unordered_map<string, storage::hashing::HashTable> hash_tables;
+   std::unordered_map<string, storage::blob::QueueDT> queues;
    // -------------------------------------------------------------------------------------
    s32 ssd_fd;
    // -------------------------------------------------------------------------------------
@@ -37,6 +50,7 @@ class LeanStore
    GlobalStats global_stats;
    // -------------------------------------------------------------------------------------
    std::unique_ptr<cr::HistoryTree> history_tree;
+   std::unique_ptr<cr::HistoryLog> history_log;  // with FLAGS_history_log, in front of the history tree
    // -------------------------------------------------------------------------------------
   private:
    static std::list<std::tuple<string, fLS::clstring*>> persisted_string_flags;
@@ -70,11 +84,45 @@ class LeanStore
       }
       return btree_vi;
    }
+   template <typename KeyT, typename ValueT>
+   storage::btree::BTreeFixed<KeyT, ValueT>& registerBTreeFixed(string name, const storage::btree::BTreeGeneric::Config config)
+   {
+      assert(btrees_fixed.find(name) == btrees_fixed.end());
+      auto btree = std::make_unique<storage::btree::BTreeFixed<KeyT, ValueT>>();
+      auto& btree_ref = *btree;
+      auto generic = static_cast<storage::btree::BTreeFixedGeneric*>(btree.get());
+      DTID dtid = DTRegistry::global_dt_registry.registerDatastructureInstance(1, reinterpret_cast<void*>(generic), name);
+      btree_ref.create(dtid, config);
+      btrees_fixed[name] = std::move(btree);
+      return btree_ref;
+   }
+   template <typename KeyT, typename ValueT>
+   storage::btree::BTreeFixed<KeyT, ValueT>& retrieveBTreeFixed(string name)
+   {
+      if (btrees_fixed.find(name) == btrees_fixed.end()) {
+         ensure(btrees_fixed_recovered.find(name) != btrees_fixed_recovered.end());
+         auto& [dt_id, serialized_dt_map] = btrees_fixed_recovered[name];
+         auto btree = std::make_unique<storage::btree::BTreeFixed<KeyT, ValueT>>();
+         auto generic = static_cast<storage::btree::BTreeFixedGeneric*>(btree.get());
+         DTRegistry::global_dt_registry.registerDatastructureInstance(1, reinterpret_cast<void*>(generic), name, dt_id);
+         DTRegistry::global_dt_registry.deserialize(dt_id, serialized_dt_map);
+         btrees_fixed[name] = std::move(btree);
+         btrees_fixed_recovered.erase(name);
+      }
+      return *static_cast<storage::btree::BTreeFixed<KeyT, ValueT>*>(btrees_fixed[name].get());
+   }
+   storage::blob::BlobStore& registerBlobStore(string name, const storage::blob::BlobStore::Config config);
+   storage::blob::BlobStore& retrieveBlobStore(string name) { return blob_stores[name]; }
+   storage::hashing::HashTable& registerHashTable(string name, const storage::hashing::HashTable::Config config);
+   storage::hashing::HashTable& retrieveHashTable(string name) { return hash_tables[name]; }
+   storage::blob::QueueDT& registerQueue(string name, const storage::blob::QueueDT::Config config);
+   storage::blob::QueueDT& retrieveQueue(string name) { return queues[name]; }
    // -------------------------------------------------------------------------------------
    storage::BufferManager& getBufferManager() { return *buffer_manager; }
    cr::CRManager& getCRManager() { return *cr_manager; }
    // -------------------------------------------------------------------------------------
    void startProfilingThread();
+   void startCompactionThread();  // started by the constructor with FLAGS_compaction
    // -------------------------------------------------------------------------------------
    static void addStringFlag(string name, fLS::clstring* flag) { persisted_string_flags.push_back(std::make_tuple(name, flag)); }
    static void addS64Flag(string name, s64* flag) { persisted_s64_flags.push_back(std::make_tuple(name, flag)); }
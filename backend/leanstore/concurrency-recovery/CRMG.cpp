@@ -4,6 +4,7 @@
 #include "leanstore/profiling/counters/WorkerCounters.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
+#include <chrono>
 #include <mutex>
 // -------------------------------------------------------------------------------------
 namespace leanstore
@@ -71,6 +72,15 @@ CRManager::CRManager(HistoryTreeInterface& versions_space, s32 ssd_fd, u64 end_o
    while (running_threads < workers_count) {
    }
    // -------------------------------------------------------------------------------------
+   if (FLAGS_todo && FLAGS_cc_lwm_thread) {
+      lwm_thread = std::thread([&]() { lwmPublisher(); });
+   }
+   if (FLAGS_todo) {
+      for (u64 gc_i = 0; gc_i < FLAGS_cc_gc_threads; gc_i++) {
+         gc_threads.emplace_back([&, gc_i]() { garbageCollector(gc_i); });
+      }
+   }
+   // -------------------------------------------------------------------------------------
    if (FLAGS_wal) {
       if (FLAGS_wal_variant == 0) {
          std::thread group_commiter([&]() {
@@ -91,6 +101,73 @@ CRManager::CRManager(HistoryTreeInterface& versions_space, s32 ssd_fd, u64 end_o
    }
 }
 // -------------------------------------------------------------------------------------
+void CRManager::lwmPublisher()
+{
+   std::string thread_name("lwm_publisher");
+   pthread_setname_np(pthread_self(), thread_name.c_str());
+   CPUCounters::registerThread(thread_name, false);
+   registerMeAsSpecialWorker();
+   auto& cc = Worker::my().cc;
+   while (keep_running) {
+      {
+         utils::Timer timer(CRCounters::myCounters().cc_ms_refresh_global_state);
+         std::unique_lock guard(Worker::global_mutex);
+         cc.updateGlobalState();
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(FLAGS_cc_lwm_interval_us));
+   }
+}
+// -------------------------------------------------------------------------------------
+// One batch per worker and round, so that a worker with a long backlog does not starve the others of the same thread.
+// A batch advances the purged range by at most FLAGS_cc_gc_batch_ts, except for the first one of a worker
+void CRManager::garbageCollector(u64 gc_i)
+{
+   std::string thread_name("gc_" + std::to_string(gc_i));
+   pthread_setname_np(pthread_self(), thread_name.c_str());
+   CPUCounters::registerThread(thread_name, false);
+   registerMeAsSpecialWorker();
+   auto& my_cc = Worker::my().cc;
+   while (gc_keep_running) {
+      bool lagging = false;
+      u64 lag_ts = 0;
+      for (u64 w_i = gc_i; w_i < workers_count; w_i += FLAGS_cc_gc_threads) {
+         auto& cc = workers[w_i]->cc;
+         const TXID all_lwm_target = cc.gc_all_lwm_target.load(std::memory_order_acquire);
+         const TXID oltp_lwm_target = cc.gc_oltp_lwm_target.load(std::memory_order_acquire);
+         if (all_lwm_target == 0) {
+            continue;
+         }
+         utils::Timer timer(CRCounters::myCounters().cc_ms_gc);
+         std::unique_lock guard(cc.gc_mutex);
+         const TXID cleaned = cc.cleaned_untill_oltp_lwm;
+         if (all_lwm_target > cleaned) {
+            lag_ts = std::max<u64>(lag_ts, all_lwm_target - cleaned);
+         }
+         const TXID batch_end = cleaned ? cleaned + FLAGS_cc_gc_batch_ts : std::numeric_limits<TXID>::max();
+         my_cc.local_all_lwm = std::min(all_lwm_target, batch_end);
+         my_cc.local_oltp_lwm = std::min(oltp_lwm_target, batch_end);
+         cc.collectGarbage(w_i, my_cc.local_all_lwm, my_cc.local_oltp_lwm);
+         lagging |= cc.cleaned_untill_oltp_lwm < all_lwm_target;
+         CRCounters::myCounters().cc_gc_batches++;
+      }
+      CRCounters::myCounters().cc_gc_lag_ts = lag_ts;
+      if (!lagging) {
+         std::this_thread::sleep_for(std::chrono::microseconds(FLAGS_cc_lwm_interval_us));
+      } else if (FLAGS_cc_gc_batch_pause_us) {
+         std::this_thread::sleep_for(std::chrono::microseconds(FLAGS_cc_gc_batch_pause_us));
+      }
+   }
+}
+// -------------------------------------------------------------------------------------
+void CRManager::stopGarbageCollectors()
+{
+   gc_keep_running = false;
+   for (auto& t : gc_threads) {
+      t.join();
+   }
+   gc_threads.clear();
+}
+// -------------------------------------------------------------------------------------
 void CRManager::registerMeAsSpecialWorker()
 {
    cr::Worker::tls_ptr = new Worker(std::numeric_limits<WORKERID>::max(), workers, workers_count, versions_space, ssd_fd, true);
@@ -170,6 +247,10 @@ CRManager::~CRManager()
    }
    while (running_threads) {
    }
+   if (lwm_thread.joinable()) {
+      lwm_thread.join();
+   }
+   stopGarbageCollectors();
    for (u64 t_i = 0; t_i < workers_count; t_i++) {
       delete workers[t_i];
    }
@@ -30,6 +30,7 @@ class CRManager
    // -------------------------------------------------------------------------------------
    std::atomic<u64> running_threads = 0;
    std::atomic<bool> keep_running = true;
+   std::atomic<bool> gc_keep_running = true;
    // -------------------------------------------------------------------------------------
    struct WorkerThread {
       std::mutex mutex;
@@ -40,6 +41,8 @@ class CRManager
       bool job_done = false;  // Job done
    };
    std::vector<std::thread> worker_threads;
+   std::thread lwm_thread;
+   std::vector<std::thread> gc_threads;
    WorkerThread worker_threads_meta[MAX_WORKER_THREADS];
    u32 workers_count;
    // -------------------------------------------------------------------------------------
@@ -85,6 +88,8 @@ class CRManager
     *
     */
    void joinAll();
+   // The GC threads purge the history trees, they have to stop before those are destroyed
+   void stopGarbageCollectors();
    // -------------------------------------------------------------------------------------
    // State Serialization
    std::unordered_map<std::string, std::string> serialize();
@@ -98,6 +103,10 @@ class CRManager
    void groupCommitCordinator();
    void groupCommiter1();
    void groupCommiter2();
+   // Publishes the oldest snapshots and the LWMs every FLAGS_cc_lwm_interval_us, so that committing workers do not have to
+   void lwmPublisher();
+   // Purges the versions of the workers w with w % FLAGS_cc_gc_threads == gc_i up to the LWMs they publish when committing
+   void garbageCollector(u64 gc_i);
    // -------------------------------------------------------------------------------------
    /**
     * @brief Set the Job to specific worker.
@@ -3,6 +3,7 @@
 // -------------------------------------------------------------------------------------
 #include "leanstore/utils/Misc.hpp"
 // -------------------------------------------------------------------------------------
+#include <chrono>
 #include <set>
 // -------------------------------------------------------------------------------------
 namespace leanstore
@@ -15,75 +16,101 @@ atomic<u64> Worker::ConcurrencyControl::global_clock = WORKERS_INCREMENT;
 // Also for interval garbage collection
 void Worker::ConcurrencyControl::refreshGlobalState()
 {
-   if (!FLAGS_todo) {
-      // Why bother
+   if (!FLAGS_todo || FLAGS_cc_lwm_thread) {
+      // Why bother, or the LWM thread publishes them
       return;
    }
    utils::Timer timer(CRCounters::myCounters().cc_ms_refresh_global_state);
    if (utils::RandomGenerator::getRandU64(0, my().workers_count) == 0 && global_mutex.try_lock()) {
-      TXID local_newest_olap = std::numeric_limits<u64>::min();
-      TXID local_oldest_oltp = std::numeric_limits<u64>::max();
-      TXID local_oldest_tx = std::numeric_limits<u64>::max();
+      updateGlobalState();
+      global_mutex.unlock();
+   }
+}
+// -------------------------------------------------------------------------------------
+// The LWMs of a worker only change with its commits and with the oldest snapshots, so we keep those of the workers for which
+// neither changed since the last round instead of searching their commit trees again
+void Worker::ConcurrencyControl::updateGlobalState()
+{
+   TXID local_newest_olap = std::numeric_limits<u64>::min();
+   TXID local_oldest_oltp = std::numeric_limits<u64>::max();
+   TXID local_oldest_tx = std::numeric_limits<u64>::max();
 
-      for (WORKERID w_i = 0; w_i < my().workers_count; w_i++) {
-         u64 its_in_flight_tx_id = global_workers_current_snapshot[w_i].load();
-         // -------------------------------------------------------------------------------------
-         while ((its_in_flight_tx_id & LATCH_BIT) && ((its_in_flight_tx_id & CLEAN_BITS_MASK) < activeTX().startTS())) {
-            its_in_flight_tx_id = global_workers_current_snapshot[w_i].load();
-         }
-         // -------------------------------------------------------------------------------------
-         const bool is_rc = its_in_flight_tx_id & RC_BIT;
-         const bool is_olap = its_in_flight_tx_id & OLAP_BIT;
-         its_in_flight_tx_id &= CLEAN_BITS_MASK;
-         if (!is_rc) {
-            local_oldest_tx = std::min<TXID>(its_in_flight_tx_id, local_oldest_tx);
-            if (is_olap) {
-               local_newest_olap = std::max<TXID>(its_in_flight_tx_id, local_newest_olap);
-            } else {
-               local_oldest_oltp = std::min<TXID>(its_in_flight_tx_id, local_oldest_oltp);
-            }
-         }
-      }
+   for (WORKERID w_i = 0; w_i < my().workers_count; w_i++) {
+      u64 its_in_flight_tx_id = global_workers_current_snapshot[w_i].load();
       // -------------------------------------------------------------------------------------
-      global_oldest_all_start_ts.store(local_oldest_tx, std::memory_order_release);
-      global_oldest_oltp_start_ts.store(local_oldest_oltp, std::memory_order_release);
-      global_newest_olap_start_ts.store(local_newest_olap, std::memory_order_release);
+      while ((its_in_flight_tx_id & LATCH_BIT) && ((its_in_flight_tx_id & CLEAN_BITS_MASK) < activeTX().startTS())) {
+         its_in_flight_tx_id = global_workers_current_snapshot[w_i].load();
+      }
       // -------------------------------------------------------------------------------------
-      TXID global_all_lwm_buffer = std::numeric_limits<TXID>::max();
-      TXID global_oltp_lwm_buffer = std::numeric_limits<TXID>::max();
-      bool skipped_a_worker = false;
-      for (WORKERID w_i = 0; w_i < my().workers_count; w_i++) {
-         if (other(w_i).local_latest_lwm_for_tx == other(w_i).local_latest_write_tx) {
-            skipped_a_worker = true;
-            continue;
+      const bool is_rc = its_in_flight_tx_id & RC_BIT;
+      const bool is_olap = its_in_flight_tx_id & OLAP_BIT;
+      its_in_flight_tx_id &= CLEAN_BITS_MASK;
+      if (!is_rc) {
+         local_oldest_tx = std::min<TXID>(its_in_flight_tx_id, local_oldest_tx);
+         if (is_olap) {
+            local_newest_olap = std::max<TXID>(its_in_flight_tx_id, local_newest_olap);
          } else {
-            other(w_i).local_latest_lwm_for_tx.store(other(w_i).local_latest_write_tx, std::memory_order_release);
+            local_oldest_oltp = std::min<TXID>(its_in_flight_tx_id, local_oldest_oltp);
          }
-         // -------------------------------------------------------------------------------------
-         TXID its_all_lwm_buffer = other(w_i).commit_tree.LCB(global_oldest_all_start_ts),
-              its_oltp_lwm_buffer = other(w_i).commit_tree.LCB(global_oldest_oltp_start_ts);
-         // -------------------------------------------------------------------------------------
-         if (FLAGS_olap_mode && global_oldest_all_start_ts != global_oldest_oltp_start_ts) {
-            // ensure(its_all_lwm_buffer <= its_oltp_lwm_buffer);
-            global_oltp_lwm_buffer = std::min<TXID>(its_oltp_lwm_buffer, global_oltp_lwm_buffer);
-         } else {
-            its_oltp_lwm_buffer = its_all_lwm_buffer;
+      }
+   }
+   // -------------------------------------------------------------------------------------
+   global_oldest_all_start_ts.store(local_oldest_tx, std::memory_order_release);
+   global_oldest_oltp_start_ts.store(local_oldest_oltp, std::memory_order_release);
+   global_newest_olap_start_ts.store(local_newest_olap, std::memory_order_release);
+   const bool separate_oltp_lwm = FLAGS_olap_mode && local_oldest_tx != local_oldest_oltp;
+   // -------------------------------------------------------------------------------------
+   TXID global_all_lwm_buffer = std::numeric_limits<TXID>::max();
+   TXID global_oltp_lwm_buffer = std::numeric_limits<TXID>::max();
+   for (WORKERID w_i = 0; w_i < my().workers_count; w_i++) {
+      ConcurrencyControl& its = other(w_i);
+      const TXID its_latest_write_tx = its.local_latest_write_tx.load();
+      if (its.local_latest_lwm_for_tx == its_latest_write_tx && its.lwm_for_oldest_all_start_ts == local_oldest_tx &&
+          its.lwm_for_oldest_oltp_start_ts == local_oldest_oltp) {
+         global_all_lwm_buffer = std::min<TXID>(its.all_lwm_receiver.load(), global_all_lwm_buffer);
+         if (separate_oltp_lwm) {
+            global_oltp_lwm_buffer = std::min<TXID>(its.oltp_lwm_receiver.load(), global_oltp_lwm_buffer);
          }
-         // -------------------------------------------------------------------------------------
-         global_all_lwm_buffer = std::min<TXID>(its_all_lwm_buffer, global_all_lwm_buffer);
-         // -------------------------------------------------------------------------------------
-         other(w_i).local_lwm_latch.store(other(w_i).local_lwm_latch.load() + 1, std::memory_order_release);  // Latch
-         other(w_i).all_lwm_receiver.store(its_all_lwm_buffer, std::memory_order_release);
-         other(w_i).oltp_lwm_receiver.store(its_oltp_lwm_buffer, std::memory_order_release);
-         other(w_i).local_lwm_latch.store(other(w_i).local_lwm_latch.load() + 1, std::memory_order_release);  // Release
+         continue;
       }
-      if (!skipped_a_worker) {
-         global_all_lwm.store(global_all_lwm_buffer, std::memory_order_release);
-         global_oltp_lwm.store(global_oltp_lwm_buffer, std::memory_order_release);
+      its.local_latest_lwm_for_tx.store(its_latest_write_tx, std::memory_order_release);
+      its.lwm_for_oldest_all_start_ts = local_oldest_tx;
+      its.lwm_for_oldest_oltp_start_ts = local_oldest_oltp;
+      // -------------------------------------------------------------------------------------
+      TXID its_all_lwm_buffer = its.commit_tree.LCB(local_oldest_tx), its_oltp_lwm_buffer = its.commit_tree.LCB(local_oldest_oltp);
+      // -------------------------------------------------------------------------------------
+      if (separate_oltp_lwm) {
+         // ensure(its_all_lwm_buffer <= its_oltp_lwm_buffer);
+         global_oltp_lwm_buffer = std::min<TXID>(its_oltp_lwm_buffer, global_oltp_lwm_buffer);
+      } else {
+         its_oltp_lwm_buffer = its_all_lwm_buffer;
       }
       // -------------------------------------------------------------------------------------
-      global_mutex.unlock();
+      global_all_lwm_buffer = std::min<TXID>(its_all_lwm_buffer, global_all_lwm_buffer);
+      // -------------------------------------------------------------------------------------
+      its.local_lwm_latch.store(its.local_lwm_latch.load() + 1, std::memory_order_release);  // Latch
+      its.all_lwm_receiver.store(its_all_lwm_buffer, std::memory_order_release);
+      its.oltp_lwm_receiver.store(its_oltp_lwm_buffer, std::memory_order_release);
+      its.local_lwm_latch.store(its.local_lwm_latch.load() + 1, std::memory_order_release);  // Release
    }
+   global_all_lwm.store(global_all_lwm_buffer, std::memory_order_release);
+   global_oltp_lwm.store(global_oltp_lwm_buffer, std::memory_order_release);
+}
+// -------------------------------------------------------------------------------------
+// Only commits have to increment the clock: a commit draws the current value, a snapshot sees the commits whose timestamp is
+// smaller than its own. Starting at the current value therefore sees all commits that finished before and none that did not,
+// the same as drawing a new value. Consecutive transactions of a worker may share a start timestamp as long as the earlier one
+// left no versions behind, only a writer that aborted forces us to increment the clock
+TXID Worker::ConcurrencyControl::drawStartTimestamp(bool prev_tx_wrote, TXID prev_tx_start_ts)
+{
+   if (!FLAGS_cc_read_start_ts) {
+      return global_clock.fetch_add(1);
+   }
+   const TXID start_ts = global_clock.load();
+   if (prev_tx_wrote && start_ts <= prev_tx_start_ts) {
+      return global_clock.fetch_add(1) + 1;
+   }
+   return start_ts;
 }
 // -------------------------------------------------------------------------------------
 void Worker::ConcurrencyControl::switchToSnapshotIsolationMode()
@@ -112,7 +139,7 @@ void Worker::ConcurrencyControl::garbageCollection()
       return;
    }
    // -------------------------------------------------------------------------------------
-   // TODO: smooth purge, we should not let the system hang on this, as a quick fix, it should be enough if we purge in small batches
+   // Purging inline lets the worker hang on it, with FLAGS_cc_gc_threads the GC threads purge in small batches instead
    utils::Timer timer(CRCounters::myCounters().cc_ms_gc);
 synclwm : {
    u64 lwm_version = local_lwm_latch.load();
@@ -125,32 +152,42 @@ synclwm : {
    }
    ensure(!FLAGS_olap_mode || local_all_lwm <= local_oltp_lwm);
 }
+   if (FLAGS_cc_gc_threads) {
+      gc_all_lwm_target.store(local_all_lwm, std::memory_order_release);
+      gc_oltp_lwm_target.store(local_oltp_lwm, std::memory_order_release);
+      return;
+   }
+   collectGarbage(my().worker_id, local_all_lwm, local_oltp_lwm);
+}
+// -------------------------------------------------------------------------------------
+void Worker::ConcurrencyControl::collectGarbage(WORKERID worker_id, TXID all_lwm, TXID oltp_lwm)
+{
    // ATTENTION: atm, with out extra sync, the two lwm can not
-   if (local_all_lwm > cleaned_untill_oltp_lwm) {
+   if (all_lwm > cleaned_untill_oltp_lwm) {
       utils::Timer timer(CRCounters::myCounters().cc_ms_gc_history_tree);
       // PURGE!
       history_tree.purgeVersions(
-          my().worker_id, 0, local_all_lwm - 1,
+          worker_id, 0, all_lwm - 1,
           [&](const TXID tx_id, const DTID dt_id, const u8* version_payload, [[maybe_unused]] u64 version_payload_length, const bool called_before) {
-             leanstore::storage::DTRegistry::global_dt_registry.todo(dt_id, version_payload, my().worker_id, tx_id, called_before);
+             leanstore::storage::DTRegistry::global_dt_registry.todo(dt_id, version_payload, worker_id, tx_id, called_before);
              COUNTERS_BLOCK()
              {
                 WorkerCounters::myCounters().cc_todo_olap_executed[dt_id]++;
              }
           },
           0);
-      cleaned_untill_oltp_lwm = std::max(local_all_lwm, cleaned_untill_oltp_lwm);
+      cleaned_untill_oltp_lwm = std::max(all_lwm, cleaned_untill_oltp_lwm);
    }
-   if (FLAGS_olap_mode && local_all_lwm != local_oltp_lwm) {
-      if (FLAGS_graveyard && local_oltp_lwm > 0 && local_oltp_lwm > cleaned_untill_oltp_lwm) {
+   if (FLAGS_olap_mode && all_lwm != oltp_lwm) {
+      if (FLAGS_graveyard && oltp_lwm > 0 && oltp_lwm > cleaned_untill_oltp_lwm) {
          utils::Timer timer(CRCounters::myCounters().cc_ms_gc_graveyard);
          // MOVE deletes to the graveyard
          const u64 from_tx_id = cleaned_untill_oltp_lwm > 0 ? cleaned_untill_oltp_lwm : 0;
-         history_tree.visitRemoveVersions(my().worker_id, from_tx_id, local_oltp_lwm - 1,
+         history_tree.visitRemoveVersions(worker_id, from_tx_id, oltp_lwm - 1,
                                           [&](const TXID tx_id, const DTID dt_id, const u8* version_payload,
                                               [[maybe_unused]] u64 version_payload_length, const bool called_before) {
                                              cleaned_untill_oltp_lwm = std::max(cleaned_untill_oltp_lwm, tx_id + 1);
-                                             leanstore::storage::DTRegistry::global_dt_registry.todo(dt_id, version_payload, my().worker_id, tx_id,
+                                             leanstore::storage::DTRegistry::global_dt_registry.todo(dt_id, version_payload, worker_id, tx_id,
                                                                                                      called_before);
                                              COUNTERS_BLOCK()
                                              {
@@ -263,6 +300,107 @@ TXID Worker::ConcurrencyControl::CommitTree::commit(TXID start_ts)
    return commit_ts;
 }
 // -------------------------------------------------------------------------------------
+// Like CommitTree::commit, but the commit tree stays latched during the validation: readers that started after commit_ts wait
+// for the outcome instead of missing a transaction that commits before them
+TXID Worker::ConcurrencyControl::commitSerializable(TXID start_ts)
+{
+   utils::Timer timer(CRCounters::myCounters().cc_ms_ser_validation);
+   PrecisionLocks::WriteSet& write_set = precision_locks.publish();
+   commit_tree.mutex.lock();
+   assert(commit_tree.cursor < commit_tree.capacity);
+   const TXID commit_ts = global_clock.fetch_add(1);
+   write_set.commit_ts.store(commit_ts, std::memory_order_release);
+   bool valid = true;
+   for (WORKERID w_i = 0; w_i < my().workers_count && valid; w_i++) {
+      if (w_i != my().worker_id) {
+         valid = precision_locks.validate(other(w_i).precision_locks, start_ts, commit_ts);
+      }
+   }
+   if (valid) {
+      commit_tree.array[commit_tree.cursor++] = {commit_ts, start_ts};
+   } else {
+      write_set.commit_ts.store(PrecisionLocks::WriteSet::ABORTED, std::memory_order_release);
+      CRCounters::myCounters().cc_ser_validation_aborts++;
+   }
+   commit_tree.mutex.unlock();
+   // Transactions that start from now on draw larger start timestamps than all published commit timestamps of this worker.
+   // Read committed workers do not validate
+   TXID oldest_start_ts = std::numeric_limits<TXID>::max();
+   for (WORKERID w_i = 0; w_i < my().workers_count; w_i++) {
+      const u64 its_snapshot = global_workers_current_snapshot[w_i].load();
+      if (!(its_snapshot & RC_BIT)) {
+         oldest_start_ts = std::min<TXID>(oldest_start_ts, its_snapshot & CLEAN_BITS_MASK);
+      }
+   }
+   precision_locks.retire(oldest_start_ts);
+   return valid ? commit_ts : 0;
+}
+// -------------------------------------------------------------------------------------
+void Worker::ConcurrencyControl::noteLockConflict(DTID dt_id, Slice key, WORKERID its_worker_id, TXID its_tx_ts)
+{
+   CRCounters::myCounters().cc_lock_conflicts++;
+   // A commit timestamp means its writer finished, waiting would not change anything
+   lock_conflict.pending = FLAGS_cc_lock_wait && its_worker_id != my().worker_id && !(its_tx_ts & MSB);
+   lock_conflict.worker_id = its_worker_id;
+   lock_conflict.tx_ts = its_tx_ts;
+   lock_conflict.slot_i = LockWaits::slotOf(dt_id, key);
+}
+// -------------------------------------------------------------------------------------
+// Wait-die: only a transaction that is older than the holder, by (start timestamp, worker id), waits for it, so no cycle of waits
+// can form. A holder that commits under snapshot isolation still aborts the waiter on the retry, waiting pays off when it aborts
+// and for read committed waiters
+bool Worker::ConcurrencyControl::waitForLockHolder()
+{
+   if (!lock_conflict.pending) {
+      return false;
+   }
+   lock_conflict.pending = false;
+   auto holding = [&]() { return other(lock_conflict.worker_id).lock_holder_tx.load() == lock_conflict.tx_ts; };
+   if (!holding()) {
+      return false;  // it finished before the conflict, the retry would run into the same tuple
+   }
+   if (std::make_pair(my().active_tx.startTS(), my().worker_id) > std::make_pair(lock_conflict.tx_ts, u64(lock_conflict.worker_id))) {
+      CRCounters::myCounters().cc_lock_wait_dies++;
+      return false;
+   }
+   utils::Timer timer(CRCounters::myCounters().cc_ms_lock_wait);
+   CRCounters::myCounters().cc_lock_waits++;
+   LockWaits::Slot& slot = LockWaits::slot(lock_conflict.slot_i);
+   const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(FLAGS_cc_lock_wait_us);
+   bool released = false;
+   slot.waiters++;
+   while (true) {
+      // The epoch is read before the holder is checked: a release in between changes it and the futex does not sleep
+      const u32 epoch = slot.epoch.load();
+      if (!holding()) {
+         released = true;
+         break;
+      }
+      if (std::chrono::steady_clock::now() >= deadline) {
+         break;
+      }
+      LockWaits::park(lock_conflict.slot_i, epoch, deadline);
+   }
+   slot.waiters--;
+   if (!released) {
+      CRCounters::myCounters().cc_lock_wait_timeouts++;
+   }
+   return released;
+}
+// -------------------------------------------------------------------------------------
+void Worker::ConcurrencyControl::releaseLocks()
+{
+   lock_conflict.pending = false;
+   if (lock_holder_tx.load(std::memory_order_relaxed) == 0) {
+      return;
+   }
+   lock_holder_tx.store(0);
+   for (const u64 slot_i : locked_slots) {
+      LockWaits::wake(slot_i);
+   }
+   locked_slots.clear();
+}
+// -------------------------------------------------------------------------------------
 std::optional<std::pair<TXID, TXID>> Worker::ConcurrencyControl::CommitTree::LCBUnsafe(TXID start_ts)
 {
    const auto begin = array;
@@ -1,4 +1,5 @@
 #include "CRMG.hpp"
+#include "WALCompression.hpp"
 #include "leanstore/profiling/counters/CPUCounters.hpp"
 #include "leanstore/profiling/counters/CRCounters.hpp"
 #include "leanstore/profiling/counters/WorkerCounters.hpp"
@@ -8,6 +9,7 @@
 #include <libaio.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <thread>
@@ -54,6 +56,28 @@ void CRManager::groupCommiter()
       iocbs_ptr[io_slot] = &iocbs[io_slot];
       io_slot++;
    };
+   // Writes the pending requests and waits for them, their buffers can be reused afterwards
+   auto submit_pwrites = [&]() {
+      u32 submitted = 0;
+      u32 left = io_slot;
+      while (left) {
+         s32 ret_code = io_submit(aio_context, left, iocbs_ptr.get() + submitted);
+         if (ret_code != s32(io_slot)) {
+            cout << ret_code << "," << io_slot << "," << ssd_offset << endl;
+            ensure(false);
+         }
+         posix_check(ret_code >= 0);
+         submitted += ret_code;
+         left -= ret_code;
+      }
+      {
+         if (io_slot > 0) {
+            const s32 done_requests = io_getevents(aio_context, submitted, submitted, events.get(), NULL);
+            posix_check(done_requests >= 0);
+         }
+      }
+      io_slot = 0;
+   };
    // -------------------------------------------------------------------------------------
    LID min_all_workers_gsn;  // For Remote Flush Avoidance
    LID max_all_workers_gsn;  // Sync all workers to this point
@@ -63,8 +87,62 @@ void CRManager::groupCommiter()
    ready_to_commit_rfa_cut.resize(workers_count, 0);
    wt_to_lw_copy.resize(workers_count);
    // -------------------------------------------------------------------------------------
+   std::vector<Transaction::CommitCallback> commit_callbacks;  // of the transactions committed in the current round
+   // -------------------------------------------------------------------------------------
+   // WAL compression: the WAL of all workers is cut into pieces of at most compression_piece_size bytes, whose blocks are staged
+   // in one buffer shared by all workers. Once it is full, or the IO slots are, the staged blocks are written before the round goes on
+   static constexpr u64 compression_piece_size = 1024 * 1024;
+   const u64 staging_size = WALCompressedBlock::maxBlockSize(compression_piece_size) * 4;
+   std::unique_ptr<u8, decltype(&std::free)> staging(nullptr, &std::free);
+   u64 staged = 0;
+   if (FLAGS_wal_compression) {
+      staging.reset(reinterpret_cast<u8*>(std::aligned_alloc(512, staging_size)));
+   }
+   auto add_compressed = [&](WORKERID w_i, const u8* wal, u64 wal_size, u64 wal_offset, u64& round_bytes) {
+      for (u64 done = 0; done < wal_size;) {
+         const u64 piece_size = std::min(wal_size - done, compression_piece_size);
+         if (staged + WALCompressedBlock::maxBlockSize(piece_size) > staging_size || io_slot == s32(batch_max_size)) {
+            submit_pwrites();
+            staged = 0;
+         }
+         u8* block = staging.get() + staged;
+         const u64 block_size = WALCompressedBlock::write(block, w_i, wal + done, piece_size, wal_offset + done);
+         staged += block_size;
+         round_bytes += block_size;
+         if (FLAGS_wal_pwrite) {
+            ssd_offset -= block_size;
+            add_pwrite(block, block_size, ssd_offset);
+            // -------------------------------------------------------------------------------------
+            COUNTERS_BLOCK()
+            {
+               CRCounters::myCounters().gct_write_bytes += block_size;
+               CRCounters::myCounters().gct_write_bytes_uncompressed += piece_size;
+            }
+         }
+         done += piece_size;
+      }
+   };
+   // -------------------------------------------------------------------------------------
+   // Adaptive group commit: commit latencies since the batch size was last tuned
+   u64 tuning_window[CRCounters::histogram_buckets] = {0};
+   u64 tuning_window_tx = 0;
+   static constexpr u64 tuning_window_min_tx = 1024;
+   Worker::Logging::gct_batch_bytes = FLAGS_wal_gct_batch_kib * 1024;
+   // -------------------------------------------------------------------------------------
    while (keep_running) {
+      if (FLAGS_wal_gct_max_wait_us) {
+         const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(FLAGS_wal_gct_max_wait_us);
+         std::unique_lock<std::mutex> g(Worker::Logging::gct_mutex);
+         Worker::Logging::gct_sleeping = true;
+         Worker::Logging::gct_cv.wait_until(
+             g, deadline, [&]() { return Worker::Logging::gct_pending_bytes >= Worker::Logging::gct_batch_bytes; });
+         Worker::Logging::gct_sleeping = false;
+         g.unlock();
+         Worker::Logging::gct_pending_bytes = 0;
+      }
+      u64 round_bytes = 0;
       io_slot = 0;
+      staged = 0;
       round_i++;
       CRCounters::myCounters().gct_rounds++;
       COUNTERS_BLOCK() { phase_1_begin = std::chrono::high_resolution_clock::now(); }
@@ -87,17 +165,32 @@ void CRManager::groupCommiter()
             min_all_workers_gsn = std::min<LID>(min_all_workers_gsn, wt_to_lw_copy[w_i].last_gsn);
             min_all_workers_hardened_commit_ts = std::min<TXID>(min_all_workers_hardened_commit_ts, wt_to_lw_copy[w_i].precommitted_tx_commit_ts);
          }
-         if (wt_to_lw_copy[w_i].wal_written_offset > worker.logging.wal_gct_cursor) {
+         if (FLAGS_wal_compression && wt_to_lw_copy[w_i].wal_written_offset != worker.logging.wal_gct_cursor) {
+            // Exact ranges instead of aligned ones, a block is written only once
+            const u64 cursor = worker.logging.wal_gct_cursor;
+            const u64 written_offset = wt_to_lw_copy[w_i].wal_written_offset;
+            if (written_offset > cursor) {
+               add_compressed(w_i, worker.logging.wal_buffer + cursor, written_offset - cursor, cursor, round_bytes);
+            } else {
+               add_compressed(w_i, worker.logging.wal_buffer + cursor, FLAGS_wal_buffer_size - cursor, cursor, round_bytes);
+               add_compressed(w_i, worker.logging.wal_buffer, written_offset, 0, round_bytes);
+            }
+         } else if (wt_to_lw_copy[w_i].wal_written_offset > worker.logging.wal_gct_cursor) {
             const u64 lower_offset = utils::downAlign(worker.logging.wal_gct_cursor);
             const u64 upper_offset = utils::upAlign(wt_to_lw_copy[w_i].wal_written_offset);
             const u64 size_aligned = upper_offset - lower_offset;
+            round_bytes += size_aligned;
             // -------------------------------------------------------------------------------------
             if (FLAGS_wal_pwrite) {
                // TODO: add the concept of chunks
                ssd_offset -= size_aligned;
                add_pwrite(worker.logging.wal_buffer + lower_offset, size_aligned, ssd_offset);
                // -------------------------------------------------------------------------------------
-               COUNTERS_BLOCK() { CRCounters::myCounters().gct_write_bytes += size_aligned; }
+               COUNTERS_BLOCK()
+               {
+                  CRCounters::myCounters().gct_write_bytes += size_aligned;
+                  CRCounters::myCounters().gct_write_bytes_uncompressed += size_aligned;
+               }
             }
          } else if (wt_to_lw_copy[w_i].wal_written_offset < worker.logging.wal_gct_cursor) {
             {
@@ -105,12 +198,17 @@ void CRManager::groupCommiter()
                const u64 lower_offset = utils::downAlign(worker.logging.wal_gct_cursor);
                const u64 upper_offset = FLAGS_wal_buffer_size;
                const u64 size_aligned = upper_offset - lower_offset;
+               round_bytes += size_aligned;
                // -------------------------------------------------------------------------------------
                if (FLAGS_wal_pwrite) {
                   ssd_offset -= size_aligned;
                   add_pwrite(worker.logging.wal_buffer + lower_offset, size_aligned, ssd_offset);
                   // -------------------------------------------------------------------------------------
-                  COUNTERS_BLOCK() { CRCounters::myCounters().gct_write_bytes += size_aligned; }
+                  COUNTERS_BLOCK()
+                  {
+                     CRCounters::myCounters().gct_write_bytes += size_aligned;
+                     CRCounters::myCounters().gct_write_bytes_uncompressed += size_aligned;
+                  }
                }
             }
             {
@@ -118,12 +216,17 @@ void CRManager::groupCommiter()
                const u64 lower_offset = 0;
                const u64 upper_offset = utils::upAlign(wt_to_lw_copy[w_i].wal_written_offset);
                const u64 size_aligned = upper_offset - lower_offset;
+               round_bytes += size_aligned;
                // -------------------------------------------------------------------------------------
                if (FLAGS_wal_pwrite) {
                   ssd_offset -= size_aligned;
                   add_pwrite(worker.logging.wal_buffer, size_aligned, ssd_offset);
                   // -------------------------------------------------------------------------------------
-                  COUNTERS_BLOCK() { CRCounters::myCounters().gct_write_bytes += size_aligned; }
+                  COUNTERS_BLOCK()
+                  {
+                     CRCounters::myCounters().gct_write_bytes += size_aligned;
+                     CRCounters::myCounters().gct_write_bytes_uncompressed += size_aligned;
+                  }
                }
             }
          }
@@ -139,28 +242,9 @@ void CRManager::groupCommiter()
       // Flush
       if (FLAGS_wal_pwrite) {
          ensure(ssd_offset % 512 == 0);
-         if (FLAGS_wal_pwrite) {
-            u32 submitted = 0;
-            u32 left = io_slot;
-            while (left) {
-               s32 ret_code = io_submit(aio_context, left, iocbs_ptr.get() + submitted);
-               if (ret_code != s32(io_slot)) {
-                  cout << ret_code << "," << io_slot << "," << ssd_offset << endl;
-                  ensure(false);
-               }
-               posix_check(ret_code >= 0);
-               submitted += ret_code;
-               left -= ret_code;
-            }
-            {
-               if (io_slot > 0) {
-                  const s32 done_requests = io_getevents(aio_context, submitted, submitted, events.get(), NULL);
-                  posix_check(done_requests >= 0);
-               }
-            }
-            if (FLAGS_wal_fsync) {
-               fdatasync(ssd_fd);
-            }
+         submit_pwrites();
+         if (FLAGS_wal_fsync) {
+            fdatasync(ssd_fd);
          }
       }
       // -------------------------------------------------------------------------------------
@@ -178,7 +262,15 @@ void CRManager::groupCommiter()
          TXID signaled_up_to = std::numeric_limits<TXID>::max();
          // TODO: prevent contention on mutex
          {
-            worker.logging.wal_gct_cursor.store(wt_to_lw_copy[w_i].wal_written_offset, std::memory_order_release);
+            worker.logging.advanceGCTCursor(wt_to_lw_copy[w_i].wal_written_offset);
+            const auto time_now = std::chrono::high_resolution_clock::now();
+            auto count_latency = [&](Transaction& tx) {
+               const u64 latency_us = std::chrono::duration_cast<std::chrono::microseconds>(time_now - tx.stats.precommit).count();
+               const u64 bucket = CRCounters::histogramBucket(latency_us);
+               CRCounters::myCounters().gct_commit_latency_us[bucket]++;
+               tuning_window[bucket]++;
+               tuning_window_tx++;
+            };
             std::unique_lock<std::mutex> g(worker.logging.precommitted_queue_mutex);
             // -------------------------------------------------------------------------------------
             u64 tx_i = 0;
@@ -187,18 +279,22 @@ void CRManager::groupCommiter()
                  worker.logging.precommitted_queue[tx_i].start_ts <= min_all_workers_hardened_commit_ts;
                  tx_i++) {
                worker.logging.precommitted_queue[tx_i].state = Transaction::STATE::COMMITTED;
+               count_latency(worker.logging.precommitted_queue[tx_i]);
             }
             if (tx_i > 0) {
                signaled_up_to = std::min<TXID>(signaled_up_to, worker.logging.precommitted_queue[tx_i - 1].commitTS());
+               Worker::Logging::takeCommitCallbacks(worker.logging.precommitted_queue, tx_i, commit_callbacks);
                worker.logging.precommitted_queue.erase(worker.logging.precommitted_queue.begin(), worker.logging.precommitted_queue.begin() + tx_i);
                committed_tx += tx_i;
             }
             // -------------------------------------------------------------------------------------
             for (tx_i = 0; tx_i < ready_to_commit_rfa_cut[w_i]; tx_i++) {
                worker.logging.precommitted_queue_rfa[tx_i].state = Transaction::STATE::COMMITTED;
+               count_latency(worker.logging.precommitted_queue_rfa[tx_i]);
             }
             if (tx_i > 0) {
                signaled_up_to = std::min<TXID>(signaled_up_to, worker.logging.precommitted_queue_rfa[tx_i - 1].commitTS());
+               Worker::Logging::takeCommitCallbacks(worker.logging.precommitted_queue_rfa, tx_i, commit_callbacks);
                worker.logging.precommitted_queue_rfa.erase(worker.logging.precommitted_queue_rfa.begin(),
                                                            worker.logging.precommitted_queue_rfa.begin() + tx_i);
                committed_tx += tx_i;
@@ -208,7 +304,27 @@ void CRManager::groupCommiter()
             worker.logging.signaled_commit_ts.store(signaled_up_to, std::memory_order_release);
          }
       }
+      for (auto& callback : commit_callbacks) {
+         callback(true);
+      }
+      commit_callbacks.clear();
       CRCounters::myCounters().gct_committed_tx += committed_tx;
+      if (round_bytes) {
+         CRCounters::myCounters().gct_round_bytes[CRCounters::histogramBucket(round_bytes)]++;
+      }
+      // Halve the batch while the p99 latency misses the target, double it while it is well below
+      if (FLAGS_wal_gct_max_wait_us && FLAGS_wal_gct_p99_target_us && tuning_window_tx >= tuning_window_min_tx) {
+         const u64 p99_us = CRCounters::histogramPercentile(tuning_window, 0.99);
+         const u64 batch_bytes = Worker::Logging::gct_batch_bytes;
+         if (p99_us > FLAGS_wal_gct_p99_target_us) {
+            Worker::Logging::gct_batch_bytes = std::max<u64>(batch_bytes / 2, 512);
+         } else if (p99_us * 2 < FLAGS_wal_gct_p99_target_us) {
+            Worker::Logging::gct_batch_bytes = std::min<u64>(batch_bytes * 2, FLAGS_wal_buffer_size / 2);
+         }
+         std::fill_n(tuning_window, CRCounters::histogram_buckets, 0);
+         tuning_window_tx = 0;
+      }
+      CRCounters::myCounters().gct_batch_bytes = Worker::Logging::gct_batch_bytes.load();
       COUNTERS_BLOCK()
       {
          phase_2_end = std::chrono::high_resolution_clock::now();
@@ -62,6 +62,7 @@ void CRManager::groupCommiter1()
          ready_to_commit_rfa_cut.resize(workers_range_size, 0);
          wt_to_lw_copy.resize(workers_range_size);
          // -------------------------------------------------------------------------------------
+         std::vector<Transaction::CommitCallback> commit_callbacks;  // of the transactions committed in the current round
          while (keep_running) {
             io_slot = 0;
             round_i++;
@@ -86,7 +87,11 @@ void CRManager::groupCommiter1()
                      const u64 ssd_offset = g_ssd_offset.fetch_add(-size_aligned) - size_aligned;
                      add_pwrite(worker.logging.wal_buffer + lower_offset, size_aligned, ssd_offset);
                      // -------------------------------------------------------------------------------------
-                     COUNTERS_BLOCK() { CRCounters::myCounters().gct_write_bytes += size_aligned; }
+                     COUNTERS_BLOCK()
+                     {
+                        CRCounters::myCounters().gct_write_bytes += size_aligned;
+                        CRCounters::myCounters().gct_write_bytes_uncompressed += size_aligned;
+                     }
                   }
                } else if (wt_to_lw_copy[w_i - w_begin_i].wal_written_offset < worker.logging.wal_gct_cursor) {
                   {
@@ -99,7 +104,11 @@ void CRManager::groupCommiter1()
                         const u64 ssd_offset = g_ssd_offset.fetch_add(-size_aligned) - size_aligned;
                         add_pwrite(worker.logging.wal_buffer + lower_offset, size_aligned, ssd_offset);
                         // -------------------------------------------------------------------------------------
-                        COUNTERS_BLOCK() { CRCounters::myCounters().gct_write_bytes += size_aligned; }
+                        COUNTERS_BLOCK()
+                        {
+                           CRCounters::myCounters().gct_write_bytes += size_aligned;
+                           CRCounters::myCounters().gct_write_bytes_uncompressed += size_aligned;
+                        }
                      }
                   }
                   {
@@ -112,7 +121,11 @@ void CRManager::groupCommiter1()
                         const u64 ssd_offset = g_ssd_offset.fetch_add(-size_aligned) - size_aligned;
                         add_pwrite(worker.logging.wal_buffer, size_aligned, ssd_offset);
                         // -------------------------------------------------------------------------------------
-                        COUNTERS_BLOCK() { CRCounters::myCounters().gct_write_bytes += size_aligned; }
+                        COUNTERS_BLOCK()
+                        {
+                           CRCounters::myCounters().gct_write_bytes += size_aligned;
+                           CRCounters::myCounters().gct_write_bytes_uncompressed += size_aligned;
+                        }
                      }
                   }
                } else if (wt_to_lw_copy[w_i - w_begin_i].wal_written_offset == worker.logging.wal_gct_cursor) {
@@ -155,7 +168,7 @@ void CRManager::groupCommiter1()
                TXID signaled_up_to = std::numeric_limits<TXID>::max();
                // TODO: prevent contention on mutex
                {
-                  worker.logging.wal_gct_cursor.store(wt_to_lw_copy[w_i - w_begin_i].wal_written_offset, std::memory_order_release);
+                  worker.logging.advanceGCTCursor(wt_to_lw_copy[w_i - w_begin_i].wal_written_offset);
                   const auto time_now = std::chrono::high_resolution_clock::now();
                   std::unique_lock<std::mutex> g(worker.logging.precommitted_queue_mutex);
                   // -------------------------------------------------------------------------------------
@@ -180,6 +193,7 @@ void CRManager::groupCommiter1()
                   }
                   if (tx_i > 0) {
                      signaled_up_to = std::min<TXID>(signaled_up_to, worker.logging.precommitted_queue[tx_i - 1].commitTS());
+                     Worker::Logging::takeCommitCallbacks(worker.logging.precommitted_queue, tx_i, commit_callbacks);
                      worker.logging.precommitted_queue.erase(worker.logging.precommitted_queue.begin(),
                                                              worker.logging.precommitted_queue.begin() + tx_i);
                      committed_tx += tx_i;
@@ -200,6 +214,7 @@ void CRManager::groupCommiter1()
                   }
                   if (tx_i > 0) {
                      signaled_up_to = std::min<TXID>(signaled_up_to, worker.logging.precommitted_queue_rfa[tx_i - 1].commitTS());
+                     Worker::Logging::takeCommitCallbacks(worker.logging.precommitted_queue_rfa, tx_i, commit_callbacks);
                      worker.logging.precommitted_queue_rfa.erase(worker.logging.precommitted_queue_rfa.begin(),
                                                                  worker.logging.precommitted_queue_rfa.begin() + tx_i);
                      committed_tx += tx_i;
@@ -209,6 +224,10 @@ void CRManager::groupCommiter1()
                   worker.logging.signaled_commit_ts.store(signaled_up_to, std::memory_order_release);
                }
             }
+            for (auto& callback : commit_callbacks) {
+               callback(true);
+            }
+            commit_callbacks.clear();
             CRCounters::myCounters().gct_committed_tx += committed_tx;
             // CRCounters::myCounters().gct_rounds += 1;
             // CRCounters::myCounters().gct_rounds += t_i == 0;
@@ -27,6 +27,7 @@ void CRManager::groupCommiter2()
       pthread_setname_np(pthread_self(), thread_name.c_str());
       CPUCounters::registerThread(thread_name, false);
       // -------------------------------------------------------------------------------------
+      std::vector<Transaction::CommitCallback> commit_callbacks;  // of the transactions committed in the current round
       while (keep_running) {
          u64 committed_tx = 0;
          for (WORKERID w_i = 0; w_i < workers_count; w_i++) {
@@ -55,10 +56,15 @@ void CRManager::groupCommiter2()
             }
             if (tx_i > 0) {
                signaled_up_to = std::min<TXID>(signaled_up_to, worker.logging.precommitted_queue[tx_i - 1].commitTS());
+               Worker::Logging::takeCommitCallbacks(worker.logging.precommitted_queue, tx_i, commit_callbacks);
                worker.logging.precommitted_queue.erase(worker.logging.precommitted_queue.begin(), worker.logging.precommitted_queue.begin() + tx_i);
                committed_tx += tx_i;
             }
          }
+         for (auto& callback : commit_callbacks) {
+            callback(true);
+         }
+         commit_callbacks.clear();
          // -------------------------------------------------------------------------------------
          // CRCounters::myCounters().gct_rounds += 1;
       }
@@ -85,6 +91,7 @@ void CRManager::groupCommiter2()
          ready_to_commit_rfa_cut.resize(workers_range_size, 0);
          wt_to_lw_copy.resize(workers_range_size);
          // -------------------------------------------------------------------------------------
+         std::vector<Transaction::CommitCallback> commit_callbacks;  // of the transactions committed in the current round
          while (keep_running) {
             round_i++;
             // -------------------------------------------------------------------------------------
@@ -109,7 +116,11 @@ void CRManager::groupCommiter2()
                      pwrite(ssd_fd, worker.logging.wal_buffer + lower_offset, size_aligned, ssd_offset);
                      // add_pwrite(worker.logging.wal_buffer + lower_offset, size_aligned, ssd_offset);
                      // -------------------------------------------------------------------------------------
-                     COUNTERS_BLOCK() { CRCounters::myCounters().gct_write_bytes += size_aligned; }
+                     COUNTERS_BLOCK()
+                     {
+                        CRCounters::myCounters().gct_write_bytes += size_aligned;
+                        CRCounters::myCounters().gct_write_bytes_uncompressed += size_aligned;
+                     }
                   }
                } else if (wt_to_lw_copy[0].wal_written_offset < worker.logging.wal_gct_cursor) {
                   {
@@ -123,7 +134,11 @@ void CRManager::groupCommiter2()
                         pwrite(ssd_fd, worker.logging.wal_buffer + lower_offset, size_aligned, ssd_offset);
                         // add_pwrite(worker.logging.wal_buffer + lower_offset, size_aligned, ssd_offset);
                         // -------------------------------------------------------------------------------------
-                        COUNTERS_BLOCK() { CRCounters::myCounters().gct_write_bytes += size_aligned; }
+                        COUNTERS_BLOCK()
+                        {
+                           CRCounters::myCounters().gct_write_bytes += size_aligned;
+                           CRCounters::myCounters().gct_write_bytes_uncompressed += size_aligned;
+                        }
                      }
                   }
                   {
@@ -137,7 +152,11 @@ void CRManager::groupCommiter2()
                         pwrite(ssd_fd, worker.logging.wal_buffer, size_aligned, ssd_offset);
                         // add_pwrite(worker.logging.wal_buffer, size_aligned, ssd_offset);
                         // -------------------------------------------------------------------------------------
-                        COUNTERS_BLOCK() { CRCounters::myCounters().gct_write_bytes += size_aligned; }
+                        COUNTERS_BLOCK()
+                        {
+                           CRCounters::myCounters().gct_write_bytes += size_aligned;
+                           CRCounters::myCounters().gct_write_bytes_uncompressed += size_aligned;
+                        }
                      }
                   }
                } else if (wt_to_lw_copy[0].wal_written_offset == worker.logging.wal_gct_cursor) {
@@ -165,7 +184,7 @@ void CRManager::groupCommiter2()
                TXID signaled_up_to = std::numeric_limits<TXID>::max();
                // TODO: prevent contention on mutex
                {
-                  worker.logging.wal_gct_cursor.store(wt_to_lw_copy[0].wal_written_offset, std::memory_order_release);
+                  worker.logging.advanceGCTCursor(wt_to_lw_copy[0].wal_written_offset);
                   const auto time_now = std::chrono::high_resolution_clock::now();
                   std::unique_lock<std::mutex> g(worker.logging.precommitted_queue_mutex);
                   // -------------------------------------------------------------------------------------
@@ -185,6 +204,7 @@ void CRManager::groupCommiter2()
                   }
                   if (tx_i > 0) {
                      signaled_up_to = std::min<TXID>(signaled_up_to, worker.logging.precommitted_queue_rfa[tx_i - 1].commitTS());
+                     Worker::Logging::takeCommitCallbacks(worker.logging.precommitted_queue_rfa, tx_i, commit_callbacks);
                      worker.logging.precommitted_queue_rfa.erase(worker.logging.precommitted_queue_rfa.begin(),
                                                                  worker.logging.precommitted_queue_rfa.begin() + tx_i);
                      committed_tx += tx_i;
@@ -194,6 +214,10 @@ void CRManager::groupCommiter2()
                   worker.logging.signaled_commit_ts.store(signaled_up_to, std::memory_order_release);
                }
             }
+            for (auto& callback : commit_callbacks) {
+               callback(true);
+            }
+            commit_callbacks.clear();
             CRCounters::myCounters().gct_committed_tx += committed_tx;
             // CRCounters::myCounters().gct_rounds += 1;
             // CRCounters::myCounters().gct_rounds += t_i == 0;
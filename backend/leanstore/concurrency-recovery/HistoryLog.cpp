@@ -0,0 +1,271 @@
+#include "HistoryLog.hpp"
+
+#include "leanstore/Config.hpp"
+#include "leanstore/profiling/counters/CRCounters.hpp"
+#include "leanstore/profiling/counters/WorkerCounters.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace cr
+{
+// -------------------------------------------------------------------------------------
+HistoryLog::HistoryLog(HistoryTree& history_tree, u64 workers_count)
+    : history_tree(history_tree),
+      segment_size(FLAGS_history_log_segment_kib * 1024),
+      max_segments(std::max<u64>(FLAGS_history_log_mib * 1024 / FLAGS_history_log_segment_kib, 1)),
+      update_logs(std::make_unique<Log[]>(workers_count)),
+      remove_logs(std::make_unique<Log[]>(workers_count)),
+      spilled(std::make_unique<std::atomic<bool>[]>(workers_count)),
+      workers_count(workers_count)
+{
+}
+// -------------------------------------------------------------------------------------
+HistoryLog::~HistoryLog()
+{
+   for (u64 w_i = 0; w_i < workers_count; w_i++) {
+      for (Log* log : {&update_logs[w_i], &remove_logs[w_i]}) {
+         for (Segment* segment : log->segments) {
+            std::free(segment);
+         }
+         for (Segment* segment : log->free_segments) {
+            std::free(segment);
+         }
+      }
+   }
+}
+// -------------------------------------------------------------------------------------
+HistoryLog::Segment* HistoryLog::allocateSegment(Log& log)
+{
+   Segment* segment;
+   if (!log.free_segments.empty()) {
+      segment = log.free_segments.back();
+      log.free_segments.pop_back();
+   } else if (log.allocated_segments < max_segments) {
+      segment = static_cast<Segment*>(std::malloc(segment_size));
+      ensure(segment != nullptr);
+      log.allocated_segments++;
+   } else {
+      return nullptr;
+   }
+   new (segment) Segment();
+   log.segments.push_back(segment);
+   return segment;
+}
+// -------------------------------------------------------------------------------------
+// Readers mostly look for recent versions, so the segments are searched from the newest one
+HistoryLog::Position HistoryLog::lowerBound(Log& log, TXID tx_id, COMMANDID command_id)
+{
+   Position result = {log.segments.size(), 0};
+   for (u64 s_i = log.segments.size(); s_i-- > 0;) {
+      Segment* segment = log.segments[s_i];
+      u32 lower = (s_i == 0) ? log.head : 0, upper = segment->count;
+      if (lower == upper) {
+         continue;
+      }
+      if (!isLess(version(segment, lower), tx_id, command_id)) {
+         result = {s_i, lower};
+         continue;
+      }
+      while (lower < upper) {
+         const u32 mid = lower + (upper - lower) / 2;
+         if (isLess(version(segment, mid), tx_id, command_id)) {
+            lower = mid + 1;
+         } else {
+            upper = mid;
+         }
+      }
+      if (lower < segment->count) {
+         result = {s_i, lower};
+      }
+      break;
+   }
+   return result;
+}
+// -------------------------------------------------------------------------------------
+// The oldest segment stays exhausted when a purge reached the tail and the next insert needed a new segment, lowerBound skips it
+HistoryLog::Position HistoryLog::headPosition(Log& log)
+{
+   Position position = {0, log.head};
+   while (position.segment_i < log.segments.size() && position.slot == log.segments[position.segment_i]->count) {
+      position = {position.segment_i + 1, 0};
+   }
+   return position;
+}
+// -------------------------------------------------------------------------------------
+void HistoryLog::insertVersion(WORKERID worker_id,
+                               TXID tx_id,
+                               COMMANDID command_id,
+                               DTID dt_id,
+                               bool is_remove,
+                               u64 payload_length,
+                               std::function<void(u8*)> cb,
+                               bool same_thread)
+{
+   if (!FLAGS_history_tree_inserts) {
+      return;
+   }
+   const u64 version_size = (sizeof(Version) + payload_length + 7) & ~u64(7);
+   if (same_thread && sizeof(Segment) + version_size + sizeof(u32) <= segment_size) {
+      Log& log = (is_remove) ? remove_logs[worker_id] : update_logs[worker_id];
+      std::unique_lock guard(log.mutex);
+      Segment* segment = log.segments.empty() ? nullptr : log.segments.back();
+      // Start timestamps of a worker only grow, so this fails only for versions of older transactions
+      const bool in_order = segment == nullptr || segment->count == 0 || isLess(version(segment, segment->count - 1), tx_id, command_id);
+      if (in_order && (segment == nullptr || freeSpace(segment) < version_size + sizeof(u32))) {
+         segment = allocateSegment(log);
+      }
+      if (in_order && segment != nullptr) {
+         auto& new_version = *new (segment->data + segment->used) Version();
+         new_version.tx_id = tx_id;
+         new_version.command_id = command_id;
+         new_version.dt_id = dt_id;
+         new_version.payload_length = payload_length;
+         cb(new_version.payload);
+         *(slots(segment) - 1 - segment->count) = segment->used;
+         segment->used += version_size;
+         segment->count++;
+         COUNTERS_BLOCK()
+         {
+            WorkerCounters::myCounters().cc_versions_space_inserted[dt_id]++;
+         }
+         return;
+      }
+   }
+   spilled[worker_id] = true;
+   COUNTERS_BLOCK()
+   {
+      CRCounters::myCounters().cc_versions_spilled++;
+   }
+   history_tree.insertVersion(worker_id, tx_id, command_id, dt_id, is_remove, payload_length, cb, same_thread);
+}
+// -------------------------------------------------------------------------------------
+bool HistoryLog::retrieveVersion(WORKERID worker_id, TXID tx_id, COMMANDID command_id, const bool is_remove, std::function<void(const u8*, u64)> cb)
+{
+   Log& log = (is_remove) ? remove_logs[worker_id] : update_logs[worker_id];
+   {
+      std::shared_lock guard(log.mutex);
+      const Position position = lowerBound(log, tx_id, command_id);
+      if (position.segment_i < log.segments.size()) {
+         const Version& found = version(log.segments[position.segment_i], position.slot);
+         if (found.tx_id == tx_id && found.command_id == command_id) {
+            cb(found.payload, found.payload_length);
+            return true;
+         }
+      }
+   }
+   if (spilled[worker_id]) {
+      return history_tree.retrieveVersion(worker_id, tx_id, command_id, is_remove, cb);
+   }
+   return false;
+}
+// -------------------------------------------------------------------------------------
+// Purges either start at the head (garbage collection) or end at the tail (abort) of the log, anything else is left alone.
+// The callbacks run after the latch is released, the versions stay in place until their segments are recycled
+void HistoryLog::purgeLog(Log& log, TXID from_tx_id, TXID to_tx_id, RemoveVersionCallback* cb)
+{
+   std::vector<Version*> purged;
+   std::vector<Segment*> retired;
+   u64 removed_versions = 0;
+   {
+      std::unique_lock guard(log.mutex);
+      const Position begin = lowerBound(log, from_tx_id, 0);
+      const Position end = lowerBound(log, to_tx_id + 1, 0);
+      if (begin.segment_i == end.segment_i && begin.slot == end.slot) {
+         return;
+      }
+      const Position head = headPosition(log);
+      const bool at_head = begin.segment_i == head.segment_i && begin.slot == head.slot;
+      const bool at_tail = end.segment_i == log.segments.size();
+      if (!at_head && !at_tail) {
+         return;
+      }
+      for (u64 s_i = begin.segment_i; s_i < std::min(end.segment_i + 1, log.segments.size()); s_i++) {
+         Segment* segment = log.segments[s_i];
+         const u32 lower = (s_i == begin.segment_i) ? begin.slot : 0;
+         const u32 upper = (s_i == end.segment_i) ? end.slot : segment->count;
+         removed_versions += upper - lower;
+         if (cb != nullptr) {
+            for (u32 slot = lower; slot < upper; slot++) {
+               purged.push_back(&version(segment, slot));
+            }
+         }
+      }
+      if (at_head) {
+         // Whole segments go in O(1), the newest one stays for the inserts
+         const u64 retired_count = std::min(end.segment_i, log.segments.size() - 1);
+         for (u64 s_i = 0; s_i < retired_count; s_i++) {
+            retired.push_back(log.segments.front());
+            log.segments.pop_front();
+         }
+         log.head = at_tail ? log.segments.back()->count : end.slot;
+      } else {
+         while (log.segments.size() > begin.segment_i + 1) {
+            retired.push_back(log.segments.back());
+            log.segments.pop_back();
+         }
+         Segment* segment = log.segments.back();
+         segment->used = *(slots(segment) - 1 - begin.slot);
+         segment->count = begin.slot;
+         if (segment->count == 0 && log.segments.size() > 1) {
+            retired.push_back(segment);
+            log.segments.pop_back();
+         }
+      }
+   }
+   for (Version* purged_version : purged) {
+      const bool called_before = purged_version->called_before;
+      purged_version->called_before = true;
+      (*cb)(purged_version->tx_id, purged_version->dt_id, purged_version->payload, purged_version->payload_length, called_before);
+   }
+   if (!retired.empty()) {
+      std::unique_lock guard(log.mutex);
+      log.free_segments.insert(log.free_segments.end(), retired.begin(), retired.end());
+   }
+   COUNTERS_BLOCK()
+   {
+      CRCounters::myCounters().cc_versions_space_removed += removed_versions;
+   }
+}
+// -------------------------------------------------------------------------------------
+void HistoryLog::purgeVersions(WORKERID worker_id, TXID from_tx_id, TXID to_tx_id, RemoveVersionCallback cb, const u64 limit)
+{
+   purgeLog(remove_logs[worker_id], from_tx_id, to_tx_id, &cb);
+   purgeLog(update_logs[worker_id], from_tx_id, to_tx_id, nullptr);
+   if (spilled[worker_id]) {
+      history_tree.purgeVersions(worker_id, from_tx_id, to_tx_id, cb, limit);
+   }
+}
+// -------------------------------------------------------------------------------------
+void HistoryLog::visitRemoveVersions(WORKERID worker_id, TXID from_tx_id, TXID to_tx_id, RemoveVersionCallback cb)
+{
+   Log& log = remove_logs[worker_id];
+   std::vector<Version*> visited;
+   {
+      std::shared_lock guard(log.mutex);
+      const Position end = lowerBound(log, to_tx_id + 1, 0);
+      for (Position position = lowerBound(log, from_tx_id, 0); position.segment_i < end.segment_i || position.slot < end.slot;) {
+         Segment* segment = log.segments[position.segment_i];
+         visited.push_back(&version(segment, position.slot));
+         if (++position.slot == segment->count) {
+            position = {position.segment_i + 1, 0};
+         }
+      }
+   }
+   for (Version* visited_version : visited) {
+      const bool called_before = visited_version->called_before;
+      ensure(called_before == false);
+      visited_version->called_before = true;
+      cb(visited_version->tx_id, visited_version->dt_id, visited_version->payload, visited_version->payload_length, called_before);
+   }
+   if (spilled[worker_id]) {
+      history_tree.visitRemoveVersions(worker_id, from_tx_id, to_tx_id, cb);
+   }
+}
+// -------------------------------------------------------------------------------------
+}  // namespace cr
+}  // namespace leanstore
@@ -0,0 +1,97 @@
+#pragma once
+#include "HistoryTree.hpp"
+#include "HistoryTreeInterface.hpp"
+#include "Units.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace cr
+{
+// -------------------------------------------------------------------------------------
+// Keeps the versions in memory, per worker and kind in an append-only list of segments. A segment is an arena of versions
+// sorted by (tx_id, command_id), their offsets grow from its end. Purging below the LWM only moves the head of the list and
+// recycles whole segments, without touching the versions of updates. Versions that can not be appended go to the history
+// tree, whose pages are buffer-managed: once the log of a worker reached FLAGS_history_log_mib because a long-running reader
+// holds the LWM back, and those of other threads (fat tuple conversion) or out of order.
+// Pre: the purges of a worker are serialized, only its own thread inserts with same_thread
+class HistoryLog : public HistoryTreeInterface
+{
+  private:
+   struct Version {
+      TXID tx_id;
+      COMMANDID command_id;
+      DTID dt_id;
+      bool called_before = false;
+      u32 payload_length;
+      u8 payload[];
+   };
+   struct Segment {
+      u32 count = 0;  // versions
+      u32 used = 0;   // bytes of data used by them
+      u8 data[];
+   };
+   struct alignas(64) Log {
+      std::shared_mutex mutex;
+      std::deque<Segment*> segments;  // oldest first, the newest one takes the inserts
+      u32 head = 0;                   // first version in the oldest segment that was not purged yet
+      std::vector<Segment*> free_segments;
+      u64 allocated_segments = 0;
+   };
+   struct Position {
+      u64 segment_i;
+      u32 slot;
+   };
+   // -------------------------------------------------------------------------------------
+   HistoryTree& history_tree;
+   const u64 segment_size;
+   const u64 max_segments;  // per log
+   std::unique_ptr<Log[]> update_logs;
+   std::unique_ptr<Log[]> remove_logs;
+   std::unique_ptr<std::atomic<bool>[]> spilled;  // per worker, whether the history tree may have versions of it
+   const u64 workers_count;
+   // -------------------------------------------------------------------------------------
+   static bool isLess(const Version& version, TXID tx_id, COMMANDID command_id)
+   {
+      return version.tx_id < tx_id || (version.tx_id == tx_id && version.command_id < command_id);
+   }
+   u32* slots(Segment* segment) { return reinterpret_cast<u32*>(reinterpret_cast<u8*>(segment) + segment_size); }
+   Version& version(Segment* segment, u32 slot) { return *reinterpret_cast<Version*>(segment->data + *(slots(segment) - 1 - slot)); }
+   u64 freeSpace(Segment* segment) { return segment_size - sizeof(Segment) - segment->used - segment->count * sizeof(u32); }
+   // Pre: log.mutex is held. First version that is not smaller than (tx_id, command_id), the end of the log if none
+   Position lowerBound(Log& log, TXID tx_id, COMMANDID command_id);
+   // Pre: log.mutex is held. First version that was not purged yet, past the segments whose versions are all purged
+   Position headPosition(Log& log);
+   Segment* allocateSegment(Log& log);
+   void purgeLog(Log& log, TXID from_tx_id, TXID to_tx_id, RemoveVersionCallback* cb);
+
+  public:
+   HistoryLog(HistoryTree& history_tree, u64 workers_count);
+   ~HistoryLog();
+   virtual void insertVersion(WORKERID worker_id,
+                              TXID tx_id,
+                              COMMANDID command_id,
+                              DTID dt_id,
+                              bool is_remove,
+                              u64 payload_length,
+                              std::function<void(u8*)> cb,
+                              bool same_thread);
+   virtual bool retrieveVersion(WORKERID worker_id,
+                                TXID tx_id,
+                                COMMANDID command_id,
+                                const bool is_remove,
+                                std::function<void(const u8*, u64 payload_length)> cb);
+   virtual void purgeVersions(WORKERID worker_id, TXID from_tx_id, TXID to_tx_id, RemoveVersionCallback cb, const u64 limit);
+   virtual void visitRemoveVersions(WORKERID worker_id, TXID from_tx_id, TXID to_tx_id,
+                                    RemoveVersionCallback cb);  // [from, to]
+};
+// -------------------------------------------------------------------------------------
+}  // namespace cr
+}  // namespace leanstore
@@ -0,0 +1,48 @@
+#include "LockWaits.hpp"
+
+#include "leanstore/utils/FNVHash.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <climits>
+#include <ctime>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace cr
+{
+// -------------------------------------------------------------------------------------
+LockWaits::Slot LockWaits::slots[LockWaits::SLOTS];
+// -------------------------------------------------------------------------------------
+u64 LockWaits::slotOf(DTID dt_id, Slice key)
+{
+   return (utils::FNV::hash(key.data(), key.length()) ^ utils::FNV::hash(static_cast<u64>(dt_id))) % SLOTS;
+}
+// -------------------------------------------------------------------------------------
+void LockWaits::park(u64 slot_i, u32 epoch, std::chrono::steady_clock::time_point deadline)
+{
+   const auto now = std::chrono::steady_clock::now();
+   if (now >= deadline) {
+      return;
+   }
+   const u64 remaining_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+   struct timespec timeout = {static_cast<time_t>(remaining_ns / 1000000000), static_cast<long>(remaining_ns % 1000000000)};
+   // Returns right away if the epoch moved on since the caller read it
+   syscall(SYS_futex, reinterpret_cast<u32*>(&slots[slot_i].epoch), FUTEX_WAIT_PRIVATE, epoch, &timeout, nullptr, 0);
+}
+// -------------------------------------------------------------------------------------
+void LockWaits::wake(u64 slot_i)
+{
+   Slot& slot = slots[slot_i];
+   if (slot.waiters.load() == 0) {
+      return;
+   }
+   slot.epoch++;
+   syscall(SYS_futex, reinterpret_cast<u32*>(&slot.epoch), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+// -------------------------------------------------------------------------------------
+}  // namespace cr
+}  // namespace leanstore
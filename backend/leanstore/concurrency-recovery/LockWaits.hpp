@@ -0,0 +1,38 @@
+#pragma once
+#include "Units.hpp"
+#include "leanstore/KVInterface.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <atomic>
+#include <chrono>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace cr
+{
+// -------------------------------------------------------------------------------------
+// Lock-wait table for FLAGS_cc_lock_wait, slots keyed by (dt_id, key hash). A writer that runs into a tuple of a running
+// transaction parks on the futex of the slot of the key, the holder wakes the slots of the keys it wrote once it committed or
+// aborted. Keys that share a slot only cause spurious wakeups, the waiter checks the holder again
+class LockWaits
+{
+  public:
+   struct alignas(64) Slot {
+      std::atomic<u32> epoch = 0;  // futex word, bumped by every wakeup
+      std::atomic<u32> waiters = 0;
+   };
+   static constexpr u64 SLOTS = 4096;
+   // -------------------------------------------------------------------------------------
+   static u64 slotOf(DTID dt_id, Slice key);
+   // Parks until the epoch of the slot differs from the given one or the deadline passes
+   static void park(u64 slot_i, u32 epoch, std::chrono::steady_clock::time_point deadline);
+   // Pre: the holder no longer looks like running to the waiters
+   static void wake(u64 slot_i);
+   static Slot& slot(u64 slot_i) { return slots[slot_i]; }
+
+  private:
+   static Slot slots[SLOTS];
+};
+// -------------------------------------------------------------------------------------
+}  // namespace cr
+}  // namespace leanstore
@@ -5,6 +5,11 @@
 #include "leanstore/utils/Misc.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
 // -------------------------------------------------------------------------------------
 namespace leanstore
 {
@@ -14,6 +19,32 @@ namespace cr
 atomic<u64> Worker::Logging::global_min_gsn_flushed = 0;
 atomic<u64> Worker::Logging::global_min_commit_ts_flushed = 0;
 atomic<u64> Worker::Logging::global_sync_to_this_gsn = 0;
+std::mutex Worker::Logging::gct_mutex;
+std::condition_variable Worker::Logging::gct_cv;
+atomic<bool> Worker::Logging::gct_sleeping = false;
+atomic<u64> Worker::Logging::gct_pending_bytes = 0;
+atomic<u64> Worker::Logging::gct_batch_bytes = 0;
+// -------------------------------------------------------------------------------------
+// Both sides access gct_sleeping and gct_pending_bytes sequentially consistent: either the group committer sees the new pending
+// bytes before it sleeps or we see it sleeping, and then it is waiting by the time we get the mutex
+void Worker::Logging::signalGroupCommiter(u64 bytes)
+{
+   const u64 pending_bytes = gct_pending_bytes.fetch_add(bytes) + bytes;
+   if (gct_sleeping && pending_bytes >= gct_batch_bytes) {
+      std::unique_lock<std::mutex> guard(gct_mutex);
+      gct_cv.notify_one();
+   }
+}
+// -------------------------------------------------------------------------------------
+// Called by the group committer, same protocol as signalGroupCommiter
+void Worker::Logging::advanceGCTCursor(u64 offset)
+{
+   wal_gct_cursor.store(offset);
+   if (wal_space_waiting) {
+      std::unique_lock<std::mutex> guard(wal_space_mutex);
+      wal_space_cv.notify_one();
+   }
+}
 // -------------------------------------------------------------------------------------
 u32 Worker::Logging::walFreeSpace()
 {
@@ -41,11 +72,25 @@ void Worker::Logging::walEnsureEnoughSpace(u32 requested_size)
       if ((FLAGS_wal_buffer_size - wal_wt_cursor) < static_cast<u32>(requested_size + CR_ENTRY_SIZE)) {
          wait_untill_free_bytes += FLAGS_wal_buffer_size - wal_wt_cursor;  // we have to skip this round
       }
-      // Spin until we have enough space
+      // Our own entries are not freed by the group committer, they stay until the transaction ends
+      if (currentTXBufferedWALBytes() + wait_untill_free_bytes >= FLAGS_wal_buffer_size) {
+         spillCurrentTXEntries();
+      }
+      // Wait until we have enough space
       if (FLAGS_wal_variant == 2 && walFreeSpace() < wait_untill_free_bytes) {
          wt_to_lw.optimistic_latch.notify_all();
       }
-      while (walFreeSpace() < wait_untill_free_bytes) {
+      if (FLAGS_wal_gct_max_wait_us && walFreeSpace() < wait_untill_free_bytes) {
+         signalGroupCommiter(gct_batch_bytes);  // counts as a whole batch, only the group committer can free the buffer
+      }
+      if (walFreeSpace() < wait_untill_free_bytes) {
+         CRCounters::myCounters().wal_reserve_blocked++;
+         std::unique_lock<std::mutex> guard(wal_space_mutex);
+         wal_space_waiting = true;
+         wal_space_cv.wait(guard, [&]() { return walFreeSpace() >= wait_untill_free_bytes; });
+         wal_space_waiting = false;
+      } else {
+         CRCounters::myCounters().wal_reserve_immediate++;
       }
       if (walContiguousFreeSpace() < requested_size + CR_ENTRY_SIZE) {  // always keep place for CR entry
          WALMetaEntry& entry = *reinterpret_cast<WALMetaEntry*>(wal_buffer + wal_wt_cursor);
@@ -64,6 +109,8 @@ void Worker::Logging::walEnsureEnoughSpace(u32 requested_size)
       }
       ensure(walContiguousFreeSpace() >= requested_size);
       ensure(wal_wt_cursor + requested_size + CR_ENTRY_SIZE <= FLAGS_wal_buffer_size);
+      // The spilling above keeps the cursor from overtaking the start of the current transaction, whose entries rollbacks read
+      assert(currentTXBufferedWALBytes() + requested_size + CR_ENTRY_SIZE < FLAGS_wal_buffer_size);
    }
 }
 // -------------------------------------------------------------------------------------
@@ -78,9 +125,6 @@ WALMetaEntry& Worker::Logging::reserveWALMetaEntry()
 // -------------------------------------------------------------------------------------
 void Worker::Logging::submitWALMetaEntry()
 {
-   if(!((wal_wt_cursor >= current_tx_wal_start) || (wal_wt_cursor + sizeof(WALMetaEntry) < current_tx_wal_start))) {
-      my().active_tx.wal_larger_than_buffer = true;
-   }
    DEBUG_BLOCK()
    {
       active_mt_entry->computeCRC();
@@ -92,11 +136,22 @@ void Worker::Logging::submitWALMetaEntry()
    wt_to_lw.pushSync(current);
 }
 // -------------------------------------------------------------------------------------
-void Worker::Logging::submitDTEntry(u64 total_size)
+u64 Worker::Logging::currentTXWALBytes()
 {
-   if(!((wal_wt_cursor >= current_tx_wal_start) || (wal_wt_cursor + total_size  < current_tx_wal_start))) {
-      my().active_tx.wal_larger_than_buffer = true;
+   return wal_spill_size + currentTXBufferedWALBytes();
+}
+// -------------------------------------------------------------------------------------
+u64 Worker::Logging::currentTXBufferedWALBytes()
+{
+   if (wal_wt_cursor >= current_tx_wal_start) {
+      return wal_wt_cursor - current_tx_wal_start;
+   } else {
+      return FLAGS_wal_buffer_size - current_tx_wal_start + wal_wt_cursor;
    }
+}
+// -------------------------------------------------------------------------------------
+void Worker::Logging::submitDTEntry(u64 total_size)
+{
    DEBUG_BLOCK()
    {
       active_dt_entry->computeCRC();
@@ -130,5 +185,56 @@ void Worker::Logging::iterateOverCurrentTXEntries(std::function<void(const WALEn
    }
 }
 // -------------------------------------------------------------------------------------
+// Appends the buffered entries of the current transaction to the spill file as they are, without the carriage return
+void Worker::Logging::spillCurrentTXEntries()
+{
+   if (wal_spill_fd < 0) {
+      wal_spill_fd = open(FLAGS_wal_spill_dir.c_str(), O_TMPFILE | O_RDWR, S_IRUSR | S_IWUSR);
+      posix_check(wal_spill_fd >= 0);
+   }
+   auto spill = [&](u64 from, u64 to) {
+      for (u64 offset = from; offset < to;) {
+         const s64 ret = pwrite(wal_spill_fd, wal_buffer + offset, to - offset, wal_spill_size);
+         posix_check(ret > 0);
+         offset += ret;
+         wal_spill_size += ret;
+      }
+      CRCounters::myCounters().wal_spill_bytes += to - from;
+   };
+   if (wal_wt_cursor >= current_tx_wal_start) {
+      spill(current_tx_wal_start, wal_wt_cursor);
+   } else {
+      u64 carriage_return = current_tx_wal_start;
+      while (reinterpret_cast<WALEntry*>(wal_buffer + carriage_return)->type != WALEntry::TYPE::CARRIAGE_RETURN) {
+         carriage_return += reinterpret_cast<WALEntry*>(wal_buffer + carriage_return)->size;
+      }
+      spill(current_tx_wal_start, carriage_return);
+      spill(0, wal_wt_cursor);
+   }
+   current_tx_wal_start = wal_wt_cursor;
+}
+// -------------------------------------------------------------------------------------
+void Worker::Logging::iterateOverSpilledTXEntriesDesc(std::function<void(const WALEntry& entry)> callback)
+{
+   std::vector<u64> offsets;
+   std::vector<u8> entry(sizeof(WALEntry));
+   auto read_entry = [&](u64 offset, u64 length) {
+      entry.resize(std::max<u64>(entry.size(), length));
+      posix_check(pread(wal_spill_fd, entry.data(), length, offset) == s64(length));
+      return reinterpret_cast<const WALEntry*>(entry.data());
+   };
+   for (u64 offset = 0; offset < wal_spill_size;) {
+      const u16 size = read_entry(offset, sizeof(WALEntry))->size;
+      ensure(size > 0);
+      offsets.push_back(offset);
+      offset += size;
+   }
+   for (auto offset = offsets.rbegin(); offset != offsets.rend(); offset++) {
+      const WALEntry* current = read_entry(*offset, read_entry(*offset, sizeof(WALEntry))->size);
+      DEBUG_BLOCK() { current->checkCRC(); }
+      callback(*current);
+   }
+}
+// -------------------------------------------------------------------------------------
 }  // namespace cr
 }  // namespace leanstore
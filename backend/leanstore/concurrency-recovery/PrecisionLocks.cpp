@@ -0,0 +1,145 @@
+#include "PrecisionLocks.hpp"
+
+#include "leanstore/utils/FNVHash.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace cr
+{
+// -------------------------------------------------------------------------------------
+u64 PrecisionLocks::hash(DTID dt_id, Slice key)
+{
+   return utils::FNV::hash(key.data(), key.length()) ^ utils::FNV::hash(static_cast<u64>(dt_id));
+}
+// -------------------------------------------------------------------------------------
+void PrecisionLocks::reset(bool track)
+{
+   tracking = track;
+   point_reads_sorted = false;
+   point_reads.clear();
+   range_reads.clear();
+   writes->keys.clear();
+   writes->hashes.clear();
+}
+// -------------------------------------------------------------------------------------
+void PrecisionLocks::readRange(DTID dt_id, std::optional<Slice> lower, std::optional<Slice> upper)
+{
+   if (!tracking) {
+      return;
+   }
+   Range& range = range_reads.emplace_back();
+   range.dt_id = dt_id;
+   if (lower) {
+      range.lower.emplace(reinterpret_cast<const char*>(lower->data()), lower->length());
+   }
+   if (upper) {
+      range.upper.emplace(reinterpret_cast<const char*>(upper->data()), upper->length());
+   }
+}
+// -------------------------------------------------------------------------------------
+void PrecisionLocks::write(DTID dt_id, Slice key)
+{
+   if (!tracking) {
+      return;
+   }
+   const u16 key_length = key.length();
+   writes->keys.append(reinterpret_cast<const char*>(&dt_id), sizeof(DTID));
+   writes->keys.append(reinterpret_cast<const char*>(&key_length), sizeof(u16));
+   writes->keys.append(reinterpret_cast<const char*>(key.data()), key_length);
+   writes->hashes.push_back(hash(dt_id, key));
+}
+// -------------------------------------------------------------------------------------
+PrecisionLocks::WriteSet& PrecisionLocks::publish()
+{
+   WriteSet& write_set = *writes;
+   {
+      std::unique_lock guard(published_mutex);
+      published.push_back(std::move(writes));
+   }
+   writes = std::make_unique<WriteSet>();
+   return write_set;
+}
+// -------------------------------------------------------------------------------------
+// Keys of equal hashes count as the same, a collision only costs an unnecessary abort
+bool PrecisionLocks::conflicts(const WriteSet& write_set)
+{
+   for (const u64 key_hash : write_set.hashes) {
+      if (std::binary_search(point_reads.begin(), point_reads.end(), key_hash)) {
+         return true;
+      }
+   }
+   if (range_reads.empty()) {
+      return false;
+   }
+   for (u64 offset = 0; offset < write_set.keys.size();) {
+      DTID dt_id;
+      u16 key_length;
+      std::memcpy(&dt_id, write_set.keys.data() + offset, sizeof(DTID));
+      offset += sizeof(DTID);
+      std::memcpy(&key_length, write_set.keys.data() + offset, sizeof(u16));
+      offset += sizeof(u16);
+      // Compares its bytes unsigned, like the trees
+      const std::string_view key(write_set.keys.data() + offset, key_length);
+      offset += key_length;
+      for (const Range& range : range_reads) {
+         if (range.dt_id == dt_id && (!range.lower || key >= *range.lower) && (!range.upper || key <= *range.upper)) {
+            return true;
+         }
+      }
+   }
+   return false;
+}
+// -------------------------------------------------------------------------------------
+// The transactions of a worker commit one after the other, so its write sets are ordered by their commit timestamps
+bool PrecisionLocks::validate(PrecisionLocks& other, TXID start_ts, TXID commit_ts)
+{
+   if (point_reads.empty() && range_reads.empty()) {
+      return true;
+   }
+   if (!point_reads_sorted) {
+      std::sort(point_reads.begin(), point_reads.end());
+      point_reads.erase(std::unique(point_reads.begin(), point_reads.end()), point_reads.end());
+      point_reads_sorted = true;
+   }
+   std::shared_lock guard(other.published_mutex);
+   for (auto write_set = other.published.rbegin(); write_set != other.published.rend(); write_set++) {
+      TXID its_commit_ts;
+      while ((its_commit_ts = (*write_set)->commit_ts.load(std::memory_order_acquire)) == WriteSet::PENDING) {
+      }
+      if (its_commit_ts >= commit_ts) {
+         continue;  // also ABORTED
+      }
+      if (its_commit_ts < start_ts) {
+         break;
+      }
+      if (conflicts(**write_set)) {
+         return false;
+      }
+   }
+   return true;
+}
+// -------------------------------------------------------------------------------------
+void PrecisionLocks::retire(TXID oldest_start_ts)
+{
+   auto retirable = [&](const WriteSet& write_set) {
+      const TXID its_commit_ts = write_set.commit_ts.load();
+      return its_commit_ts == WriteSet::ABORTED || its_commit_ts < oldest_start_ts;
+   };
+   // Only this worker changes the list, it can look at it without the latch
+   if (published.empty() || !retirable(*published.front())) {
+      return;
+   }
+   std::unique_lock guard(published_mutex);
+   while (!published.empty() && retirable(*published.front())) {
+      published.pop_front();
+   }
+}
+// -------------------------------------------------------------------------------------
+}  // namespace cr
+}  // namespace leanstore
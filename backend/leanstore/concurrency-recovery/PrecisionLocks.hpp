@@ -0,0 +1,75 @@
+#pragma once
+#include "Units.hpp"
+#include "leanstore/KVInterface.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace cr
+{
+// -------------------------------------------------------------------------------------
+// SERIALIZABLE on top of snapshot isolation. A serializable transaction that may write keeps the keys and key ranges it read,
+// at commit they are validated against the keys written by the serializable transactions that committed since it started
+// (precision locking). The validated transactions are equivalent to running one after the other in the order of their commit
+// timestamps, so every snapshot is the state after a prefix of them: read-only transactions need neither tracking nor
+// validation. Writes of transactions below SERIALIZABLE are not tracked, they are not serialized with the others
+class PrecisionLocks
+{
+  public:
+   struct WriteSet {
+      static constexpr TXID PENDING = 0;                                    // published, no commit timestamp yet
+      static constexpr TXID ABORTED = std::numeric_limits<TXID>::max();  // failed its validation
+      std::atomic<TXID> commit_ts = PENDING;
+      std::string keys;  // dt_id | key length | key
+      std::vector<u64> hashes;
+   };
+   // -------------------------------------------------------------------------------------
+   static u64 hash(DTID dt_id, Slice key);
+   // At the start of every transaction
+   void reset(bool track);
+   inline void read(DTID dt_id, Slice key)
+   {
+      if (tracking) {
+         point_reads.push_back(hash(dt_id, key));
+      }
+   }
+   // Both bounds are inclusive, nullopt is unbounded
+   void readRange(DTID dt_id, std::optional<Slice> lower, std::optional<Slice> upper);
+   void write(DTID dt_id, Slice key);
+   // Makes the written keys visible to the validations of the others, their commit timestamp is PENDING.
+   // Pre: called before the commit timestamp is drawn, so that every transaction with a later one finds them
+   WriteSet& publish();
+   // Whether none of the write sets of other with a commit timestamp in [start_ts, commit_ts) touches what this transaction read.
+   // Waits for write sets that are still PENDING
+   bool validate(PrecisionLocks& other, TXID start_ts, TXID commit_ts);
+   // Drops the published write sets that no running transaction can validate against anymore
+   void retire(TXID oldest_start_ts);
+
+  private:
+   struct Range {
+      DTID dt_id;
+      std::optional<std::string> lower, upper;
+   };
+   bool tracking = false;
+   bool point_reads_sorted = false;
+   std::vector<u64> point_reads;
+   std::vector<Range> range_reads;
+   std::unique_ptr<WriteSet> writes = std::make_unique<WriteSet>();
+   // -------------------------------------------------------------------------------------
+   std::shared_mutex published_mutex;
+   std::deque<std::unique_ptr<WriteSet>> published;  // oldest first
+   // -------------------------------------------------------------------------------------
+   bool conflicts(const WriteSet& write_set);
+};
+// -------------------------------------------------------------------------------------
+}  // namespace cr
+}  // namespace leanstore
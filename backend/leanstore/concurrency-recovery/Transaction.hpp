@@ -4,6 +4,7 @@
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
 #include <chrono>
+#include <functional>
 // -------------------------------------------------------------------------------------
 namespace leanstore
 {
@@ -42,7 +43,9 @@ struct Transaction {
    bool safe_snapshot = false;
    bool is_read_only = false;
    bool has_wrote = false;
-   bool wal_larger_than_buffer = false;
+   // Set by commitTXAsync. The group committer calls it with true once the transaction is COMMITTED, a rollback with false
+   using CommitCallback = std::function<void(bool committed)>;
+   CommitCallback commit_callback;
    // -------------------------------------------------------------------------------------
    struct {
       std::chrono::high_resolution_clock::time_point start, precommit, commit;
@@ -56,6 +59,7 @@ struct Transaction {
    bool isDurable() { return is_durable; }
    bool atLeastSI() { return current_tx_isolation_level >= TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION; }
    bool isSI() { return current_tx_isolation_level == TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION; }
+   bool isSerializable() { return current_tx_isolation_level == TX_ISOLATION_LEVEL::SERIALIZABLE; }
    bool isReadCommitted() { return current_tx_isolation_level == TX_ISOLATION_LEVEL::READ_COMMITTED; }
    bool isReadUncommitted() { return current_tx_isolation_level == TX_ISOLATION_LEVEL::READ_UNCOMMITTED; }
    bool canUseSingleVersion() { return can_use_single_version_mode; }
@@ -0,0 +1,64 @@
+#include "WALCompression.hpp"
+
+#include "Exceptions.hpp"
+#include "leanstore/utils/Misc.hpp"
+// -------------------------------------------------------------------------------------
+#include "lz4.h"
+// -------------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstring>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace cr
+{
+// -------------------------------------------------------------------------------------
+u64 WALCompressedBlock::maxBlockSize(u64 wal_size)
+{
+   return utils::upAlign(sizeof(WALCompressedBlock) + std::max<u64>(LZ4_compressBound(wal_size), wal_size));
+}
+// -------------------------------------------------------------------------------------
+u64 WALCompressedBlock::blockSize() const
+{
+   return utils::upAlign(sizeof(WALCompressedBlock) + stored_size);
+}
+// -------------------------------------------------------------------------------------
+u64 WALCompressedBlock::write(u8* dest, WORKERID worker_id, const u8* wal, u64 wal_size, u64 wal_offset)
+{
+   auto& block = *reinterpret_cast<WALCompressedBlock*>(dest);
+   block.magic = MAGIC;
+   block.worker_id = worker_id;
+   block.wal_size = wal_size;
+   block.wal_offset = wal_offset;
+   const int compressed_size = LZ4_compress_default(reinterpret_cast<const char*>(wal), reinterpret_cast<char*>(block.payload), wal_size,
+                                                    LZ4_compressBound(wal_size));
+   ensure(compressed_size > 0);
+   block.is_compressed = u64(compressed_size) < wal_size;
+   if (block.is_compressed) {
+      block.stored_size = compressed_size;
+   } else {
+      std::memcpy(block.payload, wal, wal_size);
+      block.stored_size = wal_size;
+   }
+   // The padding goes to disk, do not leak whatever the buffer held before
+   const u64 block_size = block.blockSize();
+   std::memset(dest + sizeof(WALCompressedBlock) + block.stored_size, 0, block_size - sizeof(WALCompressedBlock) - block.stored_size);
+   return block_size;
+}
+// -------------------------------------------------------------------------------------
+u64 WALCompressedBlock::read(u8* dest, u64 dest_capacity) const
+{
+   ensure(magic == MAGIC);
+   ensure(wal_size <= dest_capacity);
+   if (!is_compressed) {
+      std::memcpy(dest, payload, wal_size);
+      return wal_size;
+   }
+   const int decompressed_size =
+       LZ4_decompress_safe(reinterpret_cast<const char*>(payload), reinterpret_cast<char*>(dest), stored_size, dest_capacity);
+   ensure(decompressed_size >= 0 && u64(decompressed_size) == wal_size);
+   return wal_size;
+}
+// -------------------------------------------------------------------------------------
+}  // namespace cr
+}  // namespace leanstore
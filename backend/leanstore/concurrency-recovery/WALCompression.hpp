@@ -0,0 +1,31 @@
+#pragma once
+#include "Units.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace cr
+{
+// -------------------------------------------------------------------------------------
+// With FLAGS_wal_compression, the group committer writes the WAL of a worker as LZ4 blocks instead of the raw buffer, one per
+// contiguous piece of at most 1 MiB. Blocks are padded to 512 bytes for direct IO and start with this header
+struct WALCompressedBlock {
+   static constexpr u32 MAGIC = 0x5A4C4157;  // "WALZ"
+   u32 magic;
+   WORKERID worker_id;
+   bool is_compressed;  // false if LZ4 did not shrink the piece, the payload is then the raw WAL
+   u32 stored_size;     // of the payload
+   u32 wal_size;
+   u64 wal_offset;  // of the piece in the WAL buffer of its worker
+   u8 payload[];
+   // -------------------------------------------------------------------------------------
+   static u64 maxBlockSize(u64 wal_size);
+   u64 blockSize() const;
+   // Fills dest, which must hold maxBlockSize(wal_size) bytes, and returns the block size
+   static u64 write(u8* dest, WORKERID worker_id, const u8* wal, u64 wal_size, u64 wal_offset);
+   // For the recovery: checks the header and restores the WAL of the block into dest, returns its size
+   u64 read(u8* dest, u64 dest_capacity) const;
+};
+// -------------------------------------------------------------------------------------
+}  // namespace cr
+}  // namespace leanstore
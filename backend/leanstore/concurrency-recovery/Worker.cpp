@@ -6,6 +6,7 @@
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
 #include <stdio.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <chrono>
@@ -13,6 +14,7 @@
 #include <fstream>
 #include <mutex>
 #include <sstream>
+#include <stdexcept>
 // -------------------------------------------------------------------------------------
 namespace leanstore
 {
@@ -52,23 +54,31 @@ Worker::Worker(u64 worker_id, Worker** all_workers, u64 workers_count, HistoryTr
 Worker::~Worker()
 {
    delete[] cc.commit_tree.array;
+   if (logging.wal_spill_fd >= 0) {
+      close(logging.wal_spill_fd);
+   }
 }
 // -------------------------------------------------------------------------------------
 void Worker::startTX(TX_MODE next_tx_type, TX_ISOLATION_LEVEL next_tx_isolation_level, bool read_only)
 {
    utils::Timer timer(CRCounters::myCounters().cc_ms_start_tx);
-   Transaction prev_tx = active_tx;
+   failCommitCallback();  // of a transaction that neither committed nor aborted
+   // Only what this transaction needs of the previous one, a copy of it would copy the callback too
+   const Transaction::STATE prev_tx_state = active_tx.state;
+   const TX_ISOLATION_LEVEL prev_tx_isolation_level = active_tx.current_tx_isolation_level;
+   const bool prev_tx_wrote = active_tx.hasWrote();
+   const TXID prev_tx_start_ts = active_tx.startTS();
    active_tx.stats.start = std::chrono::high_resolution_clock::now();
    if (FLAGS_wal) {
-      active_tx.wal_larger_than_buffer = false;
       logging.current_tx_wal_start = logging.wal_wt_cursor;
+      logging.wal_spill_size = 0;
       if (!read_only) {
          WALMetaEntry& entry = logging.reserveWALMetaEntry();
          entry.type = WALEntry::TYPE::TX_START;
          logging.submitWALMetaEntry();
          DEBUG_BLOCK() { entry.checkCRC(); }
       }
-      assert(prev_tx.state != Transaction::STATE::STARTED);
+      assert(prev_tx_state != Transaction::STATE::STARTED);
       // -------------------------------------------------------------------------------------
       const LID sync_point = Worker::Logging::global_sync_to_this_gsn.load();
       if (sync_point > logging.getCurrentGSN()) {
@@ -89,18 +99,20 @@ void Worker::startTX(TX_MODE next_tx_type, TX_ISOLATION_LEVEL next_tx_isolation_
       active_tx.current_tx_isolation_level = next_tx_isolation_level;
       active_tx.is_read_only = read_only;
       active_tx.is_durable = FLAGS_wal;  // TODO:
+      // Read-only transactions see a prefix of the serializable ones, nothing to validate
+      cc.precision_locks.reset(next_tx_isolation_level == TX_ISOLATION_LEVEL::SERIALIZABLE && !read_only);
       // -------------------------------------------------------------------------------------
       // Draw TXID from global counter and publish it with the TX type (i.e., OLAP or OLTP)
       // We have to acquire a transaction id and use it for locking in ANY isolation level
       if (next_tx_isolation_level >= TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION) {  // implies multi-statement
-         if (prev_tx.isReadCommitted() || prev_tx.isReadUncommitted()) {
+         if (prev_tx_isolation_level < TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION) {
             cc.switchToSnapshotIsolationMode();
          }
          // -------------------------------------------------------------------------------------
          {
            utils::Timer timer(CRCounters::myCounters().cc_ms_snapshotting);
            global_workers_current_snapshot[worker_id].store(active_tx.start_ts | LATCH_BIT, std::memory_order_release);
-           active_tx.start_ts = ConcurrencyControl::global_clock.fetch_add(1);
+           active_tx.start_ts = cc.drawStartTimestamp(prev_tx_wrote, prev_tx_start_ts);
            if (FLAGS_olap_mode) {
              global_workers_current_snapshot[worker_id].store(active_tx.start_ts | ((active_tx.isOLAP()) ? OLAP_BIT : 0), std::memory_order_release);
            } else {
@@ -110,7 +122,7 @@ void Worker::startTX(TX_MODE next_tx_type, TX_ISOLATION_LEVEL next_tx_isolation_
          cc.commit_tree.cleanIfNecessary();
          cc.local_global_all_lwm_cache = global_all_lwm.load();
       } else {
-        if (prev_tx.atLeastSI()) {
+        if (prev_tx_isolation_level >= TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION) {
           cc.switchToReadCommittedMode();
         }
         cc.commit_tree.cleanIfNecessary();
@@ -118,13 +130,11 @@ void Worker::startTX(TX_MODE next_tx_type, TX_ISOLATION_LEVEL next_tx_isolation_
    }
 }
 // -------------------------------------------------------------------------------------
-void Worker::commitTX()
+bool Worker::commitTX()
 {
   if (activeTX().isDurable()) {
     {
       utils::Timer timer(CRCounters::myCounters().cc_ms_commit_tx);
-      command_id = 0;  // Reset command_id only on commit and never on abort
-      // -------------------------------------------------------------------------------------
       assert(active_tx.state == Transaction::STATE::STARTED);
       // -------------------------------------------------------------------------------------
       if (FLAGS_wal_tuple_rfa) {
@@ -138,10 +148,21 @@ void Worker::commitTX()
       }
       // -------------------------------------------------------------------------------------
       if (activeTX().hasWrote()) {
-        TXID commit_ts = cc.commit_tree.commit(active_tx.startTS());
+        TXID commit_ts;
+        if (activeTX().isSerializable()) {
+          commit_ts = cc.commitSerializable(active_tx.startTS());
+          if (commit_ts == 0) {
+            rollbackTX();
+            return false;
+          }
+        } else {
+          commit_ts = cc.commit_tree.commit(active_tx.startTS());
+        }
         cc.local_latest_write_tx.store(commit_ts, std::memory_order_release);
         active_tx.commit_ts = commit_ts;
       }
+      command_id = 0;  // Reset command_id only on commit and never on abort
+      cc.releaseLocks();
       // -------------------------------------------------------------------------------------
       active_tx.max_observed_gsn = logging.wt_gsn_clock;
       active_tx.state = Transaction::STATE::READY_TO_COMMIT;
@@ -153,15 +174,19 @@ void Worker::commitTX()
       if (FLAGS_wal_variant == 2) {
         logging.wt_to_lw.optimistic_latch.notify_all();
       }
+      if (FLAGS_wal_gct_max_wait_us) {
+        Worker::Logging::signalGroupCommiter(logging.currentTXWALBytes());
+      }
       // -------------------------------------------------------------------------------------
       active_tx.stats.precommit = std::chrono::high_resolution_clock::now();
       std::unique_lock<std::mutex> g(logging.precommitted_queue_mutex);
       if (logging.remote_flush_dependency) {  // RFA
-        logging.precommitted_queue.push_back(active_tx);
+        logging.precommitted_queue.push_back(std::move(active_tx));
       } else {
         CRCounters::myCounters().rfa_committed_tx++;
-        logging.precommitted_queue_rfa.push_back(active_tx);
+        logging.precommitted_queue_rfa.push_back(std::move(active_tx));
       }
+      active_tx.commit_callback = nullptr;
     }
     // Only committing snapshot/ changing between SI and lower modes
     if (activeTX().atLeastSI()) {
@@ -170,33 +195,79 @@ void Worker::commitTX()
     // All isolation level generate garbage
     cc.garbageCollection();
   }
+  return true;
+}
+// -------------------------------------------------------------------------------------
+void Worker::commitTXAsync(Transaction::CommitCallback callback)
+{
+   if (!activeTX().isDurable()) {
+      callback(commitTX());
+      return;
+   }
+   active_tx.commit_callback = std::move(callback);
+   commitTX();
+}
+// -------------------------------------------------------------------------------------
+std::future<void> Worker::commitTXAsync()
+{
+   auto promise = std::make_shared<std::promise<void>>();
+   std::future<void> future = promise->get_future();
+   commitTXAsync([promise](bool committed) {
+      if (committed) {
+         promise->set_value();
+      } else {
+         promise->set_exception(std::make_exception_ptr(std::runtime_error("transaction aborted")));
+      }
+   });
+   return future;
 }
 // -------------------------------------------------------------------------------------
 void Worker::abortTX()
+{
+   rollbackTX();
+   jumpmu::jump();
+}
+// -------------------------------------------------------------------------------------
+void Worker::rollbackTX()
 {
    utils::Timer timer(CRCounters::myCounters().cc_ms_abort_tx);
    ensure(FLAGS_wal);
-   ensure(!active_tx.wal_larger_than_buffer);
    ensure(active_tx.state == Transaction::STATE::STARTED);
    const u64 tx_id = active_tx.startTS();
-   std::vector<const WALEntry*> entries;
-   logging.iterateOverCurrentTXEntries([&](const WALEntry& entry) {
+   auto undo = [&](const WALEntry& entry) {
       if (entry.type == WALEntry::TYPE::DT_SPECIFIC) {
-         entries.push_back(&entry);
+         const auto& dt_entry = reinterpret_cast<const WALDTEntry&>(entry);
+         leanstore::storage::DTRegistry::global_dt_registry.undo(dt_entry.dt_id, dt_entry.payload, tx_id);
       }
-   });
-   std::for_each(entries.rbegin(), entries.rend(), [&](const WALEntry* entry) {
-      const auto& dt_entry = *reinterpret_cast<const WALDTEntry*>(entry);
-      leanstore::storage::DTRegistry::global_dt_registry.undo(dt_entry.dt_id, dt_entry.payload, tx_id);
-   });
+   };
+   // The buffered entries are newer than the spilled ones
+   std::vector<const WALEntry*> entries;
+   logging.iterateOverCurrentTXEntries([&](const WALEntry& entry) { entries.push_back(&entry); });
+   std::for_each(entries.rbegin(), entries.rend(), [&](const WALEntry* entry) { undo(*entry); });
+   if (logging.wal_spill_size) {
+      logging.iterateOverSpilledTXEntriesDesc(undo);
+   }
    // -------------------------------------------------------------------------------------
-   cc.history_tree.purgeVersions(worker_id, active_tx.startTS(), active_tx.startTS(), [&](const TXID, const DTID, const u8*, u64, const bool) {});
+   {
+      std::unique_lock guard(cc.gc_mutex);
+      cc.history_tree.purgeVersions(worker_id, active_tx.startTS(), active_tx.startTS(), [&](const TXID, const DTID, const u8*, u64, const bool) {});
+   }
+   cc.releaseLocks();
    // -------------------------------------------------------------------------------------
    WALMetaEntry& entry = logging.reserveWALMetaEntry();
    entry.type = WALEntry::TYPE::TX_ABORT;
    logging.submitWALMetaEntry();
    active_tx.state = Transaction::STATE::ABORTED;
-   jumpmu::jump();
+   failCommitCallback();
+}
+// -------------------------------------------------------------------------------------
+void Worker::failCommitCallback()
+{
+   if (active_tx.commit_callback) {
+      Transaction::CommitCallback callback = std::move(active_tx.commit_callback);
+      active_tx.commit_callback = nullptr;
+      callback(false);
+   }
 }
 // -------------------------------------------------------------------------------------
 void Worker::shutdown()
@@ -1,5 +1,7 @@
 #pragma once
 #include "HistoryTreeInterface.hpp"
+#include "LockWaits.hpp"
+#include "PrecisionLocks.hpp"
 #include "Transaction.hpp"
 #include "WALEntry.hpp"
 #include "leanstore/profiling/counters/CRCounters.hpp"
@@ -8,7 +10,9 @@
 #include "leanstore/utils/OptimisticSpinStruct.hpp"
 // -------------------------------------------------------------------------------------
 #include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <future>
 #include <list>
 #include <map>
 #include <memory>
@@ -57,6 +61,14 @@ struct Worker {
       static atomic<u64> global_sync_to_this_gsn;  // Artifically increment the workers GSN to this point at the next round to prevent GSN from
                                                    // skewing and undermining RFA
       static atomic<u64> global_min_commit_ts_flushed;
+      // Adaptive group commit (FLAGS_wal_gct_max_wait_us): the group committer sleeps on gct_cv until gct_pending_bytes reach
+      // gct_batch_bytes or its deadline passes. Committing workers only take gct_mutex when it sleeps
+      static std::mutex gct_mutex;
+      static std::condition_variable gct_cv;
+      static atomic<bool> gct_sleeping;
+      static atomic<u64> gct_pending_bytes;  // WAL of the transactions that pre-committed since it last woke up
+      static atomic<u64> gct_batch_bytes;
+      static void signalGroupCommiter(u64 bytes);
       // -------------------------------------------------------------------------------------
       s64 WORKER_WAL_SIZE = 0;
       WALMetaEntry* active_mt_entry;
@@ -89,12 +101,27 @@ struct Worker {
             }
          }
       }
+      // Pre: precommitted_queue_mutex is held. Moves the completions of the first count transactions of queue to callbacks, the
+      // group committer calls them after it released the mutex and published signaled_commit_ts
+      static void takeCommitCallbacks(std::vector<Transaction>& queue, u64 count, std::vector<Transaction::CommitCallback>& callbacks)
+      {
+         for (u64 tx_i = 0; tx_i < count; tx_i++) {
+            if (queue[tx_i].commit_callback) {
+               callbacks.push_back(std::move(queue[tx_i].commit_callback));
+            }
+         }
+      }
       // -------------------------------------------------------------------------------------
       // Accessible only by the group commit thread
       u64 wal_wt_cursor = 0;
       u64 wal_buffer_round = 0, wal_next_to_clean = 0;
       // -------------------------------------------------------------------------------------
       atomic<u64> wal_gct_cursor = 0;  // GCT->W
+      // A worker that runs out of WAL buffer sleeps on wal_space_cv until the group committer advanced wal_gct_cursor
+      std::mutex wal_space_mutex;
+      std::condition_variable wal_space_cv;
+      atomic<bool> wal_space_waiting = false;
+      void advanceGCTCursor(u64 offset);
       alignas(512) u8* wal_buffer;     // W->GCT
       LID wal_lsn_counter = 0;
       LID wt_gsn_clock;
@@ -159,12 +186,21 @@ struct Worker {
       u8* walReserve(u32 requested_size);
       // -------------------------------------------------------------------------------------
       // Iterate over current TX entries
-      u64 current_tx_wal_start;
+      u64 current_tx_wal_start;  // oldest entry of the current transaction that is still in the buffer
       void iterateOverCurrentTXEntries(std::function<void(const WALEntry& entry)> callback);
+      // A transaction that outgrows the buffer moves its entries to an unlinked file in FLAGS_wal_spill_dir before it would
+      // overwrite them, so that it can still be undone. The file belongs to the worker and is reused by its next transactions
+      s32 wal_spill_fd = -1;
+      u64 wal_spill_size = 0;  // of the current transaction
+      void spillCurrentTXEntries();
+      // Newest first, the entries are only valid during the callback
+      void iterateOverSpilledTXEntriesDesc(std::function<void(const WALEntry& entry)> callback);
       // -------------------------------------------------------------------------------------
       // Without Payload, by submit no need to update clock (gsn)
       WALMetaEntry& reserveWALMetaEntry();
       void submitWALMetaEntry();
+      u64 currentTXWALBytes();  // including the spilled ones
+      u64 currentTXBufferedWALBytes();
       inline LID getCurrentGSN() { return wt_gsn_clock; }
       inline void setCurrentGSN(LID gsn) { wt_gsn_clock = gsn; }
       // -------------------------------------------------------------------------------------
@@ -174,12 +210,14 @@ struct Worker {
    // Concurrency Control
    // LWM: start timestamp of the transaction that has its effect visible by all in its class
    struct ConcurrencyControl {
-      static atomic<u64> global_clock;
+      alignas(64) static atomic<u64> global_clock;
       // -------------------------------------------------------------------------------------
       atomic<TXID> local_lwm_latch = 0;
-      atomic<TXID> oltp_lwm_receiver;
-      atomic<TXID> all_lwm_receiver;
+      atomic<TXID> oltp_lwm_receiver = 0;
+      atomic<TXID> all_lwm_receiver = 0;
       atomic<TXID> local_latest_write_tx = 0, local_latest_lwm_for_tx = 0;
+      // Oldest snapshots the receivers were computed for, protected by global_mutex
+      TXID lwm_for_oldest_all_start_ts = std::numeric_limits<TXID>::max(), lwm_for_oldest_oltp_start_ts = std::numeric_limits<TXID>::max();
       TXID local_all_lwm, local_oltp_lwm;
       TXID local_global_all_lwm_cache = 0;
       unique_ptr<TXID[]> local_snapshot_cache;  // = Readview
@@ -217,9 +255,49 @@ struct Worker {
       // -------------------------------------------------------------------------------------
       // Clean up state
       u64 cleaned_untill_oltp_lwm = 0;
+      // With FLAGS_cc_gc_threads, the worker only publishes the LWMs up to which its versions can go, a GC thread purges them.
+      // gc_mutex serializes the purges of the GC thread and of rollbackTX, both move the leftmost session of the history tree
+      atomic<TXID> gc_all_lwm_target = 0, gc_oltp_lwm_target = 0;
+      std::mutex gc_mutex;
+      // -------------------------------------------------------------------------------------
+      // Read and write sets of the running transaction for SERIALIZABLE, and the write sets it published
+      PrecisionLocks precision_locks;
+      // -------------------------------------------------------------------------------------
+      // Write-write conflicts with FLAGS_cc_lock_wait: the writer that hits a tuple of a running transaction notes it, the
+      // operation returns ABORT_TX and waitForLockHolder decides whether it waits and retries instead of aborting
+      atomic<TXID> lock_holder_tx = 0;  // start timestamp of the running transaction once it wrote, 0 otherwise
+      std::vector<u64> locked_slots;    // LockWaits slots of the keys it wrote
+      struct {
+         bool pending = false;
+         WORKERID worker_id;
+         TXID tx_ts;
+         u64 slot_i;
+      } lock_conflict;
       // -------------------------------------------------------------------------------------
       void garbageCollection();
+      // Purges the versions of worker_id below the given LWMs. The todo callbacks read the LWMs of the calling worker
+      void collectGarbage(WORKERID worker_id, TXID all_lwm, TXID oltp_lwm);
+      // Commit of a serializable transaction that wrote: validates it and draws its commit timestamp, 0 if it has to abort
+      TXID commitSerializable(TXID start_ts);
+      // Every key a transaction writes goes through here before its tuple changes
+      inline void recordWrite(DTID dt_id, Slice key)
+      {
+         precision_locks.write(dt_id, key);
+         if (FLAGS_cc_lock_wait) {
+            if (lock_holder_tx.load(std::memory_order_relaxed) != my().active_tx.startTS()) {
+               lock_holder_tx.store(my().active_tx.startTS());
+            }
+            locked_slots.push_back(LockWaits::slotOf(dt_id, key));
+         }
+      }
+      void noteLockConflict(DTID dt_id, Slice key, WORKERID its_worker_id, TXID its_tx_ts);
+      // Whether the noted conflict is gone after waiting for its holder, so the operation can be retried
+      bool waitForLockHolder();
+      // At the end of the transaction, once its outcome is visible
+      void releaseLocks();
       void refreshGlobalState();
+      void updateGlobalState();  // Pre: global_mutex is held
+      TXID drawStartTimestamp(bool prev_tx_wrote, TXID prev_tx_start_ts);
       void switchToReadCommittedMode();
       void switchToSnapshotIsolationMode();
       // -------------------------------------------------------------------------------------
@@ -273,10 +351,23 @@ struct Worker {
    void startTX(TX_MODE next_tx_type = TX_MODE::OLTP,
                 TX_ISOLATION_LEVEL next_tx_isolation_level = TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION,
                 bool read_only = false);
-   void commitTX();
+   // Returns false if the transaction was rolled back instead, because it failed its serializable validation. Unlike abortTX it
+   // does not jump, the caller continues with the next transaction
+   bool commitTX();
+   // Pipelined commit: returns right after the pre-commit like commitTX, so the worker can start the next transaction while this
+   // one waits for the group commit. callback runs on the group commit thread once the transaction is durable, keep it short.
+   // Transactions that are not durable complete immediately. A transaction that aborts instead calls it with false on the worker,
+   // the future then holds an exception
+   void commitTXAsync(Transaction::CommitCallback callback);
+   std::future<void> commitTXAsync();
+   // Rolls the transaction back and jumps to the enclosing jumpmuTry
    void abortTX();
    void shutdown();
    inline WORKERID workerID() { return worker_id; }
+
+  private:
+   void rollbackTX();
+   void failCommitCallback();
 };
 // -------------------------------------------------------------------------------------
 // Shortcuts
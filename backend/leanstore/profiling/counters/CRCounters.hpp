@@ -4,6 +4,7 @@
 #include <tbb/enumerable_thread_specific.h>
 
 // -------------------------------------------------------------------------------------
+#include <algorithm>
 #include <atomic>
 // -------------------------------------------------------------------------------------
 namespace leanstore
@@ -13,12 +14,14 @@ struct CRCounters {
    atomic<u64> written_log_bytes = 0;
    atomic<u64> wal_reserve_blocked = 0;
    atomic<u64> wal_reserve_immediate = 0;
+   atomic<u64> wal_spill_bytes = 0;
    // -------------------------------------------------------------------------------------
    atomic<u64> gct_total_ms = 0;
    atomic<u64> gct_phase_1_ms = 0;
    atomic<u64> gct_phase_2_ms = 0;
    atomic<u64> gct_write_ms = 0;
    atomic<u64> gct_write_bytes = 0;
+   atomic<u64> gct_write_bytes_uncompressed = 0;  // WAL behind gct_write_bytes, more than it with FLAGS_wal_compression
    // -------------------------------------------------------------------------------------
    atomic<u64> gct_rounds = 0;
    atomic<u64> gct_committed_tx = 0;
@@ -27,7 +30,15 @@ struct CRCounters {
    atomic<u64> cc_prepare_igc = 0;
    atomic<u64> cc_cross_workers_visibility_check = 0;
    atomic<u64> cc_versions_space_removed = {0};
+   atomic<u64> cc_versions_spilled = 0;  // by the history log to the history tree
    atomic<u64> cc_snapshot_restart = 0;
+   atomic<u64> cc_gc_batches = 0;
+   atomic<u64> cc_gc_lag_ts = 0;  // GC threads: timestamps between the LWM of the worker they lag behind most and its purged range
+   atomic<u64> cc_ser_validation_aborts = 0;
+   atomic<u64> cc_lock_conflicts = 0;      // write-write conflicts on tuples of updateSameSizeInPlace and remove
+   atomic<u64> cc_lock_waits = 0;          // of them waited for, FLAGS_cc_lock_wait
+   atomic<u64> cc_lock_wait_dies = 0;      // not waited for, younger than the holder
+   atomic<u64> cc_lock_wait_timeouts = 0;  // waited for FLAGS_cc_lock_wait_us in vain
    // -------------------------------------------------------------------------------------
    // Time
    atomic<u64> cc_ms_snapshotting = 0; // Everything related to commit log
@@ -36,6 +47,8 @@ struct CRCounters {
    atomic<u64> cc_ms_gc_history_tree = 0;
    atomic<u64> cc_ms_gc_cm = 0;
    atomic<u64> cc_ms_committing = 0;
+   atomic<u64> cc_ms_ser_validation = 0;
+   atomic<u64> cc_ms_lock_wait = 0;
    atomic<u64> cc_ms_history_tree_insert = 0;
    atomic<u64> cc_ms_history_tree_retrieve = 0;
    atomic<u64> cc_ms_refresh_global_state = 0;
@@ -59,6 +72,29 @@ struct CRCounters {
    atomic<u64> cc_rfa_ms_commit_latency[latency_tx_capacity] = {0};
    atomic<u64> cc_rfa_latency_cursor = {0};
    // -------------------------------------------------------------------------------------
+   // Histograms of the group commit, bucket i counts the values in [2^i, 2^(i+1))
+   static constexpr u64 histogram_buckets = 48;
+   atomic<u64> gct_round_bytes[histogram_buckets] = {0};
+   atomic<u64> gct_commit_latency_us[histogram_buckets] = {0};  // from pre-commit to commit
+   atomic<u64> gct_batch_bytes = 0;                             // current threshold of the adaptive group commit
+   static u64 histogramBucket(u64 value) { return value ? std::min<u64>(63 - __builtin_clzll(value), histogram_buckets - 1) : 0; }
+   // Upper bound of the bucket that holds the percentile, 0 for an empty histogram
+   static u64 histogramPercentile(const u64* histogram, double percentile)
+   {
+      u64 total = 0;
+      for (u64 b_i = 0; b_i < histogram_buckets; b_i++) {
+         total += histogram[b_i];
+      }
+      u64 seen = 0;
+      for (u64 b_i = 0; b_i < histogram_buckets; b_i++) {
+         seen += histogram[b_i];
+         if (seen && seen >= total * percentile) {
+            return u64(2) << b_i;
+         }
+      }
+      return 0;
+   }
+   // -------------------------------------------------------------------------------------
    CRCounters() {}
    // -------------------------------------------------------------------------------------
    static tbb::enumerable_thread_specific<CRCounters> cr_counters;
@@ -35,12 +35,17 @@ struct WorkerCounters {
    atomic<u64> contention_split_succ_counter[max_dt_id] = {0};
    atomic<u64> contention_split_fail_counter[max_dt_id] = {0};
    atomic<u64> dt_split[max_dt_id] = {0};
+   atomic<u64> dt_split_skewed[max_dt_id] = {0};  // splits that did not split in the middle because keys were ascending
    atomic<u64> dt_merge_succ[max_dt_id] = {0};
    atomic<u64> dt_merge_parent_succ[max_dt_id] = {0};
    atomic<u64> dt_merge_fail[max_dt_id] = {0};
    atomic<u64> dt_merge_parent_fail[max_dt_id] = {0};
    atomic<u64> xmerge_partial_counter[max_dt_id] = {0};
    atomic<u64> xmerge_full_counter[max_dt_id] = {0};
+   atomic<u64> dt_compaction_leaves[max_dt_id] = {0};   // leaves visited by the background compaction
+   atomic<u64> dt_compaction_merges[max_dt_id] = {0};   // visits that merged or cleaned up something
+   atomic<u64> dt_compaction_passes[max_dt_id] = {0};   // passes that reached the last leaf
+   atomic<u64> dt_compaction_shrinks[max_dt_id] = {0};  // levels removed from the tree
    // -------------------------------------------------------------------------------------
    atomic<u64> dt_page_reads[max_dt_id] = {0};
    atomic<u64> dt_page_writes[max_dt_id] = {0};
@@ -54,6 +59,9 @@ struct WorkerCounters {
    atomic<u64> dt_find_parent_fast[max_dt_id] = {0};
    atomic<u64> dt_find_parent_slow[max_dt_id] = {0};
    // -------------------------------------------------------------------------------------
+   atomic<u64> dt_ahi_hit[max_dt_id] = {0};   // point lookups answered by the adaptive hash index
+   atomic<u64> dt_ahi_miss[max_dt_id] = {0};  // point lookups that consulted it and had to descend from the root
+   // -------------------------------------------------------------------------------------
    atomic<u64> dt_empty_leaf[max_dt_id] = {0};
    atomic<u64> dt_goto_page_exec[max_dt_id] = {0};
    atomic<u64> dt_goto_page_shared[max_dt_id] = {0};
@@ -65,10 +73,17 @@ struct WorkerCounters {
    atomic<u64> dt_scan_asc[max_dt_id] = {0};
    atomic<u64> dt_scan_desc[max_dt_id] = {0};
    atomic<u64> dt_scan_callback[max_dt_id] = {0};
+   atomic<u64> dt_readahead_pages[max_dt_id] = {0};   // leaves a scan asked to load asynchronously
+   atomic<u64> dt_readahead_stalls[max_dt_id] = {0};  // leaf changes that found the next leaf still on disk
    // -------------------------------------------------------------------------------------
    atomic<u64> dt_range_removed[max_dt_id] = {0};
    atomic<u64> dt_append[max_dt_id] = {0};
    atomic<u64> dt_append_opt[max_dt_id] = {0};
+   atomic<u64> dt_merge[max_dt_id] = {0};         // blind merge operations
+   atomic<u64> dt_merge_folded[max_dt_id] = {0};  // combined operands applied to the tree
+   atomic<u64> dt_vlog_appended[max_dt_id] = {0};        // value log records, including relocated ones
+   atomic<u64> dt_vlog_relocated[max_dt_id] = {0};       // live records moved out of a victim segment
+   atomic<u64> dt_vlog_segments_freed[max_dt_id] = {0};  // segments dropped by markDead or the garbage collection
    // -------------------------------------------------------------------------------------
    atomic<u64> cc_read_versions_visited[max_dt_id] = {0};
    atomic<u64> cc_read_versions_visited_not_found[max_dt_id] = {0};
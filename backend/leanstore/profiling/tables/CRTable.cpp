@@ -23,6 +23,7 @@ void CRTable::open()
    columns.emplace("key", [&](Column& out) { out << 0; });
    columns.emplace("wal_reserve_blocked", [&](Column& col) { col << (sum(CRCounters::cr_counters, &CRCounters::wal_reserve_blocked)); });
    columns.emplace("wal_reserve_immediate", [&](Column& col) { col << (sum(CRCounters::cr_counters, &CRCounters::wal_reserve_immediate)); });
+   columns.emplace("wal_spill_bytes", [&](Column& col) { col << (sum(CRCounters::cr_counters, &CRCounters::wal_spill_bytes)); });
    columns.emplace("gct_phase_1_pct", [&](Column& col) { col << 100.0 * p1 / total; });
    columns.emplace("gct_phase_2_pct", [&](Column& col) { col << 100.0 * p2 / total; });
    columns.emplace("gct_write_pct", [&](Column& col) { col << 100.0 * write / total; });
@@ -34,14 +35,26 @@ void CRTable::open()
    columns.emplace("olap_scanned_tuples", [](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::olap_scanned_tuples); });
    columns.emplace("olap_tx_abort", [](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::olap_tx_abort); });
    columns.emplace("rfa_committed_tx", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::rfa_committed_tx); });
+   columns.emplace("gct_batch_kib", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::gct_batch_bytes) / 1024.0; });
+   columns.emplace("gct_round_kib_p50", [&](Column& col) { col << CRCounters::histogramPercentile(gct_round_bytes, 0.5) / 1024.0; });
+   columns.emplace("gct_round_kib_p99", [&](Column& col) { col << CRCounters::histogramPercentile(gct_round_bytes, 0.99) / 1024.0; });
+   columns.emplace("gct_round_bytes_hist", [&](Column& col) { col << histogramToString(gct_round_bytes); });
+   columns.emplace("gct_commit_us_p50", [&](Column& col) { col << CRCounters::histogramPercentile(gct_commit_latency_us, 0.5); });
+   columns.emplace("gct_commit_us_p99", [&](Column& col) { col << CRCounters::histogramPercentile(gct_commit_latency_us, 0.99); });
+   columns.emplace("gct_commit_us_hist", [&](Column& col) { col << histogramToString(gct_commit_latency_us); });
    // -------------------------------------------------------------------------------------
    columns.emplace("cc_snapshot_restart", [](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_snapshot_restart); });
+   columns.emplace("cc_gc_batches", [](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_gc_batches); });
+   columns.emplace("cc_gc_lag_ts", [](Column& col) { col << utils::threadlocal::max(CRCounters::cr_counters, &CRCounters::cc_gc_lag_ts); });
    // -------------------------------------------------------------------------------------
    columns.emplace("wal_read_gib", [&](Column& col) {
       col << (sum(WorkerCounters::worker_counters, &WorkerCounters::wal_read_bytes) * 1.0) / 1024.0 / 1024.0 / 1024.0;
    });
-   columns.emplace("gct_write_gib",
-                   [&](Column& col) { col << (sum(CRCounters::cr_counters, &CRCounters::gct_write_bytes) * 1.0) / 1024.0 / 1024.0 / 1024.0; });
+   columns.emplace("gct_write_gib", [&](Column& col) { col << (gct_write_bytes * 1.0) / 1024.0 / 1024.0 / 1024.0; });
+   columns.emplace("gct_write_uncompressed_gib", [&](Column& col) { col << (gct_write_bytes_uncompressed * 1.0) / 1024.0 / 1024.0 / 1024.0; });
+   columns.emplace("gct_compression_ratio", [&](Column& col) {
+      col << (gct_write_bytes ? gct_write_bytes_uncompressed * 1.0 / gct_write_bytes : 1.0);
+   });
    columns.emplace("wal_write_gib", [&](Column& col) {
       col << (sum(WorkerCounters::worker_counters, &WorkerCounters::wal_write_bytes) * 1.0) / 1024.0 / 1024.0 / 1024.0;
    });
@@ -55,6 +68,12 @@ void CRTable::open()
    columns.emplace("cc_cross_workers_visibility_check",
                    [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_cross_workers_visibility_check); });
    columns.emplace("cc_versions_space_removed", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_versions_space_removed); });
+   columns.emplace("cc_versions_spilled", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_versions_spilled); });
+   columns.emplace("cc_ser_validation_aborts", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_ser_validation_aborts); });
+   columns.emplace("cc_lock_conflicts", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_lock_conflicts); });
+   columns.emplace("cc_lock_waits", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_lock_waits); });
+   columns.emplace("cc_lock_wait_dies", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_lock_wait_dies); });
+   columns.emplace("cc_lock_wait_timeouts", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_lock_wait_timeouts); });
    // -------------------------------------------------------------------------------------
    columns.emplace("cc_ms_oltp_tx", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_ms_oltp_tx); });
    columns.emplace("cc_ms_olap_tx", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_ms_olap_tx); });
@@ -66,6 +85,8 @@ void CRTable::open()
    columns.emplace("cc_ms_fat_tuple_conversion", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_ms_fat_tuple_conversion); });
    columns.emplace("cc_ms_snapshotting", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_ms_snapshotting); });
    columns.emplace("cc_ms_committing", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_ms_committing); });
+   columns.emplace("cc_ms_ser_validation", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_ms_ser_validation); });
+   columns.emplace("cc_ms_lock_wait", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_ms_lock_wait); });
    columns.emplace("cc_ms_history_tree_insert", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_ms_history_tree_insert); });
    columns.emplace("cc_ms_history_tree_retrieve", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_ms_history_tree_retrieve); });
    columns.emplace("cc_ms_refresh_global_state", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_ms_refresh_global_state); });
@@ -87,11 +108,28 @@ void CRTable::next()
    p2 = sum(CRCounters::cr_counters, &CRCounters::gct_phase_2_ms);
    write = sum(CRCounters::cr_counters, &CRCounters::gct_write_ms);
    total = p1 + p2 + write;
+   gct_write_bytes = sum(CRCounters::cr_counters, &CRCounters::gct_write_bytes);
+   gct_write_bytes_uncompressed = sum(CRCounters::cr_counters, &CRCounters::gct_write_bytes_uncompressed);
+   for (u64 b_i = 0; b_i < CRCounters::histogram_buckets; b_i++) {
+      gct_round_bytes[b_i] = sum(CRCounters::cr_counters, &CRCounters::gct_round_bytes, b_i);
+      gct_commit_latency_us[b_i] = sum(CRCounters::cr_counters, &CRCounters::gct_commit_latency_us, b_i);
+   }
    clear();
    for (auto& c : columns) {
       c.second.generator(c.second);
    }
 }
 // -------------------------------------------------------------------------------------
+std::string CRTable::histogramToString(const u64* histogram)
+{
+   std::stringstream stream;
+   for (u64 b_i = 0; b_i < CRCounters::histogram_buckets; b_i++) {
+      if (histogram[b_i]) {
+         stream << (stream.tellp() ? " " : "") << (u64(1) << b_i) << ":" << histogram[b_i];
+      }
+   }
+   return stream.str();
+}
+// -------------------------------------------------------------------------------------
 }  // namespace profiling
 }  // namespace leanstore
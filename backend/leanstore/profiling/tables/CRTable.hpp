@@ -1,5 +1,6 @@
 #pragma once
 #include "ProfilingTable.hpp"
+#include "leanstore/profiling/counters/CRCounters.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
@@ -10,8 +11,11 @@ namespace profiling
 class CRTable : public ProfilingTable
 {
   private:
-   u64 wal_hits, wal_miss;
+   u64 wal_hits, wal_miss, gct_write_bytes, gct_write_bytes_uncompressed;
    double p1, p2, total, write, wal_total, wal_hit_pct, wal_miss_pct;
+   u64 gct_round_bytes[CRCounters::histogram_buckets], gct_commit_latency_us[CRCounters::histogram_buckets];
+   // Non-empty buckets as lower_bound:count separated by spaces
+   static std::string histogramToString(const u64* histogram);
 
   public:
    virtual std::string getName();
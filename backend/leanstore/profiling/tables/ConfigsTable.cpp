@@ -35,8 +35,10 @@ void ConfigsTable::open()
    columns.emplace("c_run_for_seconds", [&](Column& col) { col << FLAGS_run_for_seconds; });
    columns.emplace("c_bulk_insert", [&](Column& col) { col << FLAGS_bulk_insert; });
    columns.emplace("c_nc_reallocation", [&](Column& col) { col << FLAGS_nc_reallocation; });
+   columns.emplace("c_scan_readahead_max", [&](Column& col) { col << FLAGS_scan_readahead_max; });
    // -------------------------------------------------------------------------------------
    columns.emplace("c_contention_split", [&](Column& col) { col << FLAGS_contention_split; });
+   columns.emplace("c_btree_skewed_splits", [&](Column& col) { col << FLAGS_btree_skewed_splits; });
    columns.emplace("c_cm_update_on", [&](Column& col) { col << FLAGS_cm_update_on; });
    columns.emplace("c_cm_period", [&](Column& col) { col << FLAGS_cm_period; });
    columns.emplace("c_cm_slowpath_threshold", [&](Column& col) { col << FLAGS_cm_slowpath_threshold; });
@@ -44,9 +46,19 @@ void ConfigsTable::open()
    columns.emplace("c_xmerge_k", [&](Column& col) { col << FLAGS_xmerge_k; });
    columns.emplace("c_xmerge", [&](Column& col) { col << FLAGS_xmerge; });
    columns.emplace("c_xmerge_target_pct", [&](Column& col) { col << FLAGS_xmerge_target_pct; });
+   columns.emplace("c_compaction", [&](Column& col) { col << FLAGS_compaction; });
+   columns.emplace("c_compaction_leaves_per_second", [&](Column& col) { col << FLAGS_compaction_leaves_per_second; });
    columns.emplace("c_btree_prefix_compression", [&](Column& col) { col << FLAGS_btree_prefix_compression; });
    columns.emplace("c_btree_heads", [&](Column& col) { col << FLAGS_btree_heads; });
    columns.emplace("c_btree_hints", [&](Column& col) { col << FLAGS_btree_hints; });
+   columns.emplace("c_btree_heads_array", [&](Column& col) { col << FLAGS_btree_heads_array; });
+   columns.emplace("c_btree_heads_simd", [&](Column& col) { col << FLAGS_btree_heads_simd; });
+   columns.emplace("c_btree_fingerprints", [&](Column& col) { col << FLAGS_btree_fingerprints; });
+   columns.emplace("c_btree_ahi", [&](Column& col) { col << FLAGS_btree_ahi; });
+   columns.emplace("c_btree_ahi_entries", [&](Column& col) { col << FLAGS_btree_ahi_entries; });
+   columns.emplace("c_merge_buffer_keys", [&](Column& col) { col << FLAGS_merge_buffer_keys; });
+   columns.emplace("c_blob_cool_after_use", [&](Column& col) { col << FLAGS_blob_cool_after_use; });
+   columns.emplace("c_vlog_gc_dead_pct", [&](Column& col) { col << FLAGS_vlog_gc_dead_pct; });
    // -------------------------------------------------------------------------------------
    columns.emplace("c_zipf_factor", [&](Column& col) { col << FLAGS_zipf_factor; });
    // -------------------------------------------------------------------------------------
@@ -57,7 +69,19 @@ void ConfigsTable::open()
    columns.emplace("c_wal_fsync", [&](Column& col) { col << FLAGS_wal_fsync; });
    columns.emplace("c_wal_variant", [&](Column& col) { col << FLAGS_wal_variant; });
    columns.emplace("c_wal_log_writers", [&](Column& col) { col << FLAGS_wal_log_writers; });
+   columns.emplace("c_wal_gct_max_wait_us", [&](Column& col) { col << FLAGS_wal_gct_max_wait_us; });
+   columns.emplace("c_wal_gct_batch_kib", [&](Column& col) { col << FLAGS_wal_gct_batch_kib; });
+   columns.emplace("c_wal_gct_p99_target_us", [&](Column& col) { col << FLAGS_wal_gct_p99_target_us; });
+   columns.emplace("c_wal_compression", [&](Column& col) { col << FLAGS_wal_compression; });
    columns.emplace("c_todo", [&](Column& col) { col << FLAGS_todo; });
+   columns.emplace("c_cc_read_start_ts", [&](Column& col) { col << FLAGS_cc_read_start_ts; });
+   columns.emplace("c_cc_lwm_thread", [&](Column& col) { col << FLAGS_cc_lwm_thread; });
+   columns.emplace("c_cc_lwm_interval_us", [&](Column& col) { col << FLAGS_cc_lwm_interval_us; });
+   columns.emplace("c_cc_gc_threads", [&](Column& col) { col << FLAGS_cc_gc_threads; });
+   columns.emplace("c_cc_gc_batch_ts", [&](Column& col) { col << FLAGS_cc_gc_batch_ts; });
+   columns.emplace("c_cc_gc_batch_pause_us", [&](Column& col) { col << FLAGS_cc_gc_batch_pause_us; });
+   columns.emplace("c_cc_lock_wait", [&](Column& col) { col << FLAGS_cc_lock_wait; });
+   columns.emplace("c_cc_lock_wait_us", [&](Column& col) { col << FLAGS_cc_lock_wait_us; });
    columns.emplace("c_mv", [&](Column& col) { col << FLAGS_mv; });
    columns.emplace("c_vi", [&](Column& col) { col << FLAGS_vi; });
    columns.emplace("c_vi_fat_tuple", [&](Column& col) { col << FLAGS_vi_fat_tuple; });
@@ -67,6 +91,9 @@ void ConfigsTable::open()
    columns.emplace("c_olap_mode", [&](Column& col) { col << FLAGS_olap_mode; });
    columns.emplace("c_graveyard", [&](Column& col) { col << FLAGS_graveyard; });
    columns.emplace("c_history_tree_inserts", [&](Column& col) { col << FLAGS_history_tree_inserts; });
+   columns.emplace("c_history_log", [&](Column& col) { col << FLAGS_history_log; });
+   columns.emplace("c_history_log_segment_kib", [&](Column& col) { col << FLAGS_history_log_segment_kib; });
+   columns.emplace("c_history_log_mib", [&](Column& col) { col << FLAGS_history_log_mib; });
    // -------------------------------------------------------------------------------------
    for (auto& c : columns) {
       c.second.generator(c.second);
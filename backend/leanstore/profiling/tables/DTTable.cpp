@@ -2,9 +2,11 @@
 
 #include "leanstore/Config.hpp"
 #include "leanstore/profiling/counters/WorkerCounters.hpp"
+#include "leanstore/storage/btree/core/BTreeNode.hpp"
 #include "leanstore/utils/ThreadLocalAggregator.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
+#include <unordered_set>
 // -------------------------------------------------------------------------------------
 using leanstore::utils::threadlocal::sum;
 namespace leanstore
@@ -43,9 +45,19 @@ void DTTable::open()
    columns.emplace("dt_scan_asc", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_scan_asc, dt_id); });
    columns.emplace("dt_scan_desc", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_scan_desc, dt_id); });
    columns.emplace("dt_scan_callback", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_scan_callback, dt_id); });
+   columns.emplace("dt_readahead_pages",
+                   [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_readahead_pages, dt_id); });
+   columns.emplace("dt_readahead_stalls",
+                   [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_readahead_stalls, dt_id); });
    // -------------------------------------------------------------------------------------
    columns.emplace("dt_append", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_append, dt_id); });
    columns.emplace("dt_append_opt", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_append_opt, dt_id); });
+   columns.emplace("dt_merge", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_merge, dt_id); });
+   columns.emplace("dt_merge_folded", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_merge_folded, dt_id); });
+   columns.emplace("dt_vlog_appended", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_vlog_appended, dt_id); });
+   columns.emplace("dt_vlog_relocated", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_vlog_relocated, dt_id); });
+   columns.emplace("dt_vlog_segments_freed",
+                   [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_vlog_segments_freed, dt_id); });
    columns.emplace("dt_range_removed", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_range_removed, dt_id); });
    // -------------------------------------------------------------------------------------
    for (u64 r_i = 0; r_i < WorkerCounters::max_researchy_counter; r_i++) {
@@ -59,6 +71,12 @@ void DTTable::open()
    columns.emplace("contention_split_fail_counter",
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::contention_split_fail_counter, dt_id); });
    columns.emplace("dt_split", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_split, dt_id); });
+   columns.emplace("dt_split_skewed", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_split_skewed, dt_id); });
+   columns.emplace("dt_resident_leaves", [&](Column& col) { col << resident_leaves[dt_id].first; });
+   columns.emplace("dt_leaf_fill_factor", [&](Column& col) {
+      const auto& [leaves, fill_sum] = resident_leaves[dt_id];
+      col << (leaves ? (fill_sum * 100.0 / leaves) : 0.0);
+   });
    columns.emplace("dt_merge_succ", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_merge_succ, dt_id); });
    columns.emplace("dt_merge_fail", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_merge_fail, dt_id); });
    columns.emplace("dt_merge_parent_succ",
@@ -69,6 +87,14 @@ void DTTable::open()
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::xmerge_partial_counter, dt_id); });
    columns.emplace("xmerge_full_counter",
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::xmerge_full_counter, dt_id); });
+   columns.emplace("dt_compaction_leaves",
+                   [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_compaction_leaves, dt_id); });
+   columns.emplace("dt_compaction_merges",
+                   [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_compaction_merges, dt_id); });
+   columns.emplace("dt_compaction_passes",
+                   [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_compaction_passes, dt_id); });
+   columns.emplace("dt_compaction_shrinks",
+                   [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_compaction_shrinks, dt_id); });
    // -------------------------------------------------------------------------------------
    columns.emplace("dt_find_parent", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_find_parent, dt_id); });
    columns.emplace("dt_find_parent_root",
@@ -78,6 +104,12 @@ void DTTable::open()
    columns.emplace("dt_find_parent_slow",
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_find_parent_slow, dt_id); });
    // -------------------------------------------------------------------------------------
+   columns.emplace("dt_ahi_hit", [&](Column& col) { col << ahi_hits; });
+   columns.emplace("dt_ahi_miss", [&](Column& col) { col << ahi_misses; });
+   columns.emplace("dt_ahi_hit_rate", [&](Column& col) {
+      col << ((ahi_hits + ahi_misses) ? (ahi_hits * 100.0 / (ahi_hits + ahi_misses)) : 0.0);
+   });
+   // -------------------------------------------------------------------------------------
    columns.emplace("cc_read_versions_visited",
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::cc_read_versions_visited, dt_id); });
    columns.emplace("cc_read_versions_visited_not_found",
@@ -139,12 +171,40 @@ void DTTable::open()
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::cc_versions_space_inserted_opt, dt_id); });
 }
 // -------------------------------------------------------------------------------------
+// Pages are read without latching them, a page that changes meanwhile only skews the numbers
+void DTTable::collectResidentLeaves()
+{
+   resident_leaves.clear();
+   std::unordered_set<DTID> btrees;
+   for (const auto& dt : bm.getDTRegistry().dt_instances_ht) {
+      const DTType dt_type = std::get<0>(dt.second);
+      if (dt_type == 0 || dt_type == 2) {  // BTreeLL, BTreeVI
+         btrees.insert(dt.first);
+      }
+   }
+   for (u64 bf_i = 0; bf_i < bm.dram_pool_size; bf_i++) {
+      BufferFrame& bf = bm.bfs[bf_i];
+      if (bf.isFree() || !btrees.count(bf.page.dt_id)) {
+         continue;
+      }
+      auto& node = *reinterpret_cast<btree::BTreeNode*>(bf.page.dt);
+      if (node.is_leaf) {
+         auto& [leaves, fill_sum] = resident_leaves[bf.page.dt_id];
+         leaves++;
+         fill_sum += node.fillFactorAfterCompaction();
+      }
+   }
+}
+// -------------------------------------------------------------------------------------
 void DTTable::next()
 {
    clear();
+   collectResidentLeaves();
    for (const auto& dt : bm.getDTRegistry().dt_instances_ht) {
       dt_id = dt.first;
       dt_name = std::get<2>(dt.second);
+      ahi_hits = sum(WorkerCounters::worker_counters, &WorkerCounters::dt_ahi_hit, dt_id);
+      ahi_misses = sum(WorkerCounters::worker_counters, &WorkerCounters::dt_ahi_miss, dt_id);
       for (auto& c : columns) {
          c.second.generator(c.second);
       }
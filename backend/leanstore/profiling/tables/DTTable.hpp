@@ -3,6 +3,7 @@
 #include "leanstore/storage/buffer-manager/BufferManager.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
+#include <unordered_map>
 // -------------------------------------------------------------------------------------
 namespace leanstore
 {
@@ -15,6 +16,12 @@ class DTTable : public ProfilingTable
    string dt_name;
    DTID dt_id;
    BufferManager& bm;
+   // Summed once per row because reading a counter resets it and the hit rate needs both
+   u64 ahi_hits;
+   u64 ahi_misses;
+   // Resident B-Tree leaves per DT: count and summed fill factor, collected by one pass over the buffer pool per next()
+   std::unordered_map<DTID, std::pair<u64, double>> resident_leaves;
+   void collectResidentLeaves();
 
   public:
    DTTable(BufferManager& bm);
@@ -0,0 +1,377 @@
+#include "BlobStore.hpp"
+
+#include "leanstore/concurrency-recovery/CRMG.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <cstddef>
+// -------------------------------------------------------------------------------------
+using namespace std;
+using namespace leanstore::storage;
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace blob
+{
+// -------------------------------------------------------------------------------------
+void BlobStore::create(DTID dtid, Config config)
+{
+   // The swip table is keyed by PID, out of place writes would move pages underneath it
+   ensure(!FLAGS_out_of_place);
+   this->dt_id = dtid;
+   this->config = config;
+}
+// -------------------------------------------------------------------------------------
+BlobStore::Writer::Writer(BlobStore& store) : store(store), tail(std::make_unique<u8[]>(EFFECTIVE_PAGE_SIZE)) {}
+// -------------------------------------------------------------------------------------
+void BlobStore::Writer::append(const u8* data, u64 length)
+{
+   this->length += length;
+   while (length) {
+      if (tail_length == 0 && length >= EFFECTIVE_PAGE_SIZE) {
+         // Whole pages are written straight from the caller's buffer
+         data_pids.push_back(store.writePage(data, EFFECTIVE_PAGE_SIZE, store.config.enable_wal));
+         data += EFFECTIVE_PAGE_SIZE;
+         length -= EFFECTIVE_PAGE_SIZE;
+         continue;
+      }
+      const u64 piece = std::min(EFFECTIVE_PAGE_SIZE - tail_length, length);
+      std::memcpy(tail.get() + tail_length, data, piece);
+      tail_length += piece;
+      data += piece;
+      length -= piece;
+      if (tail_length == EFFECTIVE_PAGE_SIZE) {
+         flushTail();
+      }
+   }
+}
+// -------------------------------------------------------------------------------------
+void BlobStore::Writer::flushTail()
+{
+   data_pids.push_back(store.writePage(tail.get(), tail_length, store.config.enable_wal));
+   tail_length = 0;
+}
+// -------------------------------------------------------------------------------------
+BlobDescriptor BlobStore::Writer::finish()
+{
+   if (tail_length) {
+      flushTail();
+   }
+   BlobDescriptor descriptor;
+   descriptor.length = length;
+   // Index pages are written back to front, so each one knows its successor
+   const u64 index_pages = (data_pids.size() + BlobIndexPage::capacity - 1) / BlobIndexPage::capacity;
+   auto index = std::make_unique<BlobIndexPage>();
+   PID next = 0;
+   for (s64 i_i = s64(index_pages) - 1; i_i >= 0; i_i--) {
+      const u64 first = i_i * BlobIndexPage::capacity;
+      index->next = next;
+      index->count = std::min<u64>(BlobIndexPage::capacity, data_pids.size() - first);
+      std::memcpy(index->pids, data_pids.data() + first, index->count * sizeof(PID));
+      next = store.writePage(reinterpret_cast<u8*>(index.get()), offsetof(BlobIndexPage, pids) + index->count * sizeof(PID), store.config.enable_wal);
+   }
+   descriptor.index_pid = next;
+   data_pids.clear();
+   length = 0;
+   return descriptor;
+}
+// -------------------------------------------------------------------------------------
+void BlobStore::Writer::abort()
+{
+   for (const PID pid : data_pids) {
+      store.dropPage(pid);
+   }
+   data_pids.clear();
+   tail_length = 0;
+   length = 0;
+}
+// -------------------------------------------------------------------------------------
+BlobDescriptor BlobStore::put(const u8* data, u64 length)
+{
+   Writer writer(*this);
+   writer.append(data, length);
+   return writer.finish();
+}
+// -------------------------------------------------------------------------------------
+void BlobStore::read(const BlobDescriptor& descriptor, u64 offset, u64 length, std::function<void(const u8*, u64)> callback)
+{
+   if (offset >= descriptor.length) {
+      return;
+   }
+   length = std::min(length, descriptor.length - offset);
+   if (length == 0) {
+      return;
+   }
+   const u64 first_page = offset / EFFECTIVE_PAGE_SIZE;
+   const u64 last_page = (offset + length - 1) / EFFECTIVE_PAGE_SIZE;
+   const std::vector<PID> pids = dataPIDs(descriptor, first_page, last_page - first_page + 1);
+   u64 position = offset;
+   for (const PID pid : pids) {
+      const u64 in_page_offset = position % EFFECTIVE_PAGE_SIZE;
+      const u64 piece = std::min(EFFECTIVE_PAGE_SIZE - in_page_offset, offset + length - position);
+      while (true) {
+         jumpmuTry()
+         {
+            HybridPageGuard<BlobDataPage> page;
+            fixPage(page, pid);
+            page.toShared();
+            callback(page->data + in_page_offset, piece);
+            jumpmu_break;
+         }
+         jumpmuCatch() {}
+      }
+      if (FLAGS_blob_cool_after_use) {
+         coolPage(pid);
+      }
+      position += piece;
+   }
+}
+// -------------------------------------------------------------------------------------
+u64 BlobStore::read(const BlobDescriptor& descriptor, u64 offset, u64 length, u8* destination)
+{
+   u64 copied = 0;
+   read(descriptor, offset, length, [&](const u8* data, u64 piece) {
+      std::memcpy(destination + copied, data, piece);
+      copied += piece;
+   });
+   return copied;
+}
+// -------------------------------------------------------------------------------------
+void BlobStore::remove(const BlobDescriptor& descriptor)
+{
+   if (descriptor.length == 0) {
+      return;
+   }
+   std::vector<PID> index_pids;
+   const u64 pages_count = (descriptor.length + EFFECTIVE_PAGE_SIZE - 1) / EFFECTIVE_PAGE_SIZE;
+   for (const PID pid : dataPIDs(descriptor, 0, pages_count, &index_pids)) {
+      dropPage(pid);
+   }
+   for (const PID pid : index_pids) {
+      dropPage(pid);
+   }
+}
+// -------------------------------------------------------------------------------------
+std::vector<PID> BlobStore::dataPIDs(const BlobDescriptor& descriptor, u64 first_page, u64 pages_count, std::vector<PID>* index_pids)
+{
+   std::vector<PID> pids;
+   pids.reserve(pages_count);
+   PID index_pid = descriptor.index_pid;
+   u64 index_first_page = 0;  // number of the first data page listed in the current index page
+   while (pids.size() < pages_count) {
+      PID next;
+      u64 count;
+      while (true) {
+         jumpmuTry()
+         {
+            HybridPageGuard<BlobIndexPage> index;
+            fixPage(index, index_pid);
+            index.toShared();
+            next = index->next;
+            count = index->count;
+            const u64 wanted = first_page + pids.size();
+            if (wanted < index_first_page + count) {
+               const u64 from = wanted - index_first_page;
+               const u64 to = std::min(count, from + (pages_count - pids.size()));
+               pids.insert(pids.end(), index->pids + from, index->pids + to);
+            }
+            jumpmu_break;
+         }
+         jumpmuCatch() {}
+      }
+      if (index_pids) {
+         index_pids->push_back(index_pid);
+      }
+      if (FLAGS_blob_cool_after_use) {
+         coolPage(index_pid);
+      }
+      index_pid = next;
+      index_first_page += count;
+   }
+   return pids;
+}
+// -------------------------------------------------------------------------------------
+PID BlobStore::writePage(const u8* data, u64 length, bool wal)
+{
+   assert(length <= EFFECTIVE_PAGE_SIZE);
+   if (wal) {
+      // Page image plus entry headers
+      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 2);
+   }
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<BlobDataPage> page(dt_id);
+         std::memcpy(page->data, data, length);
+         if (wal) {
+            auto wal_entry = page.reserveWALEntry<WALBlobPage>(length);
+            wal_entry->length = length;
+            std::memcpy(wal_entry->payload, data, length);
+            wal_entry.submit();
+         }
+         // -------------------------------------------------------------------------------------
+         const PID pid = page.bf->header.pid;
+         Bucket& bucket = bucketFor(pid);
+         Guard b_guard(bucket.latch);
+         b_guard.toExclusive();
+         Swip<BufferFrame>& swip = bucket.swips[pid];
+         swip.warm(page.bf);
+         if (FLAGS_blob_cool_after_use) {
+            page.bf->header.state = BufferFrame::STATE::COOL;
+            swip.cool();
+         }
+         b_guard.unlock();
+         jumpmu_return pid;
+      }
+      jumpmuCatch() {}
+   }
+}
+// -------------------------------------------------------------------------------------
+// Best effort, the page provider picks up COOL frames as eviction candidates without looking at their parents first
+void BlobStore::coolPage(PID pid)
+{
+   jumpmuTry()
+   {
+      Bucket& bucket = bucketFor(pid);
+      Guard b_guard(bucket.latch);
+      b_guard.toOptimisticOrJump();
+      b_guard.tryToShared();
+      auto swip_itr = bucket.swips.find(pid);
+      const bool is_hot = swip_itr != bucket.swips.end() && swip_itr->second.isHOT();
+      b_guard.unlock();
+      if (!is_hot) {
+         jumpmu_return;
+      }
+      Swip<BufferFrame>& swip = swip_itr->second;
+      BufferFrame& bf = swip.asBufferFrame();
+      BMOptimisticGuard bf_guard(bf.header.latch);
+      b_guard.recheck();
+      if (bf.header.keep_in_memory || bf.header.state != BufferFrame::STATE::HOT) {
+         jumpmu_return;
+      }
+      BMExclusiveUpgradeIfNeeded b_x_guard(b_guard);
+      BMExclusiveGuard bf_x_guard(bf_guard);
+      bf.header.state = BufferFrame::STATE::COOL;
+      swip.cool();
+   }
+   jumpmuCatch() {}
+}
+// -------------------------------------------------------------------------------------
+void BlobStore::dropPage(PID pid)
+{
+   Bucket& bucket = bucketFor(pid);
+   while (true) {
+      jumpmuTry()
+      {
+         {
+            Guard b_guard(bucket.latch);
+            b_guard.toExclusive();
+            auto swip_itr = bucket.swips.find(pid);
+            if (swip_itr == bucket.swips.end() || swip_itr->second.isEVICTED()) {
+               // No need to read the page back just to free it
+               if (swip_itr != bucket.swips.end()) {
+                  bucket.swips.erase(swip_itr);
+               }
+               b_guard.unlock();
+               BMC::global_bf->reclaimPID(pid);
+               jumpmu_break;
+            }
+            b_guard.unlock();
+         }
+         // Latch order is page before bucket, like in writePage. Everybody going the other way only tries to latch the page
+         HybridPageGuard<BlobDataPage> page;
+         fixPage(page, pid);
+         page.toExclusive();
+         {
+            Guard b_guard(bucket.latch);
+            b_guard.toExclusive();
+            bucket.swips.erase(pid);
+            b_guard.unlock();
+         }
+         page.reclaim();
+         jumpmu_break;
+      }
+      jumpmuCatch() {}
+   }
+}
+// -------------------------------------------------------------------------------------
+struct DTRegistry::DTMeta BlobStore::getMeta()
+{
+   DTRegistry::DTMeta blob_meta = {.iterate_children = iterateChildrenSwips,
+                                   .find_parent = findParent,
+                                   .check_space_utilization = checkSpaceUtilization,
+                                   .checkpoint = checkpoint,
+                                   .undo = undo,
+                                   .todo = todo,
+                                   .unlock = unlock,
+                                   .serialize = serialize,
+                                   .deserialize = deserialize};
+   return blob_meta;
+}
+// -------------------------------------------------------------------------------------
+// BLOB pages are leaves
+void BlobStore::iterateChildrenSwips(void*, BufferFrame&, std::function<bool(Swip<BufferFrame>&)>) {}
+// -------------------------------------------------------------------------------------
+// The bucket latch plays the role of the parent page latch
+struct ParentSwipHandler BlobStore::findParent(void* blob_store, BufferFrame& to_find)
+{
+   auto& store = *reinterpret_cast<BlobStore*>(blob_store);
+   const PID pid = to_find.header.pid;
+   Bucket& bucket = store.bucketFor(pid);
+   Guard b_guard(bucket.latch);
+   b_guard.toOptimisticOrJump();
+   b_guard.tryToShared();
+   auto swip_itr = bucket.swips.find(pid);
+   const bool found = swip_itr != bucket.swips.end() && !swip_itr->second.isEVICTED() && &swip_itr->second.asBufferFrameMasked() == &to_find;
+   b_guard.unlock();
+   if (!found) {
+      jumpmu::jump();
+   }
+   // Map nodes stay put until they are erased, which requires the bucket latch exclusively
+   ParentSwipHandler parent_handler = {.swip = swip_itr->second, .parent_guard = std::move(b_guard), .parent_bf = nullptr};
+   return parent_handler;
+}
+// -------------------------------------------------------------------------------------
+SpaceCheckResult BlobStore::checkSpaceUtilization(void*, BufferFrame&)
+{
+   return SpaceCheckResult::NOTHING;
+}
+// -------------------------------------------------------------------------------------
+void BlobStore::checkpoint(void*, BufferFrame& bf, u8* dest)
+{
+   std::memcpy(dest, bf.page.dt, EFFECTIVE_PAGE_SIZE);
+}
+// -------------------------------------------------------------------------------------
+void BlobStore::undo(void*, const u8*, const u64)
+{
+   // TODO: undo for storage
+   TODOException();
+}
+// -------------------------------------------------------------------------------------
+void BlobStore::todo(void*, const u8*, const u64, const u64, const bool)
+{
+   UNREACHABLE();
+}
+// -------------------------------------------------------------------------------------
+void BlobStore::unlock(void*, const u8*)
+{
+   UNREACHABLE();
+}
+// -------------------------------------------------------------------------------------
+std::unordered_map<std::string, std::string> BlobStore::serialize(void* blob_store)
+{
+   auto& store = *reinterpret_cast<BlobStore*>(blob_store);
+   return {{"dt_id", std::to_string(store.dt_id)}};
+}
+// -------------------------------------------------------------------------------------
+// Swips are recreated lazily when a page is first accessed
+void BlobStore::deserialize(void* blob_store, std::unordered_map<std::string, std::string> map)
+{
+   auto& store = *reinterpret_cast<BlobStore*>(blob_store);
+   store.dt_id = std::stol(map["dt_id"]);
+}
+// -------------------------------------------------------------------------------------
+}  // namespace blob
+}  // namespace storage
+}  // namespace leanstore
@@ -0,0 +1,137 @@
+#pragma once
+#include "Units.hpp"
+#include "leanstore/Config.hpp"
+#include "leanstore/storage/buffer-manager/BufferManager.hpp"
+#include "leanstore/sync-primitives/PageGuard.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace blob
+{
+// -------------------------------------------------------------------------------------
+// What a data structure stores instead of a value that does not fit into a page
+struct BlobDescriptor {
+   u64 length = 0;
+   PID index_pid = 0;  // first index page, unused for empty BLOBs
+};
+// -------------------------------------------------------------------------------------
+struct BlobDataPage {
+   u8 data[EFFECTIVE_PAGE_SIZE];
+};
+// Index pages list the data pages of a BLOB in order and are chained through next
+struct BlobIndexPage {
+   static constexpr u64 capacity = (EFFECTIVE_PAGE_SIZE - 2 * sizeof(u64)) / sizeof(PID);
+   PID next = 0;
+   u64 count = 0;
+   PID pids[capacity];
+};
+static_assert(sizeof(BlobIndexPage) <= EFFECTIVE_PAGE_SIZE, "");
+// -------------------------------------------------------------------------------------
+// Overflow pages for values larger than a page. BLOB pages are ordinary buffer-managed pages, but they are not referenced from
+// B-Tree nodes: the store itself owns their swips in a hash table keyed by PID and acts as their parent towards the page provider.
+// Pages are cooled right after each access (FLAGS_blob_cool_after_use), so they are evicted before the tree pages that point to them
+class BlobStore
+{
+  public:
+   struct Config {
+      bool enable_wal = true;
+   };
+   struct WALBlobPage {
+      u64 length;
+      u8 payload[];
+   };
+   // -------------------------------------------------------------------------------------
+   // Streams a BLOB into pages, nothing is visible before finish() returns the descriptor
+   class Writer
+   {
+     public:
+      Writer(BlobStore& store);
+      void append(const u8* data, u64 length);
+      BlobDescriptor finish();
+      void abort();  // frees the pages written so far
+
+     private:
+      BlobStore& store;
+      std::vector<PID> data_pids;
+      std::unique_ptr<u8[]> tail;
+      u64 tail_length = 0;
+      u64 length = 0;
+      void flushTail();
+   };
+   // -------------------------------------------------------------------------------------
+   DTID dt_id;
+   Config config;
+   // -------------------------------------------------------------------------------------
+   BlobStore() = default;
+   void create(DTID dtid, Config config);
+   // -------------------------------------------------------------------------------------
+   BlobDescriptor put(const u8* data, u64 length);
+   // Calls callback for each piece of [offset, offset + length) in order, while the page holding it is shared latched
+   void read(const BlobDescriptor& descriptor, u64 offset, u64 length, std::function<void(const u8* data, u64 length)> callback);
+   // Copies [offset, offset + length) into destination, returns the number of bytes copied
+   u64 read(const BlobDescriptor& descriptor, u64 offset, u64 length, u8* destination);
+   void remove(const BlobDescriptor& descriptor);
+   // -------------------------------------------------------------------------------------
+   static DTRegistry::DTMeta getMeta();
+   static void iterateChildrenSwips(void*, BufferFrame&, std::function<bool(Swip<BufferFrame>&)>);
+   static ParentSwipHandler findParent(void* blob_store, BufferFrame& to_find);
+   static SpaceCheckResult checkSpaceUtilization(void*, BufferFrame&);
+   static void checkpoint(void*, BufferFrame& bf, u8* dest);
+   static void undo(void*, const u8*, const u64);
+   static void todo(void*, const u8*, const u64, const u64, const bool);
+   static void unlock(void*, const u8*);
+   static std::unordered_map<std::string, std::string> serialize(void* blob_store);
+   static void deserialize(void* blob_store, std::unordered_map<std::string, std::string> serialized);
+
+  protected:
+   // Swips of evicted pages stay in their bucket, pages that were never touched since startup have no entry at all
+   struct alignas(64) Bucket {
+      HybridLatch latch;
+      std::unordered_map<PID, Swip<BufferFrame>> swips;
+   };
+   static constexpr u64 buckets_count = 1024;  // see bucketFor
+   std::unique_ptr<Bucket[]> buckets = std::make_unique<Bucket[]>(buckets_count);
+   // -------------------------------------------------------------------------------------
+   Bucket& bucketFor(PID pid) { return buckets[(pid * 0x9E3779B97F4A7C15ull) >> 54]; }  // top 10 bits
+   PID writePage(const u8* data, u64 length, bool wal);
+   // Leaves page optimistically latched, can jump
+   template <typename T>
+   void fixPage(HybridPageGuard<T>& page, PID pid)
+   {
+      Bucket& bucket = bucketFor(pid);
+      Guard b_guard(bucket.latch);
+      b_guard.toOptimisticSpin();
+      b_guard.toShared();
+      auto swip_itr = bucket.swips.find(pid);
+      if (swip_itr == bucket.swips.end()) {
+         // Not touched since startup, so the page is on disk
+         b_guard.unlock();
+         b_guard.toExclusive();
+         swip_itr = bucket.swips.try_emplace(pid).first;
+         swip_itr->second.evict(pid);
+      }
+      b_guard.unlock();
+      BufferFrame& bf = BMC::global_bf->tryFastResolveSwip(b_guard, swip_itr->second);
+      page.bf = &bf;
+      page.guard = Guard(bf.header.latch);
+      page.guard.toOptimisticSpin();
+      b_guard.recheck();
+      page.syncGSN();
+   }
+   void coolPage(PID pid);
+   void dropPage(PID pid);
+   // Collects the data pages [first_page, first_page + pages_count) and optionally the index pages visited on the way
+   std::vector<PID> dataPIDs(const BlobDescriptor& descriptor, u64 first_page, u64 pages_count, std::vector<PID>* index_pids = nullptr);
+};
+// -------------------------------------------------------------------------------------
+}  // namespace blob
+}  // namespace storage
+}  // namespace leanstore
@@ -0,0 +1,241 @@
+#include "QueueDT.hpp"
+
+#include "leanstore/concurrency-recovery/CRMG.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <cstddef>
+// -------------------------------------------------------------------------------------
+using namespace std;
+using namespace leanstore::storage;
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace blob
+{
+// -------------------------------------------------------------------------------------
+void QueueDT::push(const u8* payload, u16 payload_length)
+{
+   ensure(payload_length <= max_entry_length);
+   loadSegments();
+   const u32 entry_length = sizeof(u16) + payload_length;
+   cr::activeTX().markAsWrite();
+   if (config.enable_wal) {
+      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+   }
+   Tail& tail = tails[std::min<u64>(cr::Worker::my().workerID(), tails_count - 1)];
+   std::unique_lock<std::mutex> tail_guard(tail.mutex);
+   if (tail.pid == 0 || tail.used + entry_length > sizeof(Segment::data)) {
+      startSegment(tail);
+   }
+   const u32 offset = tail.used;
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<Segment> segment;
+         fixPage(segment, tail.pid);
+         segment.toExclusive();
+         std::memcpy(segment->data + offset, &payload_length, sizeof(u16));
+         std::memcpy(segment->data + offset + sizeof(u16), payload, payload_length);
+         segment->used = offset + entry_length;
+         segment->count++;
+         if (config.enable_wal) {
+            auto wal_entry = segment.reserveWALEntry<WALPush>(entry_length);
+            wal_entry->type = WAL_LOG_TYPE::WALPush;
+            wal_entry->offset = offset;
+            wal_entry->length = entry_length;
+            std::memcpy(wal_entry->payload, segment->data + offset, entry_length);
+            wal_entry.submit();
+         } else {
+            segment.markAsDirty();
+         }
+         jumpmu_break;
+      }
+      jumpmuCatch() {}
+   }
+   tail.used += entry_length;
+}
+// -------------------------------------------------------------------------------------
+void QueueDT::loadSegments()
+{
+   std::call_once(load_once, [&]() {
+      std::deque<PID> loaded;
+      for (PID pid = recovered_head_pid; pid != 0;) {
+         loaded.push_back(pid);
+         while (true) {
+            jumpmuTry()
+            {
+               HybridPageGuard<Segment> segment;
+               fixPage(segment, pid);
+               segment.toShared();
+               pid = segment->next;
+               jumpmu_break;
+            }
+            jumpmuCatch() {}
+         }
+      }
+      std::unique_lock<std::mutex> guard(segments_mutex);
+      segments = std::move(loaded);
+      segments_loaded = true;
+   });
+}
+// -------------------------------------------------------------------------------------
+void QueueDT::link(PID pid, PID next)
+{
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<Segment> segment;
+         fixPage(segment, pid);
+         segment.toExclusive();
+         segment->next = next;
+         if (config.enable_wal) {
+            auto wal_entry = segment.reserveWALEntry<WALLink>(0);
+            wal_entry->type = WAL_LOG_TYPE::WALLink;
+            wal_entry->next = next;
+            wal_entry.submit();
+         } else {
+            segment.markAsDirty();
+         }
+         jumpmu_break;
+      }
+      jumpmuCatch() {}
+   }
+}
+// -------------------------------------------------------------------------------------
+// The new segment goes behind the newest one. Consumers never free the newest segment, so it stays until it is linked
+void QueueDT::startSegment(Tail& tail)
+{
+   const u8 empty_segment[offsetof(Segment, data)] = {0};
+   const PID pid = writePage(empty_segment, sizeof(empty_segment), config.enable_wal);
+   std::unique_lock<std::mutex> producers_guard(producers_mutex);
+   PID newest = 0;
+   {
+      std::unique_lock<std::mutex> guard(segments_mutex);
+      if (!segments.empty()) {
+         newest = segments.back();
+      }
+   }
+   if (newest != 0) {
+      link(newest, pid);
+   }
+   std::unique_lock<std::mutex> guard(segments_mutex);
+   segments.push_back(pid);
+   open_segments.erase(tail.pid);
+   open_segments.insert(pid);
+   tail.pid = pid;
+   tail.used = 0;
+}
+// -------------------------------------------------------------------------------------
+// A consumed segment is sealed once its worker moved on and another segment follows it, its next pointer does not change
+// anymore. Sealed segments are unlinked from the list and freed wherever they are, the tail of an idle worker does not keep
+// the consumed segments behind it
+u64 QueueDT::popBatch(u64 max_count, utils::FunctionRef<void(const u8* payload, u16 payload_length)> callback)
+{
+   loadSegments();
+   cr::activeTX().markAsWrite();
+   if (config.enable_wal) {
+      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+   }
+   u64 popped = 0;
+   std::unique_lock<std::mutex> consumers_guard(consumers_mutex);
+   PID previous = 0;  // last segment before segment_i that stays in the list
+   for (u64 segment_i = 0; popped < max_count;) {
+      PID pid;
+      bool sealed;
+      {
+         std::unique_lock<std::mutex> guard(segments_mutex);
+         if (segment_i >= segments.size()) {
+            break;
+         }
+         pid = segments[segment_i];
+         sealed = segment_i + 1 < segments.size() && open_segments.find(pid) == open_segments.end();
+      }
+      bool consumed;
+      PID next;
+      while (true) {
+         jumpmuTry()
+         {
+            HybridPageGuard<Segment> segment;
+            fixPage(segment, pid);
+            segment.toExclusive();
+            const u64 popped_before = popped;
+            while (segment->consumed < segment->count && popped < max_count) {
+               u16 payload_length;
+               std::memcpy(&payload_length, segment->data + segment->head, sizeof(u16));
+               callback(segment->data + segment->head + sizeof(u16), payload_length);
+               segment->head += sizeof(u16) + payload_length;
+               segment->consumed++;
+               popped++;
+            }
+            if (popped != popped_before) {
+               if (config.enable_wal) {
+                  auto wal_entry = segment.reserveWALEntry<WALPop>(0);
+                  wal_entry->type = WAL_LOG_TYPE::WALPop;
+                  wal_entry->consumed = segment->consumed;
+                  wal_entry->head = segment->head;
+                  wal_entry.submit();
+               } else {
+                  segment.markAsDirty();
+               }
+            }
+            consumed = segment->consumed == segment->count;
+            next = segment->next;
+            jumpmu_break;
+         }
+         jumpmuCatch() {}
+      }
+      if (!consumed) {
+         break;
+      }
+      if (!sealed) {
+         // Its worker may still push to it
+         previous = pid;
+         segment_i++;
+         continue;
+      }
+      if (previous != 0) {
+         link(previous, next);
+      }
+      {
+         std::unique_lock<std::mutex> guard(segments_mutex);
+         segments.erase(segments.begin() + segment_i);
+      }
+      dropPage(pid);
+   }
+   return popped;
+}
+// -------------------------------------------------------------------------------------
+struct DTRegistry::DTMeta QueueDT::getMeta()
+{
+   DTRegistry::DTMeta queue_meta = BlobStore::getMeta();
+   queue_meta.serialize = serialize;
+   queue_meta.deserialize = deserialize;
+   return queue_meta;
+}
+// -------------------------------------------------------------------------------------
+// Towards the buffer manager the queue is a BLOB store, the callbacks get a BlobStore pointer
+std::unordered_map<std::string, std::string> QueueDT::serialize(void* blob_store)
+{
+   auto& queue = static_cast<QueueDT&>(*reinterpret_cast<BlobStore*>(blob_store));
+   std::unique_lock<std::mutex> guard(queue.segments_mutex);
+   PID head_pid = queue.recovered_head_pid;
+   if (queue.segments_loaded) {
+      head_pid = queue.segments.empty() ? 0 : queue.segments.front();
+   }
+   return {{"dt_id", std::to_string(queue.dt_id)}, {"head_pid", std::to_string(head_pid)}};
+}
+// -------------------------------------------------------------------------------------
+// Only remembers the head, loadSegments rebuilds the list from the next pointers once a worker uses the queue. All segments are
+// sealed, the workers start new tails
+void QueueDT::deserialize(void* blob_store, std::unordered_map<std::string, std::string> map)
+{
+   auto& queue = static_cast<QueueDT&>(*reinterpret_cast<BlobStore*>(blob_store));
+   BlobStore::deserialize(blob_store, map);
+   queue.recovered_head_pid = std::stoull(map["head_pid"]);
+}
+// -------------------------------------------------------------------------------------
+}  // namespace blob
+}  // namespace storage
+}  // namespace leanstore
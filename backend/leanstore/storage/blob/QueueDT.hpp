@@ -0,0 +1,96 @@
+#pragma once
+#include "BlobStore.hpp"
+#include "Units.hpp"
+#include "leanstore/utils/FunctionRef.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace blob
+{
+// -------------------------------------------------------------------------------------
+// FIFO queue of byte strings over a linked list of segments, a segment being one page that is owned by the store like a
+// BLOB page. Each worker pushes to its own tail segment without touching the others, every new segment is linked behind the
+// newest one of all workers. Consumers pop from the oldest segment and free every segment that is consumed and whose worker
+// moved on, wherever it is in the list. The order is therefore FIFO per producer, across producers only at the granularity of
+// segments.
+// Like BTreeLL, the queue is not transactional: pushes and pops are visible right away and survive an abort
+class QueueDT : public BlobStore
+{
+  public:
+   struct Segment {
+      PID next;      // segment that was started after this one, 0 for the newest
+      u16 count;     // pushed entries
+      u16 consumed;  // popped entries
+      u32 head;      // offset of the oldest entry that was not popped yet
+      u32 used;
+      u8 data[EFFECTIVE_PAGE_SIZE - sizeof(PID) - 2 * sizeof(u16) - 2 * sizeof(u32)];  // entries: u16 length | payload
+   };
+   static_assert(sizeof(Segment) <= EFFECTIVE_PAGE_SIZE, "");
+   enum class WAL_LOG_TYPE : u8 { WALPush = 1, WALPop = 2, WALLink = 3 };
+   struct WALEntry {
+      WAL_LOG_TYPE type;
+   };
+   struct WALPush : WALEntry {
+      u32 offset;
+      u16 length;
+      u8 payload[];
+   };
+   // State of the segment after popping
+   struct WALPop : WALEntry {
+      u16 consumed;
+      u32 head;
+   };
+   struct WALLink : WALEntry {
+      PID next;
+   };
+   static constexpr u64 max_entry_length = sizeof(Segment::data) - sizeof(u16);
+   // -------------------------------------------------------------------------------------
+   QueueDT() : tails_count(FLAGS_worker_threads + 1), tails(std::make_unique<Tail[]>(tails_count)) {}
+   // -------------------------------------------------------------------------------------
+   void push(const u8* payload, u16 payload_length);
+   // Pops up to max_count entries from the head and calls callback for each of them while its segment is latched.
+   // Returns the number of popped entries, 0 if the queue is empty
+   u64 popBatch(u64 max_count, utils::FunctionRef<void(const u8* payload, u16 payload_length)> callback);
+   bool pop(utils::FunctionRef<void(const u8* payload, u16 payload_length)> callback) { return popBatch(1, callback) == 1; }
+   // -------------------------------------------------------------------------------------
+   static DTRegistry::DTMeta getMeta();
+   static std::unordered_map<std::string, std::string> serialize(void* blob_store);
+   static void deserialize(void* blob_store, std::unordered_map<std::string, std::string> serialized);
+
+  private:
+   struct alignas(64) Tail {
+      std::mutex mutex;
+      PID pid = 0;
+      u32 used = 0;
+   };
+   u64 tails_count;
+   std::unique_ptr<Tail[]> tails;  // one per worker and one shared by all special workers
+   // Only consumers remove segments and only producers append them, each side one after the other. segments_mutex guards
+   // the list itself and is never held while a page is fixed
+   std::mutex consumers_mutex;
+   std::mutex producers_mutex;
+   std::mutex segments_mutex;
+   std::deque<PID> segments;               // oldest first
+   std::unordered_set<PID> open_segments;  // tails of the workers, nobody frees them
+   // After a restart the list is rebuilt from the head by the first operation, the recovery itself has no worker to fix pages
+   std::once_flag load_once;
+   bool segments_loaded = false;  // serialize reports recovered_head_pid before
+   PID recovered_head_pid = 0;
+   // -------------------------------------------------------------------------------------
+   void loadSegments();
+   void startSegment(Tail& tail);
+   void link(PID pid, PID next);
+};
+// -------------------------------------------------------------------------------------
+}  // namespace blob
+}  // namespace storage
+}  // namespace leanstore
@@ -0,0 +1,195 @@
+#include "ValueLog.hpp"
+
+#include "leanstore/concurrency-recovery/CRMG.hpp"
+#include "leanstore/profiling/counters/WorkerCounters.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+using namespace std;
+using namespace leanstore::storage;
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace blob
+{
+// -------------------------------------------------------------------------------------
+ValueLogPointer ValueLog::append(Slice key, Slice value, bool wal)
+{
+   const u32 record_length = sizeof(Record) + key.length() + value.length();
+   ensure(record_length <= max_record_length);
+   Tail& tail = tails[std::min<u64>(cr::Worker::my().workerID(), tails_count - 1)];
+   std::unique_lock<std::mutex> tail_guard(tail.mutex);
+   if (tail.pid == 0 || tail.used + record_length > max_record_length) {
+      startSegment(tail, wal);
+   }
+   ValueLogPointer pointer;
+   pointer.pid = tail.pid;
+   pointer.offset = tail.used;
+   pointer.key_length = key.length();
+   pointer.value_length = value.length();
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<Segment> segment;
+         fixPage(segment, pointer.pid);
+         segment.toExclusive();
+         auto& record = *reinterpret_cast<Record*>(segment->data + pointer.offset);
+         record.key_length = key.length();
+         record.value_length = value.length();
+         std::memcpy(record.payload, key.data(), key.length());
+         std::memcpy(record.payload + key.length(), value.data(), value.length());
+         segment->used = pointer.offset + record_length;
+         if (wal) {
+            auto wal_entry = segment.reserveWALEntry<WALAppend>(record_length);
+            wal_entry->offset = pointer.offset;
+            wal_entry->length = record_length;
+            std::memcpy(wal_entry->payload, &record, record_length);
+            wal_entry.submit();
+         } else {
+            segment.markAsDirty();
+         }
+         jumpmu_break;
+      }
+      jumpmuCatch() {}
+   }
+   tail.used += record_length;
+   {
+      std::unique_lock<std::mutex> guard(segments_mutex);
+      segments[pointer.pid].used += record_length;
+   }
+   COUNTERS_BLOCK()
+   {
+      WorkerCounters::myCounters().dt_vlog_appended[dt_id]++;
+   }
+   return pointer;
+}
+// -------------------------------------------------------------------------------------
+// Seals the segment the tail appended to so far, it becomes a candidate for the garbage collection
+void ValueLog::startSegment(Tail& tail, bool wal)
+{
+   const u32 used = 0;
+   const PID sealed_pid = tail.pid;
+   tail.pid = writePage(reinterpret_cast<const u8*>(&used), sizeof(used), wal);
+   tail.used = 0;
+   bool drop = false;
+   {
+      std::unique_lock<std::mutex> guard(segments_mutex);
+      segments.try_emplace(tail.pid);
+      auto stats = segments.find(sealed_pid);
+      if (stats != segments.end()) {
+         stats->second.sealed = true;
+         if (stats->second.dead >= stats->second.used) {
+            segments.erase(stats);
+            drop = true;
+         }
+      }
+   }
+   if (drop) {
+      dropSegment(sealed_pid);
+   }
+}
+// -------------------------------------------------------------------------------------
+void ValueLog::read(const ValueLogPointer& pointer, utils::FunctionRef<void(const u8* value, u16 value_length)> callback)
+{
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<Segment> segment;
+         fixPage(segment, pointer.pid);
+         segment.toShared();
+         const auto& record = *reinterpret_cast<const Record*>(segment->data + pointer.offset);
+         callback(record.payload + record.key_length, record.value_length);
+         jumpmu_break;
+      }
+      jumpmuCatch() {}
+   }
+}
+// -------------------------------------------------------------------------------------
+void ValueLog::markDead(const ValueLogPointer& pointer)
+{
+   bool drop = false;
+   {
+      std::unique_lock<std::mutex> guard(segments_mutex);
+      auto stats = segments.find(pointer.pid);
+      if (stats == segments.end()) {
+         return;  // written before a restart
+      }
+      stats->second.dead += recordLength(pointer);
+      if (stats->second.sealed && !stats->second.collecting && stats->second.dead >= stats->second.used) {
+         segments.erase(stats);
+         drop = true;
+      }
+   }
+   if (drop) {
+      dropSegment(pointer.pid);
+   }
+}
+// -------------------------------------------------------------------------------------
+PID ValueLog::pickVictim()
+{
+   std::unique_lock<std::mutex> guard(segments_mutex);
+   PID victim = 0;
+   u32 victim_dead = 0;
+   for (auto& [pid, stats] : segments) {
+      if (stats.sealed && !stats.collecting && stats.dead > victim_dead && stats.dead * 100.0 >= stats.used * FLAGS_vlog_gc_dead_pct) {
+         victim = pid;
+         victim_dead = stats.dead;
+      }
+   }
+   if (victim != 0) {
+      segments[victim].collecting = true;
+   }
+   return victim;
+}
+// -------------------------------------------------------------------------------------
+u32 ValueLog::copySegment(PID pid, u8* dest)
+{
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<Segment> segment;
+         fixPage(segment, pid);
+         segment.toShared();
+         const u32 used = segment->used;
+         std::memcpy(dest, segment->data, used);
+         jumpmu_return used;
+      }
+      jumpmuCatch() {}
+   }
+}
+// -------------------------------------------------------------------------------------
+// Once relocated, the leaves point to the new copies of all live records of the victim
+void ValueLog::releaseVictim(PID pid, bool relocated)
+{
+   {
+      std::unique_lock<std::mutex> guard(segments_mutex);
+      if (relocated) {
+         segments.erase(pid);
+      } else {
+         segments[pid].collecting = false;
+      }
+   }
+   if (relocated) {
+      dropSegment(pid);
+   }
+}
+// -------------------------------------------------------------------------------------
+void ValueLog::dropSegment(PID pid)
+{
+   dropPage(pid);
+   COUNTERS_BLOCK()
+   {
+      WorkerCounters::myCounters().dt_vlog_segments_freed[dt_id]++;
+   }
+}
+// -------------------------------------------------------------------------------------
+// Towards the buffer manager a value log is a BLOB store, only the catalog tells them apart
+struct DTRegistry::DTMeta ValueLog::getMeta()
+{
+   return BlobStore::getMeta();
+}
+// -------------------------------------------------------------------------------------
+}  // namespace blob
+}  // namespace storage
+}  // namespace leanstore
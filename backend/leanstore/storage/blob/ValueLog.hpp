@@ -0,0 +1,105 @@
+#pragma once
+#include "BlobStore.hpp"
+#include "Units.hpp"
+#include "leanstore/KVInterface.hpp"
+#include "leanstore/utils/FunctionRef.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace blob
+{
+// -------------------------------------------------------------------------------------
+// What a tree with separated values keeps in its leaves instead of the value
+struct ValueLogPointer {
+   PID pid;
+   u32 offset;  // of the record in the segment
+   u16 key_length;
+   u16 value_length;
+   // -------------------------------------------------------------------------------------
+   static ValueLogPointer load(const u8* payload)
+   {
+      ValueLogPointer pointer;
+      std::memcpy(&pointer, payload, sizeof(ValueLogPointer));
+      return pointer;
+   }
+   Slice asSlice() const { return Slice(reinterpret_cast<const u8*>(this), sizeof(ValueLogPointer)); }
+   bool operator==(const ValueLogPointer& other) const { return pid == other.pid && offset == other.offset; }
+};
+static_assert(sizeof(ValueLogPointer) == 16, "");
+// -------------------------------------------------------------------------------------
+// Append-only log of the values of a B-Tree with Config::separate_values. Each worker appends to its own tail segment, a segment
+// being one page that is owned by the store like a BLOB page. Records carry their key, so the garbage collection of the tree
+// (BTreeLL::collectValueLog) can tell whether the leaf still points to a record before it moves the record to a new segment.
+// Readers must keep the leaf that holds the pointer latched while they read the record, nobody then frees the segment under them.
+// Segment statistics are kept in memory only, segments written before a restart are never collected
+class ValueLog : public BlobStore
+{
+  public:
+   struct Record {
+      u16 key_length;
+      u16 value_length;
+      u8 payload[];  // key | value
+   };
+   struct Segment {
+      u32 used;
+      u8 data[EFFECTIVE_PAGE_SIZE - sizeof(u32)];
+   };
+   static_assert(sizeof(Segment) <= EFFECTIVE_PAGE_SIZE, "");
+   struct WALAppend {
+      u32 offset;
+      u16 length;
+      u8 payload[];  // record
+   };
+   static constexpr u64 max_record_length = sizeof(Segment::data);
+   // -------------------------------------------------------------------------------------
+   ValueLog() : tails_count(FLAGS_worker_threads + 1), tails(std::make_unique<Tail[]>(tails_count)) {}
+   // -------------------------------------------------------------------------------------
+   // The caller ensures enough WAL space when wal is set
+   ValueLogPointer append(Slice key, Slice value, bool wal);
+   // Calls callback with the value while the segment is shared latched
+   void read(const ValueLogPointer& pointer, utils::FunctionRef<void(const u8* value, u16 value_length)> callback);
+   // Called once no leaf points to the record anymore, frees sealed segments that hold no live records
+   void markDead(const ValueLogPointer& pointer);
+   // -------------------------------------------------------------------------------------
+   // Sealed segment with the largest share of dead bytes above FLAGS_vlog_gc_dead_pct, 0 if there is none.
+   // The segment is excluded from markDead until releaseVictim
+   PID pickVictim();
+   // Copies the records of a victim to dest and returns their length
+   u32 copySegment(PID pid, u8* dest);
+   void releaseVictim(PID pid, bool relocated);
+   // -------------------------------------------------------------------------------------
+   static DTRegistry::DTMeta getMeta();
+
+  private:
+   struct alignas(64) Tail {
+      std::mutex mutex;
+      PID pid = 0;
+      u32 used = 0;
+   };
+   struct SegmentStats {
+      u32 used = 0;
+      u32 dead = 0;
+      bool sealed = false;
+      bool collecting = false;
+   };
+   u64 tails_count;
+   std::unique_ptr<Tail[]> tails;  // one per worker and one shared by all special workers
+   std::mutex segments_mutex;
+   std::unordered_map<PID, SegmentStats> segments;
+   // -------------------------------------------------------------------------------------
+   static u32 recordLength(const ValueLogPointer& pointer) { return sizeof(Record) + pointer.key_length + pointer.value_length; }
+   void startSegment(Tail& tail, bool wal);
+   void dropSegment(PID pid);
+};
+// -------------------------------------------------------------------------------------
+}  // namespace blob
+}  // namespace storage
+}  // namespace leanstore
@@ -0,0 +1,108 @@
+#include "BTreeFixed.hpp"
+
+#include "leanstore/storage/buffer-manager/BufferManager.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+using namespace std;
+using namespace leanstore::storage;
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace btree
+{
+// -------------------------------------------------------------------------------------
+struct DTRegistry::DTMeta BTreeFixedGeneric::getMeta()
+{
+   DTRegistry::DTMeta btree_meta = {.iterate_children = iterateChildrenSwips,
+                                    .find_parent = findParent,
+                                    .check_space_utilization = checkSpaceUtilization,
+                                    .checkpoint = checkpoint,
+                                    .undo = undo,
+                                    .todo = todo,
+                                    .unlock = unlock,
+                                    .serialize = serialize,
+                                    .deserialize = deserialize};
+   return btree_meta;
+}
+// -------------------------------------------------------------------------------------
+void BTreeFixedGeneric::iterateChildrenSwips(void* btree_object, BufferFrame& bf, std::function<bool(Swip<BufferFrame>&)> callback)
+{
+   reinterpret_cast<BTreeFixedGeneric*>(btree_object)->iterateChildren(bf, callback);
+}
+// -------------------------------------------------------------------------------------
+struct ParentSwipHandler BTreeFixedGeneric::findParent(void* btree_object, BufferFrame& to_find)
+{
+   return reinterpret_cast<BTreeFixedGeneric*>(btree_object)->findParentJump(to_find);
+}
+// -------------------------------------------------------------------------------------
+// Fixed-width nodes are not merged (yet)
+SpaceCheckResult BTreeFixedGeneric::checkSpaceUtilization(void*, BufferFrame&)
+{
+   return SpaceCheckResult::NOTHING;
+}
+// -------------------------------------------------------------------------------------
+void BTreeFixedGeneric::checkpoint(void* btree_object, BufferFrame& bf, u8* dest)
+{
+   reinterpret_cast<BTreeFixedGeneric*>(btree_object)->checkpointNode(bf, dest);
+}
+// -------------------------------------------------------------------------------------
+void BTreeFixedGeneric::undo(void*, const u8*, const u64)
+{
+   // TODO: undo for storage
+   TODOException();
+}
+// -------------------------------------------------------------------------------------
+void BTreeFixedGeneric::todo(void*, const u8*, const u64, const u64, const bool)
+{
+   UNREACHABLE();
+}
+// -------------------------------------------------------------------------------------
+void BTreeFixedGeneric::unlock(void*, const u8*)
+{
+   UNREACHABLE();
+}
+// -------------------------------------------------------------------------------------
+std::unordered_map<std::string, std::string> BTreeFixedGeneric::serialize(void* btree_object)
+{
+   auto& btree = *reinterpret_cast<BTreeFixedGeneric*>(btree_object);
+   assert(btree.meta_node_bf.asBufferFrame().page.dt_id == btree.dt_id);
+   return {{"dt_id", std::to_string(btree.dt_id)},
+           {"height", std::to_string(btree.height.load())},
+           {"meta_pid", std::to_string(btree.meta_node_bf.asBufferFrame().header.pid)}};
+}
+// -------------------------------------------------------------------------------------
+void BTreeFixedGeneric::deserialize(void* btree_object, std::unordered_map<std::string, std::string> map)
+{
+   auto& btree = *reinterpret_cast<BTreeFixedGeneric*>(btree_object);
+   btree.dt_id = std::stol(map["dt_id"]);
+   btree.height = std::stol(map["height"]);
+   btree.meta_node_bf.evict(std::stol(map["meta_pid"]));
+   HybridLatch dummy_latch;
+   Guard dummy_guard(&dummy_latch);
+   dummy_guard.toOptimisticSpin();
+   u16 failcounter = 0;
+   while (true) {
+      jumpmuTry()
+      {
+         btree.meta_node_bf = &BMC::global_bf->resolveSwip(dummy_guard, btree.meta_node_bf);
+         jumpmu_break;
+      }
+      jumpmuCatch()
+      {
+         failcounter++;
+         if (failcounter >= 200) {
+            cerr << "Failed to allocate MetaNode, Buffer might be to small" << endl;
+            assert(false);
+         }
+      }
+   }
+   btree.meta_node_bf.asBufferFrame().header.keep_in_memory = true;
+   assert(btree.meta_node_bf.asBufferFrame().page.dt_id == btree.dt_id);
+}
+// -------------------------------------------------------------------------------------
+}  // namespace btree
+}  // namespace storage
+}  // namespace leanstore
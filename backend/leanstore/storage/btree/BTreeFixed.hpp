@@ -0,0 +1,617 @@
+#pragma once
+#include "core/BTreeFixedNode.hpp"
+#include "core/BTreeGeneric.hpp"
+#include "leanstore/Config.hpp"
+#include "leanstore/KVInterface.hpp"
+#include "leanstore/concurrency-recovery/CRMG.hpp"
+#include "leanstore/profiling/counters/WorkerCounters.hpp"
+#include "leanstore/storage/buffer-manager/BufferManager.hpp"
+#include "leanstore/sync-primitives/PageGuard.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <type_traits>
+// -------------------------------------------------------------------------------------
+using namespace leanstore::storage;
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace btree
+{
+// -------------------------------------------------------------------------------------
+// Type-erased part of BTreeFixed, the DTRegistry callbacks only see this one
+class BTreeFixedGeneric
+{
+  public:
+   using Config = BTreeGeneric::Config;
+   // -------------------------------------------------------------------------------------
+   Swip<BufferFrame> meta_node_bf;  // kept in memory
+   atomic<u64> height = 1;
+   DTID dt_id;
+   Config config;
+   // -------------------------------------------------------------------------------------
+   BTreeFixedGeneric() = default;
+   virtual ~BTreeFixedGeneric() = default;
+   // -------------------------------------------------------------------------------------
+   virtual void iterateChildren(BufferFrame& bf, std::function<bool(Swip<BufferFrame>&)> callback) = 0;
+   virtual ParentSwipHandler findParentJump(BufferFrame& to_find) = 0;
+   virtual void checkpointNode(BufferFrame& bf, u8* dest) = 0;
+   // -------------------------------------------------------------------------------------
+   static void iterateChildrenSwips(void* btree_object, BufferFrame& bf, std::function<bool(Swip<BufferFrame>&)> callback);
+   static ParentSwipHandler findParent(void* btree_object, BufferFrame& to_find);
+   static SpaceCheckResult checkSpaceUtilization(void* btree_object, BufferFrame& bf);
+   static void checkpoint(void* btree_object, BufferFrame& bf, u8* dest);
+   static void undo(void* btree_object, const u8* wal_entry_ptr, const u64 tts);
+   static void todo(void* btree_object, const u8* entry_ptr, const u64 version_worker_id, const u64 tx_id, const bool called_before);
+   static void unlock(void* btree_object, const u8* entry_ptr);
+   static std::unordered_map<std::string, std::string> serialize(void* btree_object);
+   static void deserialize(void* btree_object, std::unordered_map<std::string, std::string> serialized);
+   static DTRegistry::DTMeta getMeta();
+};
+// -------------------------------------------------------------------------------------
+// B-Tree specialized at compile time for integral keys and fixed-size values (see BTreeFixedNode).
+// Also implements KVInterface for big-endian folded keys of sizeof(KeyT) bytes and values of sizeof(ValueT) bytes
+template <typename KeyT, typename ValueT>
+class BTreeFixed : public KVInterface, public BTreeFixedGeneric
+{
+  public:
+   using Node = BTreeFixedNode<KeyT, ValueT>;
+   using UKey = std::make_unsigned_t<KeyT>;
+   // -------------------------------------------------------------------------------------
+   struct WALInsert : WALEntry {
+      KeyT key;
+      ValueT value;
+   };
+   struct WALAfterBeforeImage : WALEntry {
+      KeyT key;
+      ValueT before_image;
+      ValueT after_image;
+   };
+   struct WALRemove : WALEntry {
+      KeyT key;
+      ValueT value;
+   };
+   // -------------------------------------------------------------------------------------
+   BTreeFixed() = default;
+   // -------------------------------------------------------------------------------------
+   void create(DTID dtid, Config config)
+   {
+      this->dt_id = dtid;
+      this->config = config;
+      // -------------------------------------------------------------------------------------
+      meta_node_bf = &BMC::global_bf->allocatePage();
+      Guard guard(meta_node_bf.asBufferFrame().header.latch, GUARD_STATE::EXCLUSIVE);
+      meta_node_bf.asBufferFrame().header.keep_in_memory = true;
+      meta_node_bf.asBufferFrame().page.dt_id = dtid;
+      guard.unlock();
+      // -------------------------------------------------------------------------------------
+      auto root_write_guard_h = HybridPageGuard<Node>(dtid);
+      auto root_write_guard = ExclusivePageGuard<Node>(std::move(root_write_guard_h));
+      root_write_guard.init(true);
+      // -------------------------------------------------------------------------------------
+      HybridPageGuard<Node> meta_guard(meta_node_bf);
+      ExclusivePageGuard meta_page(std::move(meta_guard));
+      meta_page.init(false);
+      meta_page->upper = root_write_guard.bf();  // same trick as BTreeGeneric: the upper of the meta node points to the root
+      // -------------------------------------------------------------------------------------
+      root_write_guard.incrementGSN();
+      meta_page.incrementGSN();
+   }
+   // -------------------------------------------------------------------------------------
+   // Typed interface, callbacks are template parameters so that they are inlined
+   // -------------------------------------------------------------------------------------
+   template <typename Fn>
+   OP_RESULT lookup(KeyT key, Fn&& payload_callback)
+   {
+      while (true) {
+         jumpmuTry()
+         {
+            HybridPageGuard<Node> leaf;
+            findLeafCanJump(leaf, key);
+            const s16 pos = leaf->find(key);
+            if (pos != -1) {
+               payload_callback(leaf->values()[pos]);
+               leaf.recheck();
+               jumpmu_return OP_RESULT::OK;
+            } else {
+               leaf.recheck();
+               jumpmu_return OP_RESULT::NOT_FOUND;
+            }
+         }
+         jumpmuCatch() { WorkerCounters::myCounters().dt_restarts_read[dt_id]++; }
+      }
+      UNREACHABLE();
+      return OP_RESULT::OTHER;
+   }
+   // -------------------------------------------------------------------------------------
+   OP_RESULT insert(KeyT key, const ValueT& value)
+   {
+      cr::activeTX().markAsWrite();
+      if (config.enable_wal) {
+         cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+      }
+      while (true) {
+         jumpmuTry()
+         {
+            HybridPageGuard<Node> leaf;
+            findLeafCanJump<LATCH_FALLBACK_MODE::EXCLUSIVE>(leaf, key);
+            const bool is_full = leaf->isFull();
+            leaf.recheck();
+            if (is_full) {
+               BufferFrame* bf = leaf.bf;
+               leaf.unlock();
+               trySplit(*bf);
+               jumpmu_continue;
+            }
+            auto x_leaf = ExclusivePageGuard<Node>(std::move(leaf));
+            const u16 pos = x_leaf->lowerBound(key);
+            if (pos < x_leaf->count && x_leaf->keys()[pos] == key) {
+               jumpmu_return OP_RESULT::DUPLICATE;
+            }
+            x_leaf->insert(pos, key, value);
+            if (config.enable_wal) {
+               auto wal_entry = x_leaf.template reserveWALEntry<WALInsert>(0);
+               wal_entry->type = WAL_LOG_TYPE::WALInsert;
+               wal_entry->key = key;
+               std::memcpy(&wal_entry->value, &value, sizeof(ValueT));
+               wal_entry.submit();
+            } else {
+               x_leaf.markAsDirty();
+            }
+            jumpmu_return OP_RESULT::OK;
+         }
+         jumpmuCatch() { WorkerCounters::myCounters().dt_restarts_structural_change[dt_id]++; }
+      }
+      UNREACHABLE();
+      return OP_RESULT::OTHER;
+   }
+   // -------------------------------------------------------------------------------------
+   template <typename Fn>
+   OP_RESULT update(KeyT key, Fn&& callback)
+   {
+      cr::activeTX().markAsWrite();
+      if (config.enable_wal) {
+         cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+      }
+      while (true) {
+         jumpmuTry()
+         {
+            HybridPageGuard<Node> leaf;
+            findLeafCanJump<LATCH_FALLBACK_MODE::EXCLUSIVE>(leaf, key);
+            auto x_leaf = ExclusivePageGuard<Node>(std::move(leaf));
+            const s16 pos = x_leaf->find(key);
+            if (pos == -1) {
+               jumpmu_return OP_RESULT::NOT_FOUND;
+            }
+            ValueT& value = x_leaf->values()[pos];
+            if (config.enable_wal) {
+               auto wal_entry = x_leaf.template reserveWALEntry<WALAfterBeforeImage>(0);
+               wal_entry->type = WAL_LOG_TYPE::WALAfterBeforeImage;
+               wal_entry->key = key;
+               std::memcpy(&wal_entry->before_image, &value, sizeof(ValueT));
+               callback(value);
+               std::memcpy(&wal_entry->after_image, &value, sizeof(ValueT));
+               wal_entry.submit();
+            } else {
+               callback(value);
+               x_leaf.markAsDirty();
+            }
+            jumpmu_return OP_RESULT::OK;
+         }
+         jumpmuCatch() { WorkerCounters::myCounters().dt_restarts_update_same_size[dt_id]++; }
+      }
+      UNREACHABLE();
+      return OP_RESULT::OTHER;
+   }
+   // -------------------------------------------------------------------------------------
+   // Underfull leaves are not merged, the page stays in the tree until it is refilled
+   OP_RESULT remove(KeyT key)
+   {
+      cr::activeTX().markAsWrite();
+      if (config.enable_wal) {
+         cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+      }
+      while (true) {
+         jumpmuTry()
+         {
+            HybridPageGuard<Node> leaf;
+            findLeafCanJump<LATCH_FALLBACK_MODE::EXCLUSIVE>(leaf, key);
+            auto x_leaf = ExclusivePageGuard<Node>(std::move(leaf));
+            const s16 pos = x_leaf->find(key);
+            if (pos == -1) {
+               jumpmu_return OP_RESULT::NOT_FOUND;
+            }
+            if (config.enable_wal) {
+               auto wal_entry = x_leaf.template reserveWALEntry<WALRemove>(0);
+               wal_entry->type = WAL_LOG_TYPE::WALRemove;
+               wal_entry->key = key;
+               std::memcpy(&wal_entry->value, x_leaf->values() + pos, sizeof(ValueT));
+               wal_entry.submit();
+            } else {
+               x_leaf.markAsDirty();
+            }
+            x_leaf->remove(pos);
+            jumpmu_return OP_RESULT::OK;
+         }
+         jumpmuCatch() { WorkerCounters::myCounters().dt_restarts_structural_change[dt_id]++; }
+      }
+      UNREACHABLE();
+      return OP_RESULT::OTHER;
+   }
+   // -------------------------------------------------------------------------------------
+   // The callback runs under a shared latch, a restart resumes behind the last leaf that was completely scanned
+   template <typename Fn>
+   OP_RESULT scanAsc(KeyT start_key, Fn&& callback)
+   {
+      KeyT next_key = start_key;
+      while (true) {
+         jumpmuTry()
+         {
+            HybridPageGuard<Node> leaf;
+            findLeafCanJump(leaf, next_key);
+            leaf.toShared();
+            for (u16 pos = leaf->lowerBound(next_key); pos < leaf->count; pos++) {
+               if (!callback(leaf->keys()[pos], leaf->values()[pos])) {
+                  jumpmu_return OP_RESULT::OK;
+               }
+            }
+            if (leaf->upper_fence_infinity) {
+               jumpmu_return OP_RESULT::OK;
+            }
+            next_key = leaf->upper_fence + 1;
+         }
+         jumpmuCatch() { WorkerCounters::myCounters().dt_restarts_read[dt_id]++; }
+      }
+      UNREACHABLE();
+      return OP_RESULT::OTHER;
+   }
+   // -------------------------------------------------------------------------------------
+   template <typename Fn>
+   OP_RESULT scanDesc(KeyT start_key, Fn&& callback)
+   {
+      KeyT next_key = start_key;
+      while (true) {
+         jumpmuTry()
+         {
+            HybridPageGuard<Node> leaf;
+            findLeafCanJump(leaf, next_key);
+            leaf.toShared();
+            const u16 pos = leaf->lowerBound(next_key);
+            const u16 end = (pos < leaf->count && leaf->keys()[pos] == next_key) ? pos + 1 : pos;
+            for (u16 i = end; i > 0; i--) {
+               if (!callback(leaf->keys()[i - 1], leaf->values()[i - 1])) {
+                  jumpmu_return OP_RESULT::OK;
+               }
+            }
+            if (leaf->lower_fence_infinity) {
+               jumpmu_return OP_RESULT::OK;
+            }
+            next_key = leaf->lower_fence;
+         }
+         jumpmuCatch() { WorkerCounters::myCounters().dt_restarts_read[dt_id]++; }
+      }
+      UNREACHABLE();
+      return OP_RESULT::OTHER;
+   }
+   // -------------------------------------------------------------------------------------
+   // KVInterface
+   // -------------------------------------------------------------------------------------
+   static constexpr UKey sign_bit = std::is_signed_v<KeyT> ? UKey(1) << (sizeof(KeyT) * 8 - 1) : UKey(0);
+   static UKey swapBytes(UKey key)
+   {
+      if constexpr (sizeof(UKey) == 8) {
+         return __builtin_bswap64(key);
+      } else if constexpr (sizeof(UKey) == 4) {
+         return __builtin_bswap32(key);
+      } else if constexpr (sizeof(UKey) == 2) {
+         return __builtin_bswap16(key);
+      } else {
+         return key;
+      }
+   }
+   // Same encoding as the fold() helpers of the frontends
+   static void foldKey(u8* dest, KeyT key)
+   {
+      const UKey folded = swapBytes(static_cast<UKey>(key) ^ sign_bit);
+      std::memcpy(dest, &folded, sizeof(UKey));
+   }
+   static KeyT unfoldKey(const u8* src)
+   {
+      UKey folded;
+      std::memcpy(&folded, src, sizeof(UKey));
+      return static_cast<KeyT>(swapBytes(folded) ^ sign_bit);
+   }
+   // -------------------------------------------------------------------------------------
+   virtual OP_RESULT lookup(u8* key, u16 key_length, LookupCallback payload_callback) override
+   {
+      ensure(key_length == sizeof(KeyT));
+      return lookup(unfoldKey(key), [&](const ValueT& value) { payload_callback(reinterpret_cast<const u8*>(&value), sizeof(ValueT)); });
+   }
+   virtual OP_RESULT insert(u8* key, u16 key_length, u8* value, u16 value_length) override
+   {
+      ensure(key_length == sizeof(KeyT) && value_length == sizeof(ValueT));
+      return insert(unfoldKey(key), *reinterpret_cast<const ValueT*>(value));
+   }
+   // The WAL entry always carries full before and after images, the descriptor is not needed for fixed-size values
+   virtual OP_RESULT updateSameSizeInPlace(u8* key, u16 key_length, UpdateCallback callback, UpdateSameSizeInPlaceDescriptor&) override
+   {
+      ensure(key_length == sizeof(KeyT));
+      return update(unfoldKey(key), [&](ValueT& value) { callback(reinterpret_cast<u8*>(&value), sizeof(ValueT)); });
+   }
+   virtual OP_RESULT remove(u8* key, u16 key_length) override
+   {
+      ensure(key_length == sizeof(KeyT));
+      return remove(unfoldKey(key));
+   }
+   virtual OP_RESULT scanAsc(u8* start_key, u16 key_length, ScanCallback callback, std::function<void()>) override
+   {
+      ensure(key_length == sizeof(KeyT));
+      u8 folded_key[sizeof(KeyT)];
+      return scanAsc(unfoldKey(start_key), [&](KeyT key, const ValueT& value) {
+         foldKey(folded_key, key);
+         return callback(folded_key, sizeof(KeyT), reinterpret_cast<const u8*>(&value), sizeof(ValueT));
+      });
+   }
+   virtual OP_RESULT scanDesc(u8* start_key, u16 key_length, ScanCallback callback, std::function<void()>) override
+   {
+      ensure(key_length == sizeof(KeyT));
+      u8 folded_key[sizeof(KeyT)];
+      return scanDesc(unfoldKey(start_key), [&](KeyT key, const ValueT& value) {
+         foldKey(folded_key, key);
+         return callback(folded_key, sizeof(KeyT), reinterpret_cast<const u8*>(&value), sizeof(ValueT));
+      });
+   }
+   // -------------------------------------------------------------------------------------
+   virtual u64 countPages() override
+   {
+      return iterateAllPages([](Node&) { return 1; }, [](Node&) { return 1; });
+   }
+   virtual u64 countEntries() override
+   {
+      return iterateAllPages([](Node&) { return 0; }, [](Node& leaf) { return leaf.count; });
+   }
+   virtual u64 getHeight() override { return height.load(); }
+   // -------------------------------------------------------------------------------------
+   // Buffer manager callbacks
+   // -------------------------------------------------------------------------------------
+   virtual void iterateChildren(BufferFrame& bf, std::function<bool(Swip<BufferFrame>&)> callback) override
+   {
+      // Pre: bf is read locked
+      auto& c_node = *reinterpret_cast<Node*>(bf.page.dt);
+      if (c_node.is_leaf) {
+         return;
+      }
+      for (u16 i = 0; i < c_node.count; i++) {
+         if (!callback(c_node.children()[i].template cast<BufferFrame>())) {
+            return;
+         }
+      }
+      callback(c_node.upper.template cast<BufferFrame>());
+   }
+   // -------------------------------------------------------------------------------------
+   virtual ParentSwipHandler findParentJump(BufferFrame& to_find) override { return findParent<true>(to_find); }
+   // -------------------------------------------------------------------------------------
+   // pre: source buffer frame is shared latched
+   virtual void checkpointNode(BufferFrame& bf, u8* dest) override
+   {
+      std::memcpy(dest, bf.page.dt, EFFECTIVE_PAGE_SIZE);
+      auto& dest_node = *reinterpret_cast<Node*>(dest);
+      if (dest_node.is_leaf) {
+         return;
+      }
+      for (u16 i = 0; i <= dest_node.count; i++) {
+         auto& child = dest_node.getChild(i);
+         if (!child.isEVICTED()) {
+            child.evict(child.asBufferFrameMasked().header.pid);
+         }
+      }
+   }
+   // -------------------------------------------------------------------------------------
+   // Helpers
+   // -------------------------------------------------------------------------------------
+   template <LATCH_FALLBACK_MODE mode = LATCH_FALLBACK_MODE::SHARED>
+   inline void findLeafCanJump(HybridPageGuard<Node>& target_guard, KeyT key)
+   {
+      target_guard.unlock();
+      HybridPageGuard<Node> p_guard(meta_node_bf);
+      target_guard = HybridPageGuard<Node>(p_guard, p_guard->upper);
+      // -------------------------------------------------------------------------------------
+      u16 volatile level = 0;
+      // -------------------------------------------------------------------------------------
+      while (!target_guard->is_leaf) {
+         WorkerCounters::myCounters().dt_inner_page[dt_id]++;
+         Swip<Node>& c_swip = target_guard->lookupInner(key);
+         p_guard = std::move(target_guard);
+         if (level == height - 1) {
+            target_guard = HybridPageGuard(p_guard, c_swip, mode);
+         } else {
+            target_guard = HybridPageGuard(p_guard, c_swip);
+         }
+         level = level + 1;
+      }
+      // -------------------------------------------------------------------------------------
+      p_guard.unlock();
+   }
+   // -------------------------------------------------------------------------------------
+   // Same protocol as BTreeGeneric::findParent, the parent is found by descending with the upper fence of to_find
+   template <bool jumpIfEvicted = true>
+   ParentSwipHandler findParent(BufferFrame& to_find)
+   {
+      COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_find_parent[dt_id]++; }
+      auto& c_node = *reinterpret_cast<Node*>(to_find.page.dt);
+      HybridPageGuard<Node> p_guard(meta_node_bf);
+      Swip<Node>* c_swip = &p_guard->upper;
+      if (dt_id != to_find.page.dt_id || p_guard->upper.isEVICTED()) {
+         // Wrong Tree or Root is evicted
+         jumpmu::jump();
+      }
+      // -------------------------------------------------------------------------------------
+      const bool infinity = c_node.upper_fence_infinity;
+      const KeyT key = c_node.upper_fence;
+      // -------------------------------------------------------------------------------------
+      if (&c_swip->asBufferFrameMasked() == &to_find) {
+         p_guard.recheck();
+         COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_find_parent_root[dt_id]++; }
+         return {.swip = c_swip->template cast<BufferFrame>(), .parent_guard = std::move(p_guard.guard), .parent_bf = &meta_node_bf.asBufferFrame()};
+      }
+      if (p_guard->upper.isCOOL()) {
+         // Root is cool => every node below is evicted
+         jumpmu::jump();
+      }
+      // -------------------------------------------------------------------------------------
+      HybridPageGuard<Node> c_guard(p_guard, p_guard->upper, LATCH_FALLBACK_MODE::JUMP);
+      s16 pos = -1;
+      auto search_condition = [&](HybridPageGuard<Node>& guard) {
+         pos = infinity ? guard->count : guard->lowerBound(key);
+         c_swip = &guard->getChild(pos);
+         return (&c_swip->asBufferFrameMasked() != &to_find);
+      };
+      while (!c_guard->is_leaf && search_condition(c_guard)) {
+         p_guard = std::move(c_guard);
+         if constexpr (jumpIfEvicted) {
+            if (c_swip->isEVICTED()) {
+               jumpmu::jump();
+            }
+         }
+         c_guard = HybridPageGuard(p_guard, *c_swip, LATCH_FALLBACK_MODE::JUMP);
+      }
+      p_guard.unlock();
+      const bool found = &c_swip->asBufferFrameMasked() == &to_find;
+      c_guard.recheck();
+      if (!found) {
+         jumpmu::jump();
+      }
+      COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_find_parent_slow[dt_id]++; }
+      return {.swip = c_swip->template cast<BufferFrame>(), .parent_guard = std::move(c_guard.guard), .parent_bf = c_guard.bf, .pos = pos};
+   }
+   // -------------------------------------------------------------------------------------
+   // Mirrors BTreeGeneric::trySplit including its WAL records
+   void trySplit(BufferFrame& to_split)
+   {
+      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+      auto parent_handler = findParent<false>(to_split);
+      HybridPageGuard<Node> p_guard = parent_handler.template getParentReadPageGuard<Node>();
+      HybridPageGuard<Node> c_guard = HybridPageGuard(p_guard, parent_handler.swip.template cast<Node>());
+      if (c_guard->count <= 2)
+         return;
+      const u16 sep_pos = config.use_bulk_insert ? c_guard->count - 2 : c_guard->count / 2;
+      // -------------------------------------------------------------------------------------
+      auto logSplit = [&](ExclusivePageGuard<Node>& parent, ExclusivePageGuard<Node>& new_left, ExclusivePageGuard<Node>& right, auto exec) {
+         if (!config.enable_wal) {
+            exec();
+            return;
+         }
+         auto new_left_init_wal = new_left.template reserveWALEntry<WALInitPage>(0);
+         new_left_init_wal->type = WAL_LOG_TYPE::WALInitPage;
+         new_left_init_wal->dt_id = dt_id;
+         new_left_init_wal.submit();
+         // -------------------------------------------------------------------------------------
+         WALLogicalSplit logical_split_entry;
+         logical_split_entry.type = WAL_LOG_TYPE::WALLogicalSplit;
+         logical_split_entry.right_pid = right.bf()->header.pid;
+         logical_split_entry.parent_pid = parent.bf()->header.pid;
+         logical_split_entry.left_pid = new_left.bf()->header.pid;
+         // -------------------------------------------------------------------------------------
+         auto current_right_wal = right.template reserveWALEntry<WALLogicalSplit>(0);
+         *current_right_wal = logical_split_entry;
+         current_right_wal.submit();
+         // -------------------------------------------------------------------------------------
+         exec();
+         // -------------------------------------------------------------------------------------
+         auto parent_wal = parent.template reserveWALEntry<WALLogicalSplit>(0);
+         *parent_wal = logical_split_entry;
+         parent_wal.submit();
+         auto left_wal = new_left.template reserveWALEntry<WALLogicalSplit>(0);
+         *left_wal = logical_split_entry;
+         left_wal.submit();
+      };
+      auto touch = [&](ExclusivePageGuard<Node>& guard) {
+         if (config.enable_wal) {
+            guard.incrementGSN();
+         } else {
+            guard.markAsDirty();
+         }
+      };
+      // -------------------------------------------------------------------------------------
+      if (p_guard.bf == &meta_node_bf.asBufferFrame()) {  // root split
+         auto p_x_guard = ExclusivePageGuard(std::move(p_guard));
+         auto c_x_guard = ExclusivePageGuard(std::move(c_guard));
+         assert(height == 1 || !c_x_guard->is_leaf);
+         // -------------------------------------------------------------------------------------
+         auto new_root_h = HybridPageGuard<Node>(dt_id, false);
+         auto new_root = ExclusivePageGuard<Node>(std::move(new_root_h));
+         auto new_left_node_h = HybridPageGuard<Node>(dt_id);
+         auto new_left_node = ExclusivePageGuard<Node>(std::move(new_left_node_h));
+         touch(new_root);
+         touch(new_left_node);
+         touch(c_x_guard);
+         if (config.enable_wal) {
+            auto new_root_init_wal = new_root.template reserveWALEntry<WALInitPage>(0);
+            new_root_init_wal->type = WAL_LOG_TYPE::WALInitPage;
+            new_root_init_wal->dt_id = dt_id;
+            new_root_init_wal.submit();
+         }
+         logSplit(new_root, new_left_node, c_x_guard, [&]() {
+            new_root.keepAlive();
+            new_root.init(false);
+            new_root->upper = c_x_guard.bf();
+            p_x_guard->upper = new_root.bf();
+            new_left_node.init(c_x_guard->is_leaf);
+            c_x_guard->split(new_root.ref(), new_left_node.ref(), new_left_node.bf(), sep_pos);
+         });
+         height++;
+         COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_split[dt_id]++; }
+      } else if (!p_guard->isFull()) {
+         auto p_x_guard = ExclusivePageGuard(std::move(p_guard));
+         auto c_x_guard = ExclusivePageGuard(std::move(c_guard));
+         assert(!p_x_guard->is_leaf);
+         // -------------------------------------------------------------------------------------
+         auto new_left_node_h = HybridPageGuard<Node>(dt_id);
+         auto new_left_node = ExclusivePageGuard<Node>(std::move(new_left_node_h));
+         touch(p_x_guard);
+         touch(new_left_node);
+         touch(c_x_guard);
+         logSplit(p_x_guard, new_left_node, c_x_guard, [&]() {
+            new_left_node.init(c_x_guard->is_leaf);
+            c_x_guard->split(p_x_guard.ref(), new_left_node.ref(), new_left_node.bf(), sep_pos);
+         });
+         COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_split[dt_id]++; }
+      } else {
+         p_guard.unlock();
+         c_guard.unlock();
+         trySplit(*p_guard.bf);  // Must split parent head to make space for separator
+      }
+   }
+   // -------------------------------------------------------------------------------------
+   s64 iterateAllPagesRec(HybridPageGuard<Node>& node_guard, std::function<s64(Node&)> inner, std::function<s64(Node&)> leaf)
+   {
+      if (node_guard->is_leaf) {
+         return leaf(node_guard.ref());
+      }
+      s64 res = inner(node_guard.ref());
+      for (u16 i = 0; i <= node_guard->count; i++) {
+         auto c_guard = HybridPageGuard(node_guard, node_guard->getChild(i));
+         c_guard.recheck();
+         res += iterateAllPagesRec(c_guard, inner, leaf);
+      }
+      return res;
+   }
+   s64 iterateAllPages(std::function<s64(Node&)> inner, std::function<s64(Node&)> leaf)
+   {
+      while (true) {
+         jumpmuTry()
+         {
+            HybridPageGuard<Node> p_guard(meta_node_bf);
+            HybridPageGuard<Node> c_guard(p_guard, p_guard->upper);
+            s64 result = iterateAllPagesRec(c_guard, inner, leaf);
+            jumpmu_return result;
+         }
+         jumpmuCatch() {}
+      }
+   }
+};
+// -------------------------------------------------------------------------------------
+}  // namespace btree
+}  // namespace storage
+}  // namespace leanstore
@@ -5,7 +5,6 @@
 // -------------------------------------------------------------------------------------
 #include "gflags/gflags.h"
 // -------------------------------------------------------------------------------------
-#include <signal.h>
 // -------------------------------------------------------------------------------------
 using namespace std;
 using namespace leanstore::storage;
@@ -17,42 +16,9 @@ namespace storage
 namespace btree
 {
 // -------------------------------------------------------------------------------------
-OP_RESULT BTreeLL::lookup(u8* key, u16 key_length, function<void(const u8*, u16)> payload_callback)
+OP_RESULT BTreeLL::lookup(u8* key, u16 key_length, LookupCallback payload_callback)
 {
-   while (true) {
-      jumpmuTry()
-      {
-         HybridPageGuard<BTreeNode> leaf;
-         findLeafCanJump(leaf, key, key_length);
-         // -------------------------------------------------------------------------------------
-         DEBUG_BLOCK()
-         {
-            s16 sanity_check_result = leaf->compareKeyWithBoundaries(key, key_length);
-            leaf.recheck();
-            if (sanity_check_result != 0) {
-               cout << leaf->count << endl;
-            }
-            ensure(sanity_check_result == 0);
-         }
-         // -------------------------------------------------------------------------------------
-         s16 pos = leaf->lowerBound<true>(key, key_length);
-         if (pos != -1) {
-            payload_callback(leaf->getPayload(pos), leaf->getPayloadLength(pos));
-            leaf.recheck();
-            jumpmu_return OP_RESULT::OK;
-         } else {
-            leaf.recheck();
-            raise(SIGTRAP);
-            jumpmu_return OP_RESULT::NOT_FOUND;
-         }
-      }
-      jumpmuCatch()
-      {
-         WorkerCounters::myCounters().dt_restarts_read[dt_id]++;
-      }
-   }
-   UNREACHABLE();
-   return OP_RESULT::OTHER;
+   return lookup<LookupCallback&>(key, key_length, payload_callback);
 }
 // -------------------------------------------------------------------------------------
 bool BTreeLL::isRangeSurelyEmpty(Slice start_key, Slice end_key)
@@ -86,80 +52,150 @@ bool BTreeLL::isRangeSurelyEmpty(Slice start_key, Slice end_key)
    return false;
 }
 // -------------------------------------------------------------------------------------
-OP_RESULT BTreeLL::scanAsc(u8* start_key,
-                           u16 key_length,
-                           std::function<bool(const u8* key, u16 key_length, const u8* payload, u16 payload_length)> callback,
-                           function<void()>)
+bool BTreeLL::compactionStep(std::string& cursor)
 {
-   COUNTERS_BLOCK()
-   {
-      WorkerCounters::myCounters().dt_scan_asc[dt_id]++;
+   BufferFrame* bf;
+   bool last_leaf;
+   u16 upper_fence_length;
+   u8 upper_fence[EFFECTIVE_PAGE_SIZE];
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<BTreeNode> leaf;
+         findLeafCanJump(leaf, reinterpret_cast<const u8*>(cursor.data()), cursor.length());
+         bf = leaf.bf;
+         last_leaf = leaf->upper_fence.offset == 0;
+         upper_fence_length = leaf->upper_fence.length;
+         std::memcpy(upper_fence, leaf->getUpperFenceKey(), std::min<u16>(upper_fence_length, EFFECTIVE_PAGE_SIZE));
+         leaf.recheck();
+         jumpmu_break;
+      }
+      jumpmuCatch() {}
    }
-   Slice key(start_key, key_length);
+   // -------------------------------------------------------------------------------------
+   // The leaf may have been changed or evicted meanwhile, both end in a jump
    jumpmuTry()
    {
-      BTreeSharedIterator iterator(*static_cast<BTreeGeneric*>(this));
-      OP_RESULT ret = iterator.seek(key);
-      while (ret == OP_RESULT::OK) {
-         iterator.assembleKey();
-         auto key = iterator.key();
-         auto value = iterator.value();
-         if (!callback(key.data(), key.length(), value.data(), value.length())) {
-            break;
+      SpaceCheckResult ret = compactLeaf(*bf);
+      if (ret == SpaceCheckResult::NOTHING) {
+         // XMerge only merges with hot right siblings, tryMerge also loads the neighbours and merges underfull parents
+         if (tryMerge(*bf, true)) {
+            ret = SpaceCheckResult::PICK_ANOTHER_BF;
          }
-         ret = iterator.next();
       }
-      jumpmu_return OP_RESULT::OK;
+      COUNTERS_BLOCK()
+      {
+         WorkerCounters::myCounters().dt_compaction_merges[dt_id] += (ret != SpaceCheckResult::NOTHING);
+      }
    }
    jumpmuCatch() {}
-   UNREACHABLE();
-   return OP_RESULT::OTHER;
-}
-// -------------------------------------------------------------------------------------
-OP_RESULT BTreeLL::scanDesc(u8* start_key, u16 key_length, std::function<bool(const u8*, u16, const u8*, u16)> callback, function<void()>)
-{
    COUNTERS_BLOCK()
    {
-      WorkerCounters::myCounters().dt_scan_desc[dt_id]++;
+      WorkerCounters::myCounters().dt_compaction_leaves[dt_id]++;
    }
-   const Slice key(start_key, key_length);
-   jumpmuTry()
-   {
-      BTreeSharedIterator iterator(*static_cast<BTreeGeneric*>(this));
-      auto ret = iterator.seekForPrev(key);
-      if (ret != OP_RESULT::OK) {
-         jumpmu_return ret;
+   // -------------------------------------------------------------------------------------
+   if (last_leaf) {
+      cursor.clear();
+      while (tryShrinkHeight()) {
+         COUNTERS_BLOCK()
+         {
+            WorkerCounters::myCounters().dt_compaction_shrinks[dt_id]++;
+         }
       }
-      while (true) {
-         iterator.assembleKey();
-         auto key = iterator.key();
-         auto value = iterator.value();
-         if (!callback(key.data(), key.length(), value.data(), value.length())) {
-            jumpmu_return OP_RESULT::OK;
-         } else {
-            if (iterator.prev() != OP_RESULT::OK) {
-               jumpmu_return OP_RESULT::NOT_FOUND;
-            }
+      COUNTERS_BLOCK()
+      {
+         WorkerCounters::myCounters().dt_compaction_passes[dt_id]++;
+      }
+      return true;
+   }
+   // The smallest key behind the upper fence, which is the largest key the leaf may hold
+   cursor.assign(reinterpret_cast<const char*>(upper_fence), upper_fence_length);
+   cursor.push_back('\0');
+   return false;
+}
+// -------------------------------------------------------------------------------------
+// A record is live while the leaf of its key points to it. The copy is appended and the pointer swapped under the exclusive
+// leaf latch, so readers that still see the old pointer keep the victim alive until they are done. Like the merges of the
+// compaction, relocations are not logged
+bool BTreeLL::collectValueLog()
+{
+   if (value_log == nullptr) {
+      return false;
+   }
+   const PID victim = value_log->pickVictim();
+   if (victim == 0) {
+      return false;
+   }
+   u8 records[blob::ValueLog::max_record_length];
+   const u32 used = value_log->copySegment(victim, records);
+   bool relocated = true;
+   for (u32 offset = 0; offset < used;) {
+      const auto& record = *reinterpret_cast<const blob::ValueLog::Record*>(records + offset);
+      const Slice key(record.payload, record.key_length);
+      const Slice value(record.payload + record.key_length, record.value_length);
+      blob::ValueLogPointer old_pointer;
+      old_pointer.pid = victim;
+      old_pointer.offset = offset;
+      offset += sizeof(blob::ValueLog::Record) + record.key_length + record.value_length;
+      jumpmuTry()
+      {
+         BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
+         if (iterator.seekExact(key) != OP_RESULT::OK || !(blob::ValueLogPointer::load(iterator.value().data()) == old_pointer)) {
+            jumpmu_continue;  // removed or overwritten since
+         }
+         const auto new_pointer = value_log->append(key, value, false);
+         std::memcpy(iterator.mutableValue().data(), &new_pointer, sizeof(new_pointer));
+         iterator.markAsDirty();
+         COUNTERS_BLOCK()
+         {
+            WorkerCounters::myCounters().dt_vlog_relocated[value_log->dt_id]++;
          }
       }
+      jumpmuCatch()
+      {
+         relocated = false;
+      }
    }
-   jumpmuCatch() {}
-   UNREACHABLE();
-   return OP_RESULT::OTHER;
+   value_log->releaseVictim(victim, relocated);
+   return true;
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeLL::scanAsc(u8* start_key, u16 key_length, ScanCallback callback, function<void()>)
+{
+   return scanAsc<ScanCallback&>(start_key, key_length, callback);
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeLL::scanDesc(u8* start_key, u16 key_length, ScanCallback callback, function<void()>)
+{
+   return scanDesc<ScanCallback&>(start_key, key_length, callback);
 }
 // -------------------------------------------------------------------------------------
 OP_RESULT BTreeLL::insert(u8* o_key, u16 o_key_length, u8* o_value, u16 o_value_length)
 {
+   foldPendingMerges(Slice(o_key, o_key_length));
    cr::activeTX().markAsWrite();
    if (config.enable_wal) {
-      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * (value_log ? 2 : 1));
    }
    const Slice key(o_key, o_key_length);
-   const Slice value(o_value, o_value_length);
+   Slice value(o_value, o_value_length);
+   blob::ValueLogPointer pointer;
+   if (value_log != nullptr) {
+      // The value goes to the log first, the leaf only gets the pointer
+      pointer = value_log->append(key, value, config.enable_wal);
+      value = pointer.asSlice();
+   }
    jumpmuTry()
    {
       BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
       OP_RESULT ret = iterator.insertKV(key, value);
+      if (ret == OP_RESULT::DUPLICATE) {
+         // Also when folding the pending operands of the key created it
+         if (value_log != nullptr) {
+            value_log->markDead(pointer);
+         }
+         jumpmu_return ret;
+      }
       ensure(ret == OP_RESULT::OK);
       if (config.enable_wal) {
          auto wal_entry = iterator.leaf.reserveWALEntry<WALInsert>(key.length() + value.length());
@@ -181,16 +217,21 @@ OP_RESULT BTreeLL::insert(u8* o_key, u16 o_key_length, u8* o_value, u16 o_value_
 // -------------------------------------------------------------------------------------
 OP_RESULT BTreeLL::prefixLookup(u8* key, u16 key_length, std::function<void(const u8*, u16, const u8*, u16)> payload_callback)
 {
+   foldPendingMerges();
    while (true) {
       jumpmuTry()
       {
          HybridPageGuard<BTreeNode> leaf;
          findLeafCanJump(leaf, key, key_length);
+         if (value_log != nullptr) {
+            leaf.toShared();
+         }
          // -------------------------------------------------------------------------------------
          bool is_equal = false;
          s16 cur = leaf->lowerBound<false>(key, key_length, &is_equal);
          if (is_equal == true) {
-            payload_callback(key, key_length, leaf->getPayload(cur), leaf->getPayloadLength(cur));
+            resolveValue(Slice(leaf->getPayload(cur), leaf->getPayloadLength(cur)),
+                         [&](const u8* value, u16 value_length) { payload_callback(key, key_length, value, value_length); });
             leaf.recheck();
             jumpmu_return OP_RESULT::OK;
          } else if (cur < leaf->count) {
@@ -204,7 +245,9 @@ OP_RESULT BTreeLL::prefixLookup(u8* key, u16 key_length, std::function<void(cons
             const u8* s_payload = leaf->getPayload(cur);
             const u16 s_payload_length = leaf->getPayloadLength(cur);
             leaf.recheck();
-            payload_callback(compiled_key, compiled_key_length, s_payload, s_payload_length);
+            resolveValue(Slice(s_payload, s_payload_length), [&](const u8* value, u16 value_length) {
+               payload_callback(compiled_key, compiled_key_length, value, value_length);
+            });
             leaf.recheck();
             jumpmu_return OP_RESULT::OK;
          } else {
@@ -229,16 +272,21 @@ OP_RESULT BTreeLL::prefixLookup(u8* key, u16 key_length, std::function<void(cons
 // -------------------------------------------------------------------------------------
 OP_RESULT BTreeLL::prefixLookupForPrev(u8* key, u16 key_length, std::function<void(const u8*, u16, const u8*, u16)> payload_callback)
 {
+   foldPendingMerges();
    while (true) {
       jumpmuTry()
       {
          HybridPageGuard<BTreeNode> leaf;
          findLeafCanJump(leaf, key, key_length);
+         if (value_log != nullptr) {
+            leaf.toShared();
+         }
          // -------------------------------------------------------------------------------------
          bool is_equal = false;
          s16 cur = leaf->lowerBound<false>(key, key_length, &is_equal);
          if (is_equal == true) {
-            payload_callback(key, key_length, leaf->getPayload(cur), leaf->getPayloadLength(cur));
+            resolveValue(Slice(leaf->getPayload(cur), leaf->getPayloadLength(cur)),
+                         [&](const u8* value, u16 value_length) { payload_callback(key, key_length, value, value_length); });
             leaf.recheck();
             jumpmu_return OP_RESULT::OK;
          } else if (cur > 0) {
@@ -253,7 +301,9 @@ OP_RESULT BTreeLL::prefixLookupForPrev(u8* key, u16 key_length, std::function<vo
             const u8* s_payload = leaf->getPayload(cur);
             const u16 s_payload_length = leaf->getPayloadLength(cur);
             leaf.recheck();
-            payload_callback(compiled_key, compiled_key_length, s_payload, s_payload_length);
+            resolveValue(Slice(s_payload, s_payload_length), [&](const u8* value, u16 value_length) {
+               payload_callback(compiled_key, compiled_key_length, value, value_length);
+            });
             leaf.recheck();
             jumpmu_return OP_RESULT::OK;
          } else {
@@ -286,6 +336,21 @@ OP_RESULT BTreeLL::append(std::function<void(u8*)> o_key,
       BufferFrame* bf;
    };
    // -------------------------------------------------------------------------------------
+   if (value_log != nullptr) {
+      // The log record needs the key and the value up front
+      u8 key_buffer[o_key_length];
+      o_key(key_buffer);
+      u8 value_buffer[o_value_length];
+      o_value(value_buffer);
+      return insert(key_buffer, o_key_length, value_buffer, o_value_length);
+   }
+   // The key is only generated in the leaf, unless operands may be pending for it
+   BTreeMergeBuffer* buffer = merge_buffer.load(std::memory_order_acquire);
+   if (buffer != nullptr && !buffer->empty()) {
+      u8 key_buffer[o_key_length];
+      o_key(key_buffer);
+      foldPendingMerges(Slice(key_buffer, o_key_length));
+   }
    if (session_ptr.get()) {
       auto session = reinterpret_cast<Session*>(session_ptr.get());
       jumpmuTry()
@@ -361,12 +426,13 @@ OP_RESULT BTreeLL::append(std::function<void(u8*)> o_key,
 // -------------------------------------------------------------------------------------
 OP_RESULT BTreeLL::updateSameSizeInPlace(u8* o_key,
                                          u16 o_key_length,
-                                         function<void(u8* payload, u16 payload_size)> callback,
+                                         UpdateCallback callback,
                                          UpdateSameSizeInPlaceDescriptor& update_descriptor)
 {
+   foldPendingMerges(Slice(o_key, o_key_length));
    cr::activeTX().markAsWrite();
    if (config.enable_wal) {
-      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * (value_log ? 2 : 1));
    }
    Slice key(o_key, o_key_length);
    jumpmuTry()
@@ -376,6 +442,15 @@ OP_RESULT BTreeLL::updateSameSizeInPlace(u8* o_key,
       if (ret != OP_RESULT::OK) {
          jumpmu_return ret;
       }
+      if (value_log != nullptr) {
+         // Log records are immutable, the updated copy is appended and replaces the pointer
+         const auto before = blob::ValueLogPointer::load(iterator.value().data());
+         u8 value[before.value_length];
+         value_log->read(before, [&](const u8* current, u16 length) { std::memcpy(value, current, length); });
+         callback(value, before.value_length);
+         ret = replaceCurrentValue(iterator, key, Slice(value, before.value_length));
+         jumpmu_return ret;
+      }
       auto current_value = iterator.mutableValue();
       if (config.enable_wal) {
          assert(update_descriptor.count > 0);  // if it is a secondary index, then we can not use updateSameSize
@@ -409,6 +484,7 @@ OP_RESULT BTreeLL::updateSameSizeInPlace(u8* o_key,
 // -------------------------------------------------------------------------------------
 OP_RESULT BTreeLL::remove(u8* o_key, u16 o_key_length)
 {
+   foldPendingMerges(Slice(o_key, o_key_length));
    cr::activeTX().markAsWrite();
    if (config.enable_wal) {
       cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
@@ -434,8 +510,13 @@ OP_RESULT BTreeLL::remove(u8* o_key, u16 o_key_length)
       } else {
          iterator.markAsDirty();
       }
+      const bool separated = value_log != nullptr;
+      const auto pointer = separated ? blob::ValueLogPointer::load(value.data()) : blob::ValueLogPointer();
       ret = iterator.removeCurrent();
       ensure(ret == OP_RESULT::OK);
+      if (separated) {
+         value_log->markDead(pointer);
+      }
       iterator.mergeIfNeeded();
       jumpmu_return OP_RESULT::OK;
    }
@@ -444,8 +525,273 @@ OP_RESULT BTreeLL::remove(u8* o_key, u16 o_key_length)
    return OP_RESULT::OTHER;
 }
 // -------------------------------------------------------------------------------------
+OP_RESULT BTreeLL::update(u8* o_key, u16 o_key_length, u8* o_value, u16 o_value_length)
+{
+   foldPendingMerges(Slice(o_key, o_key_length));
+   cr::activeTX().markAsWrite();
+   if (config.enable_wal) {
+      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 2);
+   }
+   const Slice key(o_key, o_key_length);
+   jumpmuTry()
+   {
+      BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
+      OP_RESULT ret = iterator.seekExact(key);
+      if (ret != OP_RESULT::OK) {
+         jumpmu_return ret;
+      }
+      ret = replaceCurrentValue(iterator, key, Slice(o_value, o_value_length));
+      jumpmu_return ret;
+   }
+   jumpmuCatch() {}
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeLL::upsert(u8* o_key, u16 o_key_length, u8* o_value, u16 o_value_length)
+{
+   foldPendingMerges(Slice(o_key, o_key_length));
+   cr::activeTX().markAsWrite();
+   if (config.enable_wal) {
+      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 2);
+   }
+   const Slice key(o_key, o_key_length);
+   Slice value(o_value, o_value_length);
+   blob::ValueLogPointer pointer;
+   if (value_log != nullptr) {
+      pointer = value_log->append(key, value, config.enable_wal);
+      value = pointer.asSlice();
+   }
+   jumpmuTry()
+   {
+      BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
+      OP_RESULT ret = iterator.insertKV(key, value);
+      if (ret == OP_RESULT::DUPLICATE) {
+         if (value_log != nullptr) {
+            const auto before = blob::ValueLogPointer::load(iterator.value().data());
+            ret = replaceCurrentPayload(iterator, key, value);
+            value_log->markDead(before);
+         } else {
+            ret = replaceCurrentValue(iterator, key, value);
+         }
+         jumpmu_return ret;
+      }
+      ensure(ret == OP_RESULT::OK);
+      if (config.enable_wal) {
+         auto wal_entry = iterator.leaf.reserveWALEntry<WALInsert>(key.length() + value.length());
+         wal_entry->type = WAL_LOG_TYPE::WALInsert;
+         wal_entry->key_length = key.length();
+         wal_entry->value_length = value.length();
+         std::memcpy(wal_entry->payload, key.data(), key.length());
+         std::memcpy(wal_entry->payload + key.length(), value.data(), value.length());
+         wal_entry.submit();
+      } else {
+         iterator.markAsDirty();
+      }
+      jumpmu_return OP_RESULT::OK;
+   }
+   jumpmuCatch() {}
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeLL::replaceCurrentValue(BTreeExclusiveIterator& iterator, Slice key, Slice value)
+{
+   if (value_log == nullptr) {
+      return replaceCurrentPayload(iterator, key, value);
+   }
+   // Pointers all have the same size, so the leaf never has to grow
+   const auto before = blob::ValueLogPointer::load(iterator.value().data());
+   const auto after = value_log->append(key, value, config.enable_wal);
+   const OP_RESULT ret = replaceCurrentPayload(iterator, key, after.asSlice());
+   value_log->markDead(before);
+   return ret;
+}
+// -------------------------------------------------------------------------------------
+// Resizes the payload of the current slot in place, extendPayload splits the leaf when the value does not fit anymore
+OP_RESULT BTreeLL::replaceCurrentPayload(BTreeExclusiveIterator& iterator, Slice key, Slice value)
+{
+   const u16 before_length = iterator.value().length();
+   u8 before_image[before_length];
+   std::memcpy(before_image, iterator.value().data(), before_length);
+   if (value.length() > before_length) {
+      if (!iterator.extendPayload(value.length())) {
+         return OP_RESULT::NOT_ENOUGH_SPACE;
+      }
+   } else if (value.length() < before_length) {
+      iterator.shorten(value.length());
+   }
+   std::memcpy(iterator.mutableValue().data(), value.data(), value.length());
+   if (config.enable_wal) {
+      auto wal_entry = iterator.leaf.reserveWALEntry<WALReplace>(key.length() + before_length + value.length());
+      wal_entry->type = WAL_LOG_TYPE::WALReplace;
+      wal_entry->key_length = key.length();
+      wal_entry->before_length = before_length;
+      wal_entry->after_length = value.length();
+      std::memcpy(wal_entry->payload, key.data(), key.length());
+      std::memcpy(wal_entry->payload + key.length(), before_image, before_length);
+      std::memcpy(wal_entry->payload + key.length() + before_length, value.data(), value.length());
+      wal_entry.submit();
+   } else {
+      iterator.markAsDirty();
+   }
+   return OP_RESULT::OK;
+}
+// -------------------------------------------------------------------------------------
+// Only the operand is logged, against the meta node because no leaf is touched. The operand is applied to the tree by the next
+// reader of the key, by a scan, when the stripe of this worker holds more than FLAGS_merge_buffer_keys keys, or at shutdown.
+// Like the other writes of BTreeLL, merges have no undo, and recovery does not replay WALMerge entries: operands that were not
+// folded and written back before a crash are lost.
+// The length of the value is read first: APPEND returns NOT_ENOUGH_SPACE instead of growing it beyond max_merged_kv_length, ADD and
+// MAX return OTHER for values that are no s64
+OP_RESULT BTreeLL::merge(u8* o_key, u16 o_key_length, u8* o_operand, u16 o_operand_length, MergeOperator op)
+{
+   if (value_log != nullptr || (op != MergeOperator::APPEND && o_operand_length != sizeof(s64))) {
+      return OP_RESULT::OTHER;
+   }
+   const Slice key(o_key, o_key_length);
+   const Slice operand(o_operand, o_operand_length);
+   if (key.length() + operand.length() > max_merged_kv_length) {
+      return OP_RESULT::NOT_ENOUGH_SPACE;
+   }
+   std::call_once(merge_buffer_once, [&]() {
+      merge_buffer_storage = std::make_unique<BTreeMergeBuffer>(FLAGS_worker_threads);
+      merge_buffer.store(merge_buffer_storage.get(), std::memory_order_release);
+   });
+   BTreeMergeBuffer& buffer = *merge_buffer.load(std::memory_order_acquire);
+   const u64 key_hash = BTreeMergeBuffer::hash(key);
+   const u64 stripe_i = cr::Worker::my().workerID();
+   // Mergers of the key hold its fold latch from the length check until their operand is pending, so they can not invalidate
+   // each other's check
+   std::unique_lock<std::mutex> guard(buffer.foldLatch(key_hash));
+   bool found = false;
+   u16 value_length = 0;
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<BTreeNode> leaf;
+         const s16 pos = findLeafAndSlotCanJump(leaf, key.data(), key.length());
+         found = pos != -1;
+         value_length = found ? leaf->getPayloadLength(pos) : 0;
+         leaf.recheck();
+         jumpmu_break;
+      }
+      jumpmuCatch()
+      {
+         WorkerCounters::myCounters().dt_restarts_read[dt_id]++;
+      }
+   }
+   if (op == MergeOperator::APPEND) {
+      if (key.length() + value_length + buffer.pendingLength(key) + operand.length() > max_merged_kv_length) {
+         return OP_RESULT::NOT_ENOUGH_SPACE;
+      }
+   } else if ((found && value_length != sizeof(s64)) || buffer.pendingAppendLength(key) != 0) {
+      return OP_RESULT::OTHER;
+   }
+   cr::activeTX().markAsWrite();
+   if (config.enable_wal) {
+      auto& logging = cr::Worker::my().logging;
+      logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+      auto wal_entry = logging.reserveDTEntry<WALMerge>(sizeof(WALMerge) + key.length() + operand.length(),
+                                                        meta_node_bf.asBufferFrame().header.pid, logging.getCurrentGSN(), dt_id);
+      wal_entry->type = WAL_LOG_TYPE::WALMerge;
+      wal_entry->key_length = key.length();
+      wal_entry->operand_length = operand.length();
+      wal_entry->op = op;
+      std::memcpy(wal_entry->payload, key.data(), key.length());
+      std::memcpy(wal_entry->payload + key.length(), operand.data(), operand.length());
+      wal_entry.submit();
+   }
+   // -------------------------------------------------------------------------------------
+   u64 pending_in_stripe;
+   while ((pending_in_stripe = buffer.add(stripe_i, key, key_hash, op, operand)) == 0) {
+      foldKeyLatched(buffer, key, key_hash);  // pending operand of another operator
+   }
+   guard.unlock();
+   COUNTERS_BLOCK()
+   {
+      WorkerCounters::myCounters().dt_merge[dt_id]++;
+   }
+   if (pending_in_stripe > FLAGS_merge_buffer_keys) {
+      for (auto& pending_key : buffer.pendingKeys(stripe_i)) {
+         foldKey(buffer, Slice(reinterpret_cast<const u8*>(pending_key.data()), pending_key.length()));
+      }
+   }
+   return OP_RESULT::OK;
+}
+// -------------------------------------------------------------------------------------
+// The filter slot of the key stays set until the operands are in the tree, so concurrent readers of the key wait on the fold latch
+// instead of reading the old value
+void BTreeLL::foldKey(BTreeMergeBuffer& buffer, Slice key)
+{
+   const u64 key_hash = BTreeMergeBuffer::hash(key);
+   std::unique_lock<std::mutex> guard(buffer.foldLatch(key_hash));
+   foldKeyLatched(buffer, key, key_hash);
+}
+// -------------------------------------------------------------------------------------
+void BTreeLL::foldKeyLatched(BTreeMergeBuffer& buffer, Slice key, u64 key_hash)
+{
+   auto operands = buffer.take(key);
+   for (auto& operand : operands) {
+      applyMerge(key, operand);
+   }
+   buffer.folded(key_hash, operands.size());
+   COUNTERS_BLOCK()
+   {
+      WorkerCounters::myCounters().dt_merge_folded[dt_id] += operands.size();
+   }
+}
+// -------------------------------------------------------------------------------------
+void BTreeLL::foldAll(BTreeMergeBuffer& buffer)
+{
+   for (u64 s_i = 0; s_i < buffer.stripesCount(); s_i++) {
+      for (auto& pending_key : buffer.pendingKeys(s_i)) {
+         foldKey(buffer, Slice(reinterpret_cast<const u8*>(pending_key.data()), pending_key.length()));
+      }
+   }
+}
+// -------------------------------------------------------------------------------------
+// Not logged again, the WALMerge entry written by merge() already describes the change.
+// merge() checks that the operand fits the value, but an update or upsert may replace the value before the fold. An operand that
+// no longer fits counts as ordered before that write, which overwrote it, and is skipped
+void BTreeLL::applyMerge(Slice key, const BTreeMergeBuffer::Operand& operand)
+{
+   const Slice bytes(reinterpret_cast<const u8*>(operand.bytes.data()), operand.bytes.length());
+   jumpmuTry()
+   {
+      BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
+      OP_RESULT ret = iterator.insertKV(key, bytes);
+      if (ret == OP_RESULT::DUPLICATE) {
+         const u16 value_length = iterator.value().length();
+         if (operand.op == MergeOperator::APPEND) {
+            if (key.length() + value_length + bytes.length() > max_merged_kv_length) {
+               jumpmu_return;
+            }
+            u8 value[value_length];
+            std::memcpy(value, iterator.value().data(), value_length);
+            ensure(iterator.extendPayload(value_length + bytes.length()));
+            u8* dst = iterator.mutableValue().data();
+            std::memcpy(dst, value, value_length);
+            std::memcpy(dst + value_length, bytes.data(), bytes.length());
+         } else {
+            if (value_length != sizeof(s64)) {
+               jumpmu_return;
+            }
+            BTreeMergeBuffer::combineNumeric(operand.op, iterator.mutableValue().data(), bytes.data());
+         }
+      } else {
+         ensure(ret == OP_RESULT::OK);
+      }
+      iterator.markAsDirty();
+      jumpmu_return;
+   }
+   jumpmuCatch() {}
+   UNREACHABLE();
+}
+// -------------------------------------------------------------------------------------
 OP_RESULT BTreeLL::rangeRemove(u8* start_key, u16 start_key_length, u8* end_key, u16 end_key_length, bool page_wise)
 {
+   foldPendingMerges();
    const Slice s_key(start_key, start_key_length);
    const Slice e_key(end_key, end_key_length);
    jumpmuTry()
@@ -477,6 +823,9 @@ OP_RESULT BTreeLL::rangeRemove(u8* start_key, u16 start_key_length, u8* end_key,
                {
                   WorkerCounters::myCounters().dt_range_removed[dt_id]++;
                }
+               if (value_log != nullptr) {
+                  value_log->markDead(blob::ValueLogPointer::load(iterator.value().data()));
+               }
                ret = iterator.removeCurrent();
                ensure(ret == OP_RESULT::OK);
                iterator.markAsDirty();
@@ -507,6 +856,11 @@ OP_RESULT BTreeLL::rangeRemove(u8* start_key, u16 start_key_length, u8* end_key,
                {
                   WorkerCounters::myCounters().dt_range_removed[dt_id] += leaf->count;
                }
+               if (value_log != nullptr) {
+                  for (u16 s_i = 0; s_i < leaf->count; s_i++) {
+                     value_log->markDead(blob::ValueLogPointer::load(leaf->getPayload(s_i)));
+                  }
+               }
                leaf->reset();
                iterator.markAsDirty();
                did_purge_full_page = true;
@@ -1,8 +1,11 @@
 #pragma once
 #include "core/BTreeGeneric.hpp"
+#include "core/BTreeGenericIterator.hpp"
+#include "core/BTreeMergeBuffer.hpp"
 #include "leanstore/Config.hpp"
 #include "leanstore/KVInterface.hpp"
 #include "leanstore/profiling/counters/WorkerCounters.hpp"
+#include "leanstore/storage/blob/ValueLog.hpp"
 #include "leanstore/storage/buffer-manager/BufferManager.hpp"
 #include "leanstore/sync-primitives/PageGuard.hpp"
 #include "leanstore/utils/RandomGenerator.hpp"
@@ -44,31 +47,108 @@ class BTreeLL : public KVInterface, public BTreeGeneric
       u16 value_length;
       u8 payload[];
    };
+   struct WALReplace : WALEntry {
+      u16 key_length;
+      u16 before_length;
+      u16 after_length;
+      u8 payload[];  // key | before image | after image
+   };
+   struct WALMerge : WALEntry {
+      u16 key_length;
+      u16 operand_length;
+      MergeOperator op;
+      u8 payload[];  // key | operand
+   };
+   // -------------------------------------------------------------------------------------
+   blob::ValueLog* value_log = nullptr;  // only with Config::separate_values
    // -------------------------------------------------------------------------------------
    BTreeLL() = default;
+   void create(DTID dtid, Config config, blob::ValueLog* value_log = nullptr)
+   {
+      this->value_log = value_log;
+      BTreeGeneric::create(dtid, config);
+   }
    // -------------------------------------------------------------------------------------
-   virtual OP_RESULT lookup(u8* key, u16 key_length, function<void(const u8*, u16)> payload_callback) override;
+   virtual OP_RESULT lookup(u8* key, u16 key_length, LookupCallback payload_callback) override;
    virtual OP_RESULT insert(u8* key, u16 key_length, u8* value, u16 value_length) override;
-   virtual OP_RESULT updateSameSizeInPlace(u8* key,
-                                           u16 key_length,
-                                           function<void(u8* value, u16 value_size)>,
-                                           UpdateSameSizeInPlaceDescriptor&) override;
+   virtual OP_RESULT updateSameSizeInPlace(u8* key, u16 key_length, UpdateCallback, UpdateSameSizeInPlaceDescriptor&) override;
    virtual OP_RESULT remove(u8* key, u16 key_length) override;
-   virtual OP_RESULT scanAsc(u8* start_key,
-                             u16 key_length,
-                             function<bool(const u8* key, u16 key_length, const u8* value, u16 value_length)>,
-                             function<void()>) override;
-   virtual OP_RESULT scanDesc(u8* start_key,
-                              u16 key_length,
-                              function<bool(const u8* key, u16 key_length, const u8* value, u16 value_length)>,
-                              function<void()>) override;
+   virtual OP_RESULT scanAsc(u8* start_key, u16 key_length, ScanCallback, function<void()>) override;
+   virtual OP_RESULT scanDesc(u8* start_key, u16 key_length, ScanCallback, function<void()>) override;
+   // -------------------------------------------------------------------------------------
+   // Overloads for callers that hold a BTreeLL: the callback type is known at compile time, so it is inlined into the loop
+   template <typename Fn>
+   OP_RESULT lookup(u8* key, u16 key_length, Fn&& payload_callback);
+   template <typename Fn>
+   OP_RESULT scanAsc(u8* start_key, u16 key_length, Fn&& callback);
+   template <typename Fn>
+   OP_RESULT scanDesc(u8* start_key, u16 key_length, Fn&& callback);
+   // -------------------------------------------------------------------------------------
+   // Pull-based alternative to scanAsc/scanDesc. The cursor keeps the current leaf shared latched until it moves to the next one
+   // or is destroyed, so do not modify the same tree while a cursor is open
+   class Cursor
+   {
+     public:
+      Cursor(BTreeLL& btree) : btree(btree), iterator(*static_cast<BTreeGeneric*>(&btree)) { btree.foldPendingMerges(); }
+      // Position on the first key >= key (seek) or the last key <= key (seekForPrev), false if there is none
+      bool seek(Slice key) { return moved(iterator.seek(key)); }
+      bool seekForPrev(Slice key) { return moved(iterator.seekForPrev(key)); }
+      bool next() { return moved(iterator.next()); }
+      bool prev() { return moved(iterator.prev()); }
+      // Valid until the cursor moves
+      Slice key()
+      {
+         if (!key_assembled) {
+            iterator.assembleKey();
+            key_assembled = true;
+         }
+         return iterator.key();
+      }
+      Slice value()
+      {
+         if (btree.value_log == nullptr) {
+            return iterator.value();
+         }
+         btree.value_log->read(blob::ValueLogPointer::load(iterator.value().data()),
+                               [&](const u8* value, u16 value_length) { value_copy.assign(value, value_length); });
+         return Slice(value_copy.data(), value_copy.length());
+      }
+
+     private:
+      BTreeLL& btree;
+      BTreeSharedIterator iterator;
+      std::basic_string<u8> value_copy;  // of the current value in trees with separated values
+      bool key_assembled = false;
+      bool moved(OP_RESULT ret)
+      {
+         key_assembled = false;
+         return ret == OP_RESULT::OK;
+      }
+   };
    // -------------------------------------------------------------------------------------
    virtual OP_RESULT prefixLookup(u8* key, u16 key_length, std::function<void(const u8*, u16, const u8*, u16)> payload_callback) override;
    virtual OP_RESULT prefixLookupForPrev(u8* key, u16 key_length, std::function<void(const u8*, u16, const u8*, u16)> payload_callback) override;
    virtual OP_RESULT append(std::function<void(u8*)>, u16, std::function<void(u8*)>, u16, std::unique_ptr<u8[]>&) override;
    virtual OP_RESULT rangeRemove(u8* start_key, u16 start_key_length, u8* end_key, u16 end_key_length, bool page_used) override;
+   virtual OP_RESULT update(u8* key, u16 key_length, u8* value, u16 value_length) override;
+   virtual OP_RESULT upsert(u8* key, u16 key_length, u8* value, u16 value_length) override;
+   virtual OP_RESULT merge(u8* key, u16 key_length, u8* operand, u16 operand_length, MergeOperator op) override;
+   // Applies all pending merge operands to the tree, scans call it before they start
+   inline void foldPendingMerges()
+   {
+      BTreeMergeBuffer* buffer = merge_buffer.load(std::memory_order_acquire);
+      if (buffer != nullptr && !buffer->empty()) {
+         foldAll(*buffer);
+      }
+   }
    // -------------------------------------------------------------------------------------
    bool isRangeSurelyEmpty(Slice start_key, Slice end_key);
+   // Background compaction (FLAGS_compaction): compacts the leaf that holds cursor and moves cursor behind it.
+   // Returns true when it was the last leaf, cursor then starts the next pass from the beginning
+   bool compactionStep(std::string& cursor);
+   // Moves the live values of the value log segment with the most dead bytes to a new segment and frees it.
+   // Returns false when no segment is dead enough (FLAGS_vlog_gc_dead_pct) or the tree does not separate values
+   bool collectValueLog();
    // -------------------------------------------------------------------------------------
    virtual u64 countPages() override;
    virtual u64 countEntries() override;
@@ -85,6 +165,41 @@ class BTreeLL : public KVInterface, public BTreeGeneric
    static DTRegistry::DTMeta getMeta();
    // -------------------------------------------------------------------------------------
   protected:
+   // Merges the leaf with its neighbours, BTreeVI also cleans up leaves with garbage first
+   virtual SpaceCheckResult compactLeaf(BufferFrame& bf) { return BTreeGeneric::compactPage(*this, bf); }
+   // -------------------------------------------------------------------------------------
+   // Keys and the values APPEND merges make must fit into a leaf, so that readers can always fold the operands
+   static constexpr u64 max_merged_kv_length = EFFECTIVE_PAGE_SIZE / 4;
+   // Allocated by the first merge, most trees never see one
+   std::atomic<BTreeMergeBuffer*> merge_buffer = nullptr;
+   std::unique_ptr<BTreeMergeBuffer> merge_buffer_storage;
+   std::once_flag merge_buffer_once;
+   // -------------------------------------------------------------------------------------
+   // Point operations call it before they touch the key
+   inline void foldPendingMerges(Slice key)
+   {
+      BTreeMergeBuffer* buffer = merge_buffer.load(std::memory_order_acquire);
+      if (buffer != nullptr && buffer->mayBePending(key)) {
+         foldKey(*buffer, key);
+      }
+   }
+   void foldKey(BTreeMergeBuffer& buffer, Slice key);
+   // Pre: foldLatch of the key is held
+   void foldKeyLatched(BTreeMergeBuffer& buffer, Slice key, u64 key_hash);
+   void foldAll(BTreeMergeBuffer& buffer);
+   void applyMerge(Slice key, const BTreeMergeBuffer::Operand& operand);
+   OP_RESULT replaceCurrentValue(BTreeExclusiveIterator& iterator, Slice key, Slice value);
+   OP_RESULT replaceCurrentPayload(BTreeExclusiveIterator& iterator, Slice key, Slice payload);
+   // Hands the value a leaf payload stands for to callback, the leaf must stay shared or exclusively latched meanwhile
+   template <typename Fn>
+   inline void resolveValue(Slice payload, Fn&& callback)
+   {
+      if (value_log == nullptr) {
+         callback(payload.data(), payload.length());
+      } else {
+         value_log->read(blob::ValueLogPointer::load(payload.data()), [&](const u8* value, u16 value_length) { callback(value, value_length); });
+      }
+   }
    // WAL / CC
    static void generateDiff(const UpdateSameSizeInPlaceDescriptor& update_descriptor, u8* dst, const u8* src);
    static void applyDiff(const UpdateSameSizeInPlaceDescriptor& update_descriptor, u8* dst, const u8* src);
@@ -92,6 +207,115 @@ class BTreeLL : public KVInterface, public BTreeGeneric
    static void applyXORDiff(const UpdateSameSizeInPlaceDescriptor& update_descriptor, u8* dst, const u8* src);
 };
 // -------------------------------------------------------------------------------------
+template <typename Fn>
+OP_RESULT BTreeLL::lookup(u8* key, u16 key_length, Fn&& payload_callback)
+{
+   foldPendingMerges(Slice(key, key_length));
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<BTreeNode> leaf;
+         s16 pos = findLeafAndSlotCanJump(leaf, key, key_length);
+         // -------------------------------------------------------------------------------------
+         DEBUG_BLOCK()
+         {
+            s16 sanity_check_result = leaf->compareKeyWithBoundaries(key, key_length);
+            leaf.recheck();
+            if (sanity_check_result != 0) {
+               cout << leaf->count << endl;
+            }
+            ensure(sanity_check_result == 0);
+         }
+         // -------------------------------------------------------------------------------------
+         if (pos != -1) {
+            if (value_log != nullptr) {
+               // Keeps the garbage collection from moving the value away while it is read
+               leaf.toShared();
+            }
+            resolveValue(Slice(leaf->getPayload(pos), leaf->getPayloadLength(pos)), payload_callback);
+            leaf.recheck();
+            jumpmu_return OP_RESULT::OK;
+         } else {
+            leaf.recheck();
+            jumpmu_return OP_RESULT::NOT_FOUND;
+         }
+      }
+      jumpmuCatch()
+      {
+         WorkerCounters::myCounters().dt_restarts_read[dt_id]++;
+      }
+   }
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
+template <typename Fn>
+OP_RESULT BTreeLL::scanAsc(u8* start_key, u16 key_length, Fn&& callback)
+{
+   COUNTERS_BLOCK()
+   {
+      WorkerCounters::myCounters().dt_scan_asc[dt_id]++;
+   }
+   foldPendingMerges();
+   Slice key(start_key, key_length);
+   jumpmuTry()
+   {
+      BTreeSharedIterator iterator(*static_cast<BTreeGeneric*>(this));
+      OP_RESULT ret = iterator.seek(key);
+      while (ret == OP_RESULT::OK) {
+         iterator.assembleKey();
+         auto key = iterator.key();
+         bool keep_scanning;
+         resolveValue(iterator.value(),
+                      [&](const u8* value, u16 value_length) { keep_scanning = callback(key.data(), key.length(), value, value_length); });
+         if (!keep_scanning) {
+            break;
+         }
+         ret = iterator.next();
+      }
+      jumpmu_return OP_RESULT::OK;
+   }
+   jumpmuCatch() {}
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
+template <typename Fn>
+OP_RESULT BTreeLL::scanDesc(u8* start_key, u16 key_length, Fn&& callback)
+{
+   COUNTERS_BLOCK()
+   {
+      WorkerCounters::myCounters().dt_scan_desc[dt_id]++;
+   }
+   foldPendingMerges();
+   const Slice key(start_key, key_length);
+   jumpmuTry()
+   {
+      BTreeSharedIterator iterator(*static_cast<BTreeGeneric*>(this));
+      auto ret = iterator.seekForPrev(key);
+      if (ret != OP_RESULT::OK) {
+         jumpmu_return ret;
+      }
+      while (true) {
+         iterator.assembleKey();
+         auto key = iterator.key();
+         bool keep_scanning;
+         resolveValue(iterator.value(),
+                      [&](const u8* value, u16 value_length) { keep_scanning = callback(key.data(), key.length(), value, value_length); });
+         if (!keep_scanning) {
+            jumpmu_return OP_RESULT::OK;
+         } else {
+            if (iterator.prev() != OP_RESULT::OK) {
+               jumpmu_return OP_RESULT::NOT_FOUND;
+            }
+         }
+      }
+   }
+   jumpmuCatch() {}
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
 }  // namespace btree
 }  // namespace storage
 }  // namespace leanstore
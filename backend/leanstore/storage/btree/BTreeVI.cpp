@@ -22,8 +22,9 @@ namespace storage
 namespace btree
 {
 // -------------------------------------------------------------------------------------
-OP_RESULT BTreeVI::lookup(u8* o_key, u16 o_key_length, function<void(const u8*, u16)> payload_callback)
+OP_RESULT BTreeVI::lookup(u8* o_key, u16 o_key_length, LookupCallback payload_callback)
 {
+   cr::Worker::my().cc.precision_locks.read(dt_id, Slice(o_key, o_key_length));
    const OP_RESULT ret = lookupOptimistic(o_key, o_key_length, payload_callback);
    if (ret == OP_RESULT::OTHER) {
       return lookupPessimistic(o_key, o_key_length, payload_callback);
@@ -32,7 +33,7 @@ OP_RESULT BTreeVI::lookup(u8* o_key, u16 o_key_length, function<void(const u8*,
    }
 }
 // -------------------------------------------------------------------------------------
-OP_RESULT BTreeVI::lookupPessimistic(u8* key_buffer, const u16 key_length, function<void(const u8*, u16)> payload_callback)
+OP_RESULT BTreeVI::lookupPessimistic(u8* key_buffer, const u16 key_length, LookupCallback payload_callback)
 {
    MutableSlice m_key(key_buffer, key_length);
    Slice key(key_buffer, key_length);
@@ -78,15 +79,13 @@ OP_RESULT BTreeVI::lookupPessimistic(u8* key_buffer, const u16 key_length, funct
    return OP_RESULT::OTHER;
 }
 // -------------------------------------------------------------------------------------
-OP_RESULT BTreeVI::lookupOptimistic(const u8* key, const u16 key_length, function<void(const u8*, u16)> payload_callback)
+OP_RESULT BTreeVI::lookupOptimistic(const u8* key, const u16 key_length, LookupCallback payload_callback)
 {
    while (true) {
       jumpmuTry()
       {
          HybridPageGuard<BTreeNode> leaf;
-         findLeafCanJump(leaf, key, key_length);
-         // -------------------------------------------------------------------------------------
-         s16 pos = leaf->lowerBound<true>(key, key_length);
+         s16 pos = findLeafAndSlotCanJump(leaf, key, key_length);
          if (pos != -1) {
             auto tuple_head = *reinterpret_cast<Tuple*>(leaf->getPayload(pos));
             leaf.recheck();
@@ -172,7 +171,7 @@ OP_RESULT BTreeVI::prepareDeterministicUpdate(u8* o_key, u16 o_key_length, BTree
 OP_RESULT BTreeVI::executeDeterministricUpdate(u8* o_key,
                                                u16 o_key_length,
                                                BTreeExclusiveIterator& iterator,
-                                               function<void(u8*, u16)> callback,
+                                               UpdateCallback callback,
                                                UpdateSameSizeInPlaceDescriptor& update_descriptor)
 {
    jumpmuTry()
@@ -180,6 +179,7 @@ OP_RESULT BTreeVI::executeDeterministricUpdate(u8* o_key,
       cr::activeTX().markAsWrite();
       cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
       Slice key(o_key, o_key_length);
+      cr::Worker::my().cc.recordWrite(dt_id, key);
       MutableSlice primary_payload = iterator.mutableValue();
       auto& tuple_head = *reinterpret_cast<ChainedTuple*>(primary_payload.data());
       // Update in chained mode
@@ -229,14 +229,15 @@ OP_RESULT BTreeVI::executeDeterministricUpdate(u8* o_key,
    UNREACHABLE();
 }
 // -------------------------------------------------------------------------------------
-OP_RESULT BTreeVI::updateSameSizeInPlace(u8* o_key,
-                                         u16 o_key_length,
-                                         function<void(u8* value, u16 value_size)> callback,
-                                         UpdateSameSizeInPlaceDescriptor& update_descriptor)
+OP_RESULT BTreeVI::updateSameSizeInPlacePrimary(u8* o_key,
+                                                u16 o_key_length,
+                                                UpdateCallback callback,
+                                                UpdateSameSizeInPlaceDescriptor& update_descriptor)
 {
    cr::activeTX().markAsWrite();
    cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
    Slice key(o_key, o_key_length);
+   cr::Worker::my().cc.recordWrite(dt_id, key);
    OP_RESULT ret;
    // -------------------------------------------------------------------------------------
    // 20K instructions more
@@ -261,6 +262,7 @@ OP_RESULT BTreeVI::updateSameSizeInPlace(u8* o_key,
       MutableSlice primary_payload = iterator.mutableValue();
       auto& tuple = *reinterpret_cast<Tuple*>(primary_payload.data());
       if (tuple.isWriteLocked() || !isVisibleForMe(tuple.worker_id, tuple.tx_ts, true)) {
+         cr::Worker::my().cc.noteLockConflict(dt_id, key, tuple.worker_id, tuple.tx_ts);
          jumpmu_return OP_RESULT::ABORT_TX;
       }
       tuple.writeLock();
@@ -391,11 +393,12 @@ OP_RESULT BTreeVI::updateSameSizeInPlace(u8* o_key,
    return OP_RESULT::OTHER;
 }
 // -------------------------------------------------------------------------------------
-OP_RESULT BTreeVI::insert(u8* o_key, u16 o_key_length, u8* value, u16 value_length)
+OP_RESULT BTreeVI::insertPrimary(u8* o_key, u16 o_key_length, u8* value, u16 value_length)
 {
    cr::activeTX().markAsWrite();
    cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
    Slice key(o_key, o_key_length);
+   cr::Worker::my().cc.recordWrite(dt_id, key);
    const u16 payload_length = value_length + sizeof(ChainedTuple);
    // -------------------------------------------------------------------------------------
    while (true) {
@@ -416,26 +419,90 @@ OP_RESULT BTreeVI::insert(u8* o_key, u16 o_key_length, u8* value, u16 value_leng
             iterator.splitForKey(key);
             jumpmu_continue;
          }
-         // -------------------------------------------------------------------------------------
-         // WAL
-         auto wal_entry = iterator.leaf.reserveWALEntry<WALInsert>(o_key_length + value_length);
-         wal_entry->type = WAL_LOG_TYPE::WALInsert;
-         wal_entry->key_length = o_key_length;
-         wal_entry->value_length = value_length;
-         std::memcpy(wal_entry->payload, o_key, o_key_length);
-         std::memcpy(wal_entry->payload + o_key_length, value, value_length);
-         wal_entry.submit();
-         // -------------------------------------------------------------------------------------
-         iterator.insertInCurrentNode(key, payload_length);
-         MutableSlice payload = iterator.mutableValue();
-         auto& primary_version = *new (payload.data()) ChainedTuple(cr::Worker::my().workerID(), cr::activeTX().startTS());
-         std::memcpy(primary_version.payload, value, value_length);
-         // -------------------------------------------------------------------------------------
-         if (cr::activeTX().current_tx_mode == TX_MODE::INSTANTLY_VISIBLE_BULK_INSERT) {
-            primary_version.tx_ts = MSB | 0;
+         insertTuple(iterator, key, Slice(value, value_length));
+         jumpmu_return OP_RESULT::OK;
+      }
+      jumpmuCatch()
+      {
+         UNREACHABLE();
+      }
+   }
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
+void BTreeVI::insertTuple(BTreeExclusiveIterator& iterator, Slice key, Slice value)
+{
+   // WAL
+   auto wal_entry = iterator.leaf.reserveWALEntry<WALInsert>(key.length() + value.length());
+   wal_entry->type = WAL_LOG_TYPE::WALInsert;
+   wal_entry->key_length = key.length();
+   wal_entry->value_length = value.length();
+   std::memcpy(wal_entry->payload, key.data(), key.length());
+   std::memcpy(wal_entry->payload + key.length(), value.data(), value.length());
+   wal_entry.submit();
+   // -------------------------------------------------------------------------------------
+   iterator.insertInCurrentNode(key, value.length() + sizeof(ChainedTuple));
+   MutableSlice payload = iterator.mutableValue();
+   auto& primary_version = *new (payload.data()) ChainedTuple(cr::Worker::my().workerID(), cr::activeTX().startTS());
+   std::memcpy(primary_version.payload, value.data(), value.length());
+   // -------------------------------------------------------------------------------------
+   if (cr::activeTX().current_tx_mode == TX_MODE::INSTANTLY_VISIBLE_BULK_INSERT) {
+      primary_version.tx_ts = MSB | 0;
+   }
+   // -------------------------------------------------------------------------------------
+   iterator.markAsDirty();
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeVI::updatePrimary(u8* o_key, u16 o_key_length, u8* o_value, u16 o_value_length)
+{
+   cr::activeTX().markAsWrite();
+   cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 2);
+   Slice key(o_key, o_key_length);
+   cr::Worker::my().cc.recordWrite(dt_id, key);
+   jumpmuTry()
+   {
+      BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
+      OP_RESULT ret = iterator.seekExact(key);
+      if (ret != OP_RESULT::OK) {
+         if (cr::activeTX().isOLAP() && ret == OP_RESULT::NOT_FOUND) {
+            const bool removed_tuple_found = graveyard->lookup(o_key, o_key_length, [&](const u8*, u16) {}) == OP_RESULT::OK;
+            if (removed_tuple_found) {
+               jumpmu_return OP_RESULT::ABORT_TX;
+            }
          }
-         // -------------------------------------------------------------------------------------
-         iterator.markAsDirty();
+         jumpmu_return ret;
+      }
+      ret = replaceCurrentTuple(iterator, key, Slice(o_value, o_value_length));
+      jumpmu_return ret;
+   }
+   jumpmuCatch() {}
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeVI::upsertPrimary(u8* o_key, u16 o_key_length, u8* o_value, u16 o_value_length)
+{
+   cr::activeTX().markAsWrite();
+   cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 2);
+   Slice key(o_key, o_key_length);
+   cr::Worker::my().cc.recordWrite(dt_id, key);
+   Slice value(o_value, o_value_length);
+   while (true) {
+      jumpmuTry()
+      {
+         BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
+         OP_RESULT ret = iterator.seekToInsert(key);
+         if (ret == OP_RESULT::DUPLICATE) {
+            ret = replaceCurrentTuple(iterator, key, value, true);
+            jumpmu_return ret;
+         }
+         ret = iterator.enoughSpaceInCurrentNode(key, value.length() + sizeof(ChainedTuple));
+         if (ret == OP_RESULT::NOT_ENOUGH_SPACE) {
+            iterator.splitForKey(key);
+            jumpmu_continue;
+         }
+         insertTuple(iterator, key, value);
          jumpmu_return OP_RESULT::OK;
       }
       jumpmuCatch()
@@ -447,12 +514,101 @@ OP_RESULT BTreeVI::insert(u8* o_key, u16 o_key_length, u8* value, u16 value_leng
    return OP_RESULT::OTHER;
 }
 // -------------------------------------------------------------------------------------
-OP_RESULT BTreeVI::remove(u8* o_key, u16 o_key_length)
+// Replaces the value of the tuple under the iterator, growing or shrinking its payload in place.
+// The complete before image becomes a non-delta UpdateVersion, so readers that do not see the new value reconstruct the old one
+// with its old length. Reviving a removed tuple writes a tombstone instead, readers that see it do not find the tuple, and the
+// chain continues with the RemoveVersion behind it
+OP_RESULT BTreeVI::replaceCurrentTuple(BTreeExclusiveIterator& iterator, Slice key, Slice value, bool revive)
+{
+   bool removed = false;
+   {
+      auto& tuple = *reinterpret_cast<Tuple*>(iterator.mutableValue().data());
+      if (tuple.isWriteLocked() || !isVisibleForMe(tuple.worker_id, tuple.tx_ts, true)) {
+         return OP_RESULT::ABORT_TX;
+      }
+      if (tuple.tuple_format == TupleFormat::FAT_TUPLE_DIFFERENT_ATTRIBUTES) {
+         // The deltas of a fat tuple all refer to the current value length, move them to the history first
+         auto& fat_tuple = *reinterpret_cast<FatTupleDifferentAttributes*>(&tuple);
+         const u16 chained_length = fat_tuple.value_length + sizeof(ChainedTuple);
+         fat_tuple.convertToChained(dt_id);
+         iterator.shorten(chained_length);
+      } else if (reinterpret_cast<ChainedTuple*>(&tuple)->is_removed) {
+         if (!revive) {
+            return OP_RESULT::NOT_FOUND;
+         }
+         removed = true;
+      }
+   }
+   reinterpret_cast<ChainedTuple*>(iterator.mutableValue().data())->writeLock();
+   COUNTERS_BLOCK()
+   {
+      WorkerCounters::myCounters().cc_update_chains[dt_id]++;
+   }
+   // -------------------------------------------------------------------------------------
+   // extendPayload does not retain the payload and may split, the write lock keeps other transactions away meanwhile
+   const u16 before_payload_length = iterator.value().length();
+   const u16 before_value_length = removed ? 0 : before_payload_length - sizeof(ChainedTuple);
+   const u16 after_payload_length = value.length() + sizeof(ChainedTuple);
+   u8 before[before_payload_length];
+   std::memcpy(before, iterator.value().data(), before_payload_length);
+   const auto& before_head = *reinterpret_cast<const ChainedTuple*>(before);
+   if (after_payload_length > before_payload_length) {
+      if (!iterator.extendPayload(after_payload_length)) {
+         reinterpret_cast<ChainedTuple*>(iterator.mutableValue().data())->unlock();
+         return OP_RESULT::NOT_ENOUGH_SPACE;
+      }
+      std::memcpy(iterator.mutableValue().data(), before, before_payload_length);
+   }
+   // -------------------------------------------------------------------------------------
+   const COMMANDID command_id =
+       cr::Worker::my().cc.insertVersion(dt_id, false, sizeof(UpdateVersion) + before_value_length, [&](u8* version_payload) {
+          auto& secondary_version =
+              *new (version_payload) UpdateVersion(before_head.worker_id, before_head.tx_ts, before_head.command_id, false);
+          secondary_version.is_removed = removed;
+          std::memcpy(secondary_version.payload, before_head.payload, before_value_length);
+       });
+   COUNTERS_BLOCK()
+   {
+      WorkerCounters::myCounters().cc_update_versions_created[dt_id]++;
+   }
+   // -------------------------------------------------------------------------------------
+   // WAL
+   auto wal_entry = iterator.leaf.reserveWALEntry<WALReplace>(key.length() + before_value_length + value.length());
+   wal_entry->type = WAL_LOG_TYPE::WALReplace;
+   wal_entry->key_length = key.length();
+   wal_entry->before_length = before_value_length;
+   wal_entry->after_length = value.length();
+   wal_entry->before_worker_id = before_head.worker_id;
+   wal_entry->before_tx_id = before_head.tx_ts;
+   wal_entry->before_command_id = before_head.command_id;
+   wal_entry->before_removed = removed;
+   std::memcpy(wal_entry->payload, key.data(), key.length());
+   std::memcpy(wal_entry->payload + key.length(), before_head.payload, before_value_length);
+   std::memcpy(wal_entry->payload + key.length() + before_value_length, value.data(), value.length());
+   wal_entry.submit();
+   // -------------------------------------------------------------------------------------
+   if (after_payload_length < before_payload_length) {
+      iterator.shorten(after_payload_length);
+   }
+   auto& tuple_head = *reinterpret_cast<ChainedTuple*>(iterator.mutableValue().data());
+   std::memcpy(tuple_head.payload, value.data(), value.length());
+   cr::Worker::my().logging.checkLogDepdency(before_head.worker_id, before_head.tx_ts);
+   tuple_head.worker_id = cr::Worker::my().workerID();
+   tuple_head.tx_ts = cr::activeTX().startTS();
+   tuple_head.command_id = command_id;
+   tuple_head.is_removed = false;
+   tuple_head.unlock();
+   iterator.markAsDirty();
+   return OP_RESULT::OK;
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeVI::removePrimary(u8* o_key, u16 o_key_length)
 {
    // TODO: remove fat tuple
    cr::activeTX().markAsWrite();
    cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
    Slice key(o_key, o_key_length);
+   cr::Worker::my().cc.recordWrite(dt_id, key);
    // -------------------------------------------------------------------------------------
    jumpmuTry()
    {
@@ -482,6 +638,7 @@ OP_RESULT BTreeVI::remove(u8* o_key, u16 o_key_length)
       // -------------------------------------------------------------------------------------
       ensure(chain_head.tuple_format == TupleFormat::CHAINED);  // TODO: removing fat tuple is not supported atm
       if (chain_head.isWriteLocked() || !isVisibleForMe(chain_head.worker_id, chain_head.tx_ts, true)) {
+         cr::Worker::my().cc.noteLockConflict(dt_id, key, chain_head.worker_id, chain_head.tx_ts);
          jumpmu_return OP_RESULT::ABORT_TX;
       }
       ensure(!cr::activeTX().atLeastSI() || chain_head.is_removed == false);
@@ -630,6 +787,35 @@ void BTreeVI::undo(void* btree_object, const u8* wal_entry_ptr, const u64)
          }
          break;
       }
+      case WAL_LOG_TYPE::WALReplace: {
+         auto& replace_entry = *reinterpret_cast<const WALReplace*>(&entry);
+         Slice key(replace_entry.payload, replace_entry.key_length);
+         // -------------------------------------------------------------------------------------
+         jumpmuTry()
+         {
+            BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(&btree));
+            OP_RESULT ret = iterator.seekExact(key);
+            ensure(ret == OP_RESULT::OK);
+            // Resize
+            const u16 before_payload_length = replace_entry.before_length + sizeof(ChainedTuple);
+            if (iterator.value().length() < before_payload_length) {
+               const bool did_extend = iterator.extendPayload(before_payload_length);
+               ensure(did_extend);
+            } else {
+               iterator.shorten(before_payload_length);
+            }
+            auto& chain_head = *new (iterator.mutableValue().data()) ChainedTuple(replace_entry.before_worker_id, replace_entry.before_tx_id);
+            chain_head.command_id = replace_entry.before_command_id;
+            chain_head.is_removed = replace_entry.before_removed;
+            std::memcpy(chain_head.payload, replace_entry.payload + replace_entry.key_length, replace_entry.before_length);
+            iterator.markAsDirty();
+         }
+         jumpmuCatch()
+         {
+            UNREACHABLE();
+         }
+         break;
+      }
       default: {
          break;
       }
@@ -638,24 +824,26 @@ void BTreeVI::undo(void* btree_object, const u8* wal_entry_ptr, const u64)
 // -------------------------------------------------------------------------------------
 SpaceCheckResult BTreeVI::checkSpaceUtilization(void* btree_object, BufferFrame& bf)
 {
-   auto& btree = *reinterpret_cast<BTreeVI*>(btree_object);
-   // -------------------------------------------------------------------------------------
    if (!FLAGS_xmerge) {
       return SpaceCheckResult::NOTHING;
    }
-   // -------------------------------------------------------------------------------------
+   return reinterpret_cast<BTreeVI*>(btree_object)->compactLeaf(bf);
+}
+// -------------------------------------------------------------------------------------
+SpaceCheckResult BTreeVI::compactLeaf(BufferFrame& bf)
+{
    if (!FLAGS_vi_fat_tuple_decompose) {
-      return BTreeGeneric::checkSpaceUtilization(static_cast<BTreeGeneric*>(&btree), bf);
+      return BTreeGeneric::compactPage(*this, bf);
    }
    // -------------------------------------------------------------------------------------
    Guard bf_guard(bf.header.latch);
    bf_guard.toOptimisticOrJump();
-   if (bf.page.dt_id != btree.dt_id) {
+   if (bf.page.dt_id != dt_id) {
       jumpmu::jump();
    }
    HybridPageGuard<BTreeNode> c_guard(std::move(bf_guard), &bf);
    if (!c_guard->is_leaf || !triggerPageWiseGarbageCollection(c_guard)) {
-      return BTreeGeneric::checkSpaceUtilization(static_cast<BTreeGeneric*>(&btree), bf);
+      return BTreeGeneric::compactPage(*this, bf);
    }
    // -------------------------------------------------------------------------------------
    c_guard.toExclusive();
@@ -665,7 +853,7 @@ SpaceCheckResult BTreeVI::checkSpaceUtilization(void* btree_object, BufferFrame&
       if (tuple.tuple_format == TupleFormat::FAT_TUPLE_DIFFERENT_ATTRIBUTES) {
          auto& fat_tuple = *reinterpret_cast<FatTupleDifferentAttributes*>(c_guard->getPayload(s_i));
          const u32 new_length = fat_tuple.value_length + sizeof(ChainedTuple);
-         fat_tuple.convertToChained(btree.dt_id);
+         fat_tuple.convertToChained(dt_id);
          ensure(new_length < c_guard->getPayloadLength(s_i));
          c_guard->shortenPayload(s_i, new_length);
          ensure(tuple.tuple_format == TupleFormat::CHAINED);
@@ -674,7 +862,7 @@ SpaceCheckResult BTreeVI::checkSpaceUtilization(void* btree_object, BufferFrame&
    c_guard->has_garbage = false;
    c_guard.unlock();
    // -------------------------------------------------------------------------------------
-   const SpaceCheckResult xmerge_ret = BTreeGeneric::checkSpaceUtilization(static_cast<BTreeGeneric*>(&btree), bf);
+   const SpaceCheckResult xmerge_ret = BTreeGeneric::compactPage(*this, bf);
    if (xmerge_ret == SpaceCheckResult::PICK_ANOTHER_BF) {
       return SpaceCheckResult::PICK_ANOTHER_BF;
    } else {
@@ -810,6 +998,11 @@ void BTreeVI::unlock(void* btree_object, const u8* wal_entry_ptr)
          key = Slice(remove_entry.payload, remove_entry.key_length);
          break;
       }
+      case WAL_LOG_TYPE::WALReplace: {
+         auto& replace_entry = *reinterpret_cast<const WALReplace*>(&entry);
+         key = Slice(replace_entry.payload, replace_entry.key_length);
+         break;
+      }
       default: {
          return;
          break;
@@ -849,7 +1042,7 @@ struct DTRegistry::DTMeta BTreeVI::getMeta()
    return btree_meta;
 }
 // -------------------------------------------------------------------------------------
-OP_RESULT BTreeVI::scanDesc(u8* o_key, u16 o_key_length, function<bool(const u8*, u16, const u8*, u16)> callback, function<void()>)
+OP_RESULT BTreeVI::scanDesc(u8* o_key, u16 o_key_length, ScanCallback callback, function<void()>)
 {
    if (cr::activeTX().isOLAP()) {
       TODOException();
@@ -859,10 +1052,7 @@ OP_RESULT BTreeVI::scanDesc(u8* o_key, u16 o_key_length, function<bool(const u8*
    }
 }
 // -------------------------------------------------------------------------------------
-OP_RESULT BTreeVI::scanAsc(u8* o_key,
-                           u16 o_key_length,
-                           function<bool(const u8* key, u16 key_length, const u8* value, u16 value_length)> callback,
-                           function<void()>)
+OP_RESULT BTreeVI::scanAsc(u8* o_key, u16 o_key_length, ScanCallback callback, function<void()>)
 {
    if (cr::activeTX().isOLAP()) {
       return scanOLAP(o_key, o_key_length, callback);
@@ -877,6 +1067,7 @@ std::tuple<OP_RESULT, u16> BTreeVI::reconstructChainedTuple([[maybe_unused]] Sli
    u16 chain_length = 1;
    u16 materialized_value_length;
    std::unique_ptr<u8[]> materialized_value;
+   bool materialized_removed = false;
    const ChainedTuple& chain_head = *reinterpret_cast<const ChainedTuple*>(payload.data());
    if (isVisibleForMe(chain_head.worker_id, chain_head.tx_ts, false)) {
       if (chain_head.is_removed) {
@@ -909,12 +1100,14 @@ std::tuple<OP_RESULT, u16> BTreeVI::reconstructChainedTuple([[maybe_unused]] Sli
                    materialized_value_length = version_length - sizeof(UpdateVersion);
                    materialized_value = std::make_unique<u8[]>(materialized_value_length);
                    std::memcpy(materialized_value.get(), update_version.payload, materialized_value_length);
+                   materialized_removed = update_version.is_removed;
                 }
              } else if (version.type == Version::TYPE::REMOVE) {
                 const auto& remove_version = *reinterpret_cast<const RemoveVersion*>(version_payload);
                 materialized_value_length = remove_version.value_length;
                 materialized_value = std::make_unique<u8[]>(materialized_value_length);
                 std::memcpy(materialized_value.get(), remove_version.payload, materialized_value_length);
+                materialized_removed = false;
              } else {
                 UNREACHABLE();
              }
@@ -934,6 +1127,9 @@ std::tuple<OP_RESULT, u16> BTreeVI::reconstructChainedTuple([[maybe_unused]] Sli
          return {OP_RESULT::NOT_FOUND, chain_length};
       }
       if (isVisibleForMe(next_worker_id, next_tx_id, false)) {
+         if (materialized_removed) {
+            return {OP_RESULT::NOT_FOUND, chain_length};
+         }
          callback(Slice(materialized_value.get(), materialized_value_length));
          return {OP_RESULT::OK, chain_length};
       }
@@ -9,7 +9,11 @@
 #include "leanstore/utils/RandomGenerator.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
+#include <functional>
+#include <optional>
 #include <set>
+#include <string>
+#include <vector>
 // -------------------------------------------------------------------------------------
 using namespace leanstore::storage;
 // -------------------------------------------------------------------------------------
@@ -61,6 +65,16 @@ class BTreeVI : public BTreeLL
       u64 before_command_id;
       u8 payload[];
    };
+   struct WALReplace : WALEntry {
+      u16 key_length;
+      u16 before_length;
+      u16 after_length;
+      WORKERID before_worker_id;
+      TXID before_tx_id;
+      COMMANDID before_command_id;
+      bool before_removed;  // the before image is empty
+      u8 payload[];         // key | before image | after image
+   };
    // -------------------------------------------------------------------------------------
    /*
      Plan: we should handle frequently and infrequently updated tuples differently when it comes to maintaining
@@ -148,7 +162,7 @@ class BTreeVI : public BTreeLL
       static bool update(BTreeExclusiveIterator& iterator,
                          u8* key,
                          u16 o_key_length,
-                         function<void(u8* value, u16 value_size)>,
+                         UpdateCallback,
                          UpdateSameSizeInPlaceDescriptor&);
       bool hasSpaceFor(const UpdateSameSizeInPlaceDescriptor&);
       void append(UpdateSameSizeInPlaceDescriptor&);
@@ -191,10 +205,11 @@ class BTreeVI : public BTreeLL
    };
    struct __attribute__((packed)) UpdateVersion : Version {
       u8 is_delta : 1;
-      u8 payload[];  // UpdateDescriptor + Diff
+      u8 is_removed : 1;  // tombstone of a removed tuple that an upsert revived, without payload
+      u8 payload[];       // UpdateDescriptor + Diff
       // -------------------------------------------------------------------------------------
       UpdateVersion(WORKERID worker_id, TXID tx_id, COMMANDID command_id, bool is_delta)
-          : Version(Version::TYPE::UPDATE, worker_id, tx_id, command_id), is_delta(is_delta)
+          : Version(Version::TYPE::UPDATE, worker_id, tx_id, command_id), is_delta(is_delta), is_removed(false)
       {
       }
       bool isFinal() const { return command_id == 0; }
@@ -212,34 +227,51 @@ class BTreeVI : public BTreeLL
    };
    // -------------------------------------------------------------------------------------
    // KVInterface
-   OP_RESULT lookup(u8* key, u16 key_length, function<void(const u8*, u16)> payload_callback) override;
+   OP_RESULT lookup(u8* key, u16 key_length, LookupCallback payload_callback) override;
    OP_RESULT insert(u8* key, u16 key_length, u8* value, u16 value_length) override;
-   OP_RESULT updateSameSizeInPlace(u8* key, u16 key_length, function<void(u8* value, u16 value_size)>, UpdateSameSizeInPlaceDescriptor&) override;
+   OP_RESULT updateSameSizeInPlace(u8* key, u16 key_length, UpdateCallback, UpdateSameSizeInPlaceDescriptor&) override;
    OP_RESULT remove(u8* key, u16 key_length) override;
-   OP_RESULT scanAsc(u8* start_key,
-                     u16 key_length,
-                     function<bool(const u8* key, u16 key_length, const u8* value, u16 value_length)>,
-                     function<void()>) override;
-   OP_RESULT scanDesc(u8* start_key,
-                      u16 key_length,
-                      function<bool(const u8* key, u16 key_length, const u8* value, u16 value_length)>,
-                      function<void()>) override;
+   OP_RESULT scanAsc(u8* start_key, u16 key_length, ScanCallback, function<void()>) override;
+   OP_RESULT scanDesc(u8* start_key, u16 key_length, ScanCallback, function<void()>) override;
+   OP_RESULT update(u8* key, u16 key_length, u8* value, u16 value_length) override;
+   OP_RESULT upsert(u8* key, u16 key_length, u8* value, u16 value_length) override;
+   // Pending operands would have to become versions of their own to be visible to the right snapshots, not supported yet
+   OP_RESULT merge(u8*, u16, u8*, u16, MergeOperator) override { return OP_RESULT::OTHER; }
+   // -------------------------------------------------------------------------------------
+   // Secondary indexes. An index is a BTreeVI of its own that maps secondary key | primary key to the primary key. The write
+   // operations above maintain the entries of all indexes in the same transaction, so entries are versioned, logged and rolled back
+   // together with their tuple. When an entry cannot be written the operation returns ABORT_TX, like on a write-write conflict.
+   // Extractors are code, declare the indexes again after a restart
+   using KeyExtractor = std::function<u16(Slice key, Slice value, u8* secondary_key)>;  // returns the secondary key length
+   using IndexScanCallback =
+       utils::FunctionRef<bool(const u8* secondary_key, u16 secondary_key_length, const u8* primary_key, u16 primary_key_length)>;
+   static constexpr u16 max_secondary_key_length = 1024;
+   // Returns the id of the index for the scans, existing tuples are not indexed
+   u64 addSecondaryIndex(BTreeVI& index, KeyExtractor extractor);
+   // Index-only scans, start_key is compared with secondary key | primary key
+   OP_RESULT scanIndexAsc(u64 index_id, u8* start_key, u16 start_key_length, IndexScanCallback callback);
+   OP_RESULT scanIndexDesc(u64 index_id, u8* start_key, u16 start_key_length, IndexScanCallback callback);
+   // Looks up the tuples of index hits. The keys are sorted first, so neighbouring tuples are found on the same leaf while it is
+   // still in the cache. Keys that are not visible are skipped
+   void lookupBatch(std::vector<std::string>& primary_keys, utils::FunctionRef<void(Slice primary_key, Slice value)> callback);
    // -------------------------------------------------------------------------------------
    OP_RESULT prepareDeterministicUpdate(u8* key, u16 key_length, BTreeExclusiveIterator& iterator);
    OP_RESULT executeDeterministricUpdate(u8* key,
                                          u16 key_length,
                                          BTreeExclusiveIterator& iterator,
-                                         function<void(u8* value, u16 value_size)>,
+                                         UpdateCallback,
                                          UpdateSameSizeInPlaceDescriptor&);
 
    // -------------------------------------------------------------------------------------
    void create(DTID dtid, Config config, BTreeLL* graveyard_btree)
    {
+      ensure(!config.separate_values);  // versions live in the leaves
       this->graveyard = graveyard_btree;
       BTreeLL::create(dtid, config);
    }
    // -------------------------------------------------------------------------------------
    static SpaceCheckResult checkSpaceUtilization(void* btree_object, BufferFrame&);
+   SpaceCheckResult compactLeaf(BufferFrame& bf) override;
    static void undo(void* btree_object, const u8* wal_entry_ptr, const u64 tx_id);
    static void todo(void* btree_object, const u8* entry_ptr, const u64 version_worker_id, const u64 version_tx_id, const bool called_before);
    static void deserialize(void* btree_object, std::unordered_map<std::string, std::string> serialized)
@@ -263,17 +295,34 @@ class BTreeVI : public BTreeLL
    BTreeLL* graveyard;
 
   private:
+   struct SecondaryIndex {
+      BTreeVI* tree;
+      KeyExtractor extract;
+   };
+   std::vector<SecondaryIndex> secondary_indexes;
+   // -------------------------------------------------------------------------------------
+   // The write operations without index maintenance
+   OP_RESULT insertPrimary(u8* key, u16 key_length, u8* value, u16 value_length);
+   OP_RESULT updateSameSizeInPlacePrimary(u8* key, u16 key_length, UpdateCallback, UpdateSameSizeInPlaceDescriptor&);
+   OP_RESULT removePrimary(u8* key, u16 key_length);
+   OP_RESULT updatePrimary(u8* key, u16 key_length, u8* value, u16 value_length);
+   OP_RESULT upsertPrimary(u8* key, u16 key_length, u8* value, u16 value_length);
+   // Moves the index entries of a tuple that changed from before to after, nullopt stands for no tuple
+   OP_RESULT maintainSecondaryIndexes(Slice key, std::optional<Slice> before, std::optional<Slice> after);
+   bool lookupCopy(u8* key, u16 key_length, std::basic_string<u8>& value);
    // -------------------------------------------------------------------------------------
    bool convertChainedToFatTupleDifferentAttributes(BTreeExclusiveIterator& iterator);
+   // revive: a removed tuple gets the value too instead of returning NOT_FOUND
+   OP_RESULT replaceCurrentTuple(BTreeExclusiveIterator& iterator, Slice key, Slice value, bool revive = false);
+   void insertTuple(BTreeExclusiveIterator& iterator, Slice key, Slice value);
    // -------------------------------------------------------------------------------------
-   OP_RESULT lookupPessimistic(u8* key, const u16 key_length, function<void(const u8*, u16)> payload_callback);
-   OP_RESULT lookupOptimistic(const u8* key, const u16 key_length, function<void(const u8*, u16)> payload_callback);
+   OP_RESULT lookupPessimistic(u8* key, const u16 key_length, LookupCallback payload_callback);
+   OP_RESULT lookupOptimistic(const u8* key, const u16 key_length, LookupCallback payload_callback);
 
    // -------------------------------------------------------------------------------------
    template <bool asc = true>
-   OP_RESULT scan(u8* o_key, u16 o_key_length, function<bool(const u8* key, u16 key_length, const u8* value, u16 value_length)> callback)
+   OP_RESULT scan(u8* o_key, u16 o_key_length, ScanCallback callback)
    {
-      // TODO: index range lock for serializability
       COUNTERS_BLOCK()
       {
          if (asc) {
@@ -284,6 +333,14 @@ class BTreeVI : public BTreeLL
       }
       u64 counter = 0;
       volatile bool keep_scanning = true;
+      // Serializable: the keys the scan covered, from the start key to the last one it visited or to the end of the tree
+      auto lock_range = [&](std::optional<Slice> last_key) {
+         if constexpr (asc) {
+            cr::Worker::my().cc.precision_locks.readRange(dt_id, Slice(o_key, o_key_length), last_key);
+         } else {
+            cr::Worker::my().cc.precision_locks.readRange(dt_id, last_key, Slice(o_key, o_key_length));
+         }
+      };
       // -------------------------------------------------------------------------------------
       jumpmuTry()
       {
@@ -316,6 +373,7 @@ class BTreeVI : public BTreeLL
                }
             }
             if (!keep_scanning) {
+               lock_range(s_key);
                jumpmu_return OP_RESULT::OK;
             }
             // -------------------------------------------------------------------------------------
@@ -325,6 +383,7 @@ class BTreeVI : public BTreeLL
                ret = iterator.prev();
             }
          }
+         lock_range(std::nullopt);
          jumpmu_return OP_RESULT::OK;
       }
       jumpmuCatch() { ensure(false); }
@@ -334,7 +393,7 @@ class BTreeVI : public BTreeLL
    // -------------------------------------------------------------------------------------
    // TODO: atm, only ascending
    template <bool asc = true>
-   OP_RESULT scanOLAP(u8* o_key, u16 o_key_length, function<bool(const u8* key, u16 key_length, const u8* value, u16 value_length)> callback)
+   OP_RESULT scanOLAP(u8* o_key, u16 o_key_length, ScanCallback callback)
    {
       volatile bool keep_scanning = true;
       // -------------------------------------------------------------------------------------
@@ -456,7 +515,7 @@ class BTreeVI : public BTreeLL
                   if (primary_version.is_removed) {
                      jumpmu_return{OP_RESULT::NOT_FOUND, 1};
                   }
-                  callback(Slice(primary_version.payload, payload.length()));
+                  callback(Slice(primary_version.payload, payload.length() - sizeof(ChainedTuple)));
                   jumpmu_return{OP_RESULT::OK, 1};
                } else {
                   if (primary_version.isFinal()) {
@@ -227,7 +227,7 @@ void BTreeVI::FatTupleDifferentAttributes::append(UpdateSameSizeInPlaceDescripto
 bool BTreeVI::FatTupleDifferentAttributes::update(BTreeExclusiveIterator& iterator,
                                                   u8* o_key,
                                                   u16 o_key_length,
-                                                  function<void(u8* value, u16 value_size)> cb,
+                                                  UpdateCallback cb,
                                                   UpdateSameSizeInPlaceDescriptor& update_descriptor)
 {
 utils::Timer timer(CRCounters::myCounters().cc_ms_fat_tuple);
@@ -392,10 +392,14 @@ bool BTreeVI::convertChainedToFatTupleDifferentAttributes(BTreeExclusiveIterator
       }
       // -------------------------------------------------------------------------------------
       if (!cr::Worker::my().cc.retrieveVersion(next_worker_id, next_tx_id, next_command_id, [&](const u8* version, [[maybe_unused]] u64 payload_length) {
-             number_of_deltas_to_replace++;
              const auto& chain_delta = *reinterpret_cast<const UpdateVersion*>(version);
              ensure(chain_delta.type == Version::TYPE::UPDATE);
-             ensure(chain_delta.is_delta);
+             if (!chain_delta.is_delta) {
+                // The value changed its size, a fat tuple can only hold deltas of one value length
+                abort_conversion = true;
+                return;
+             }
+             number_of_deltas_to_replace++;
              const auto& update_descriptor = *reinterpret_cast<const UpdateSameSizeInPlaceDescriptor*>(chain_delta.payload);
              const u32 descriptor_and_diff_length = update_descriptor.size() + update_descriptor.diffLength();
              const u32 needed_space = sizeof(FatTupleDifferentAttributes::Delta) + descriptor_and_diff_length;
@@ -0,0 +1,176 @@
+#include "BTreeVI.hpp"
+#include "leanstore/concurrency-recovery/CRMG.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <algorithm>
+// -------------------------------------------------------------------------------------
+using namespace std;
+using namespace leanstore::storage;
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace btree
+{
+// -------------------------------------------------------------------------------------
+u64 BTreeVI::addSecondaryIndex(BTreeVI& index, KeyExtractor extractor)
+{
+   secondary_indexes.push_back({&index, std::move(extractor)});
+   return secondary_indexes.size() - 1;
+}
+// -------------------------------------------------------------------------------------
+// The write operations without indexes go straight to the tuple. With indexes, the tuple is written first: it reports conflicts
+// and missing keys as usual, and its index entries are only touched once the tuple changed
+OP_RESULT BTreeVI::insert(u8* o_key, u16 o_key_length, u8* o_value, u16 o_value_length)
+{
+   const OP_RESULT ret = insertPrimary(o_key, o_key_length, o_value, o_value_length);
+   if (ret != OP_RESULT::OK || secondary_indexes.empty()) {
+      return ret;
+   }
+   return maintainSecondaryIndexes(Slice(o_key, o_key_length), std::nullopt, Slice(o_value, o_value_length));
+}
+// -------------------------------------------------------------------------------------
+// A write-write conflict that waitForLockHolder resolves retries from the lookup of the old tuple, its holder may have changed it
+OP_RESULT BTreeVI::updateSameSizeInPlace(u8* o_key, u16 o_key_length, UpdateCallback callback, UpdateSameSizeInPlaceDescriptor& update_descriptor)
+{
+   std::basic_string<u8> before, after;
+   bool indexed;
+   OP_RESULT ret;
+   do {
+      indexed = !secondary_indexes.empty() && lookupCopy(o_key, o_key_length, before);
+      ret = updateSameSizeInPlacePrimary(o_key, o_key_length, callback, update_descriptor);
+   } while (ret == OP_RESULT::ABORT_TX && cr::Worker::my().cc.waitForLockHolder());
+   if (ret != OP_RESULT::OK || !indexed) {
+      return ret;
+   }
+   // The callback only sees the stored tuple, so read back what it made of it
+   ensure(lookupCopy(o_key, o_key_length, after));
+   return maintainSecondaryIndexes(Slice(o_key, o_key_length), Slice(before), Slice(after));
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeVI::remove(u8* o_key, u16 o_key_length)
+{
+   std::basic_string<u8> before;
+   bool indexed;
+   OP_RESULT ret;
+   do {
+      indexed = !secondary_indexes.empty() && lookupCopy(o_key, o_key_length, before);
+      ret = removePrimary(o_key, o_key_length);
+   } while (ret == OP_RESULT::ABORT_TX && cr::Worker::my().cc.waitForLockHolder());
+   if (ret != OP_RESULT::OK || !indexed) {
+      return ret;
+   }
+   return maintainSecondaryIndexes(Slice(o_key, o_key_length), Slice(before), std::nullopt);
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeVI::update(u8* o_key, u16 o_key_length, u8* o_value, u16 o_value_length)
+{
+   std::basic_string<u8> before;
+   if (secondary_indexes.empty() || !lookupCopy(o_key, o_key_length, before)) {
+      return updatePrimary(o_key, o_key_length, o_value, o_value_length);
+   }
+   const OP_RESULT ret = updatePrimary(o_key, o_key_length, o_value, o_value_length);
+   if (ret != OP_RESULT::OK) {
+      return ret;
+   }
+   return maintainSecondaryIndexes(Slice(o_key, o_key_length), Slice(before), Slice(o_value, o_value_length));
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeVI::upsert(u8* o_key, u16 o_key_length, u8* o_value, u16 o_value_length)
+{
+   if (secondary_indexes.empty()) {
+      return upsertPrimary(o_key, o_key_length, o_value, o_value_length);
+   }
+   std::basic_string<u8> before;
+   const bool existed = lookupCopy(o_key, o_key_length, before);
+   const OP_RESULT ret = upsertPrimary(o_key, o_key_length, o_value, o_value_length);
+   if (ret != OP_RESULT::OK) {
+      return ret;
+   }
+   return maintainSecondaryIndexes(Slice(o_key, o_key_length), existed ? std::optional<Slice>(before) : std::nullopt,
+                                   Slice(o_value, o_value_length));
+}
+// -------------------------------------------------------------------------------------
+// Entries whose secondary key did not change are left alone. New entries are upserted, which also revives an entry that was
+// removed but is not garbage collected yet, e.g. when a transaction moves the secondary key A -> B -> A
+OP_RESULT BTreeVI::maintainSecondaryIndexes(Slice key, std::optional<Slice> before, std::optional<Slice> after)
+{
+   u8 before_key[max_secondary_key_length + key.length()];
+   u8 after_key[max_secondary_key_length + key.length()];
+   for (auto& index : secondary_indexes) {
+      u16 before_length = 0, after_length = 0;
+      if (before) {
+         before_length = index.extract(key, *before, before_key);
+         ensure(before_length <= max_secondary_key_length);
+         std::memcpy(before_key + before_length, key.data(), key.length());
+         before_length += key.length();
+      }
+      if (after) {
+         after_length = index.extract(key, *after, after_key);
+         ensure(after_length <= max_secondary_key_length);
+         std::memcpy(after_key + after_length, key.data(), key.length());
+         after_length += key.length();
+      }
+      if (before && after && Slice(before_key, before_length) == Slice(after_key, after_length)) {
+         continue;
+      }
+      // -------------------------------------------------------------------------------------
+      if (before) {
+         const OP_RESULT ret = index.tree->remove(before_key, before_length);
+         // NOT_FOUND: the tuple is older than the index
+         if (ret != OP_RESULT::OK && ret != OP_RESULT::NOT_FOUND) {
+            return ret;
+         }
+      }
+      if (after) {
+         u8* primary_key = after_key + after_length - key.length();
+         const OP_RESULT ret = index.tree->upsert(after_key, after_length, primary_key, key.length());
+         if (ret != OP_RESULT::OK) {
+            return ret;
+         }
+      }
+   }
+   return OP_RESULT::OK;
+}
+// -------------------------------------------------------------------------------------
+bool BTreeVI::lookupCopy(u8* key, u16 key_length, std::basic_string<u8>& value)
+{
+   return lookup(key, key_length, [&](const u8* payload, u16 payload_length) { value.assign(payload, payload_length); }) == OP_RESULT::OK;
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeVI::scanIndexAsc(u64 index_id, u8* start_key, u16 start_key_length, IndexScanCallback callback)
+{
+   return secondary_indexes[index_id].tree->scanAsc(
+       start_key, start_key_length,
+       [&](const u8* key, u16 key_length, const u8* primary_key, u16 primary_key_length) {
+          return callback(key, key_length - primary_key_length, primary_key, primary_key_length);
+       },
+       [&]() {});
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeVI::scanIndexDesc(u64 index_id, u8* start_key, u16 start_key_length, IndexScanCallback callback)
+{
+   return secondary_indexes[index_id].tree->scanDesc(
+       start_key, start_key_length,
+       [&](const u8* key, u16 key_length, const u8* primary_key, u16 primary_key_length) {
+          return callback(key, key_length - primary_key_length, primary_key, primary_key_length);
+       },
+       [&]() {});
+}
+// -------------------------------------------------------------------------------------
+void BTreeVI::lookupBatch(std::vector<std::string>& primary_keys, utils::FunctionRef<void(Slice primary_key, Slice value)> callback)
+{
+   // std::string compares its bytes unsigned, like the tree
+   std::sort(primary_keys.begin(), primary_keys.end());
+   primary_keys.erase(std::unique(primary_keys.begin(), primary_keys.end()), primary_keys.end());
+   for (auto& primary_key : primary_keys) {
+      u8* key = reinterpret_cast<u8*>(primary_key.data());
+      const u16 key_length = primary_key.length();
+      lookup(key, key_length, [&](const u8* value, u16 value_length) { callback(Slice(key, key_length), Slice(value, value_length)); });
+   }
+}
+// -------------------------------------------------------------------------------------
+}  // namespace btree
+}  // namespace storage
+}  // namespace leanstore
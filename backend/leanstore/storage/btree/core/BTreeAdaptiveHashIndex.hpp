@@ -0,0 +1,107 @@
+#pragma once
+#include "BTreeNode.hpp"
+#include "Units.hpp"
+#include "leanstore/profiling/counters/WorkerCounters.hpp"
+#include "leanstore/storage/buffer-manager/BufferFrame.hpp"
+#include "leanstore/sync-primitives/PageGuard.hpp"
+#include "leanstore/utils/FNVHash.hpp"
+#include "leanstore/utils/Misc.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <atomic>
+#include <memory>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace btree
+{
+// -------------------------------------------------------------------------------------
+// Maps hot keys to the leaf and slot that held them when they were last looked up, so that repeated point lookups skip
+// the descent from the root. Entries are only hints and are never explicitly invalidated: a lookup latches the recorded
+// frame optimistically and uses it only if it still holds a leaf of this tree that contains the key.
+// Splits, merges and evictions either move the key out of the frame or turn the frame into another page, so stale entries
+// fail this check and get refreshed by the next descent. Entries are written without synchronization, a torn entry is
+// just another stale one
+class BTreeAdaptiveHashIndex
+{
+  public:
+   struct Entry {
+      atomic<u64> key_hash = 0;
+      atomic<BufferFrame*> bf = nullptr;  // nullptr: the key was seen once, the next lookup fills the entry
+      atomic<u16> slot = 0;
+   };
+   // -------------------------------------------------------------------------------------
+   const DTID dt_id;
+   const u64 mask;
+   std::unique_ptr<Entry[]> entries;
+   // -------------------------------------------------------------------------------------
+   BTreeAdaptiveHashIndex(DTID dt_id, u64 entries_count)
+       : dt_id(dt_id), mask((1ull << utils::getBitsNeeded(entries_count - 1)) - 1), entries(std::make_unique<Entry[]>(mask + 1))
+   {
+   }
+   // -------------------------------------------------------------------------------------
+   static inline u64 hash(const u8* key, u16 key_length) { return utils::FNV::hash(key, key_length); }
+   inline Entry& entry(u64 key_hash) { return entries[key_hash & mask]; }
+   // -------------------------------------------------------------------------------------
+   // On a hit, leaf is an optimistic guard on a leaf of this tree that holds the key at pos. The caller rechecks it after reading
+   bool lookup(HybridPageGuard<BTreeNode>& leaf, s16& pos, const u8* key, u16 key_length, u64 key_hash)
+   {
+      Entry& e = entry(key_hash);
+      BufferFrame* bf = e.bf.load(std::memory_order_relaxed);
+      if (bf == nullptr || e.key_hash.load(std::memory_order_relaxed) != key_hash) {
+         COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_ahi_miss[dt_id]++; }
+         return false;
+      }
+      const u64 version = bf->header.latch.ref().load();
+      if ((version & LATCH_EXCLUSIVE_BIT) == LATCH_EXCLUSIVE_BIT) {
+         COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_ahi_miss[dt_id]++; }
+         return false;
+      }
+      leaf = HybridPageGuard<BTreeNode>(Guard(bf->header.latch, version), bf);
+      // Whatever we read before the recheck may be garbage, it only decides between using the frame and descending
+      pos = -1;
+      if (bf->header.state == BufferFrame::STATE::HOT && bf->page.dt_id == dt_id && leaf->is_leaf &&
+          leaf->compareKeyWithBoundaries(key, key_length) == 0) {
+         // Keys within the fences share the prefix, so only the rest of the key is compared
+         const u16 slot = e.slot.load(std::memory_order_relaxed);
+         if (slot < leaf->count && leaf->getFullKeyLen(slot) == key_length &&
+             std::memcmp(leaf->getKey(slot), key + leaf->prefix_length, leaf->getKeyLen(slot)) == 0) {
+            pos = slot;
+         } else {
+            // The leaf still covers the key but its slots moved since the entry was recorded
+            pos = leaf->lowerBound<true>(key, key_length);
+            if (pos != -1) {
+               e.slot.store(pos, std::memory_order_relaxed);
+            }
+         }
+      }
+      if (pos == -1) {
+         COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_ahi_miss[dt_id]++; }
+         return false;
+      }
+      leaf.recheck();
+      leaf.syncGSN();
+      COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_ahi_hit[dt_id]++; }
+      return true;
+   }
+   // -------------------------------------------------------------------------------------
+   // Called after a descent found the key at pos in the (rechecked) leaf bf. Keys are only recorded on their second lookup
+   // so that a stream of cold keys does not keep overwriting the entries of hot ones
+   void admit(BufferFrame* bf, u16 pos, u64 key_hash)
+   {
+      Entry& e = entry(key_hash);
+      if (e.key_hash.load(std::memory_order_relaxed) != key_hash) {
+         e.key_hash.store(key_hash, std::memory_order_relaxed);
+         e.bf.store(nullptr, std::memory_order_relaxed);
+         return;
+      }
+      e.slot.store(pos, std::memory_order_relaxed);
+      e.bf.store(bf, std::memory_order_relaxed);
+   }
+};
+// -------------------------------------------------------------------------------------
+}  // namespace btree
+}  // namespace storage
+}  // namespace leanstore
@@ -0,0 +1,159 @@
+#pragma once
+#include "Units.hpp"
+#include "leanstore/storage/buffer-manager/BufferFrame.hpp"
+#include "leanstore/storage/buffer-manager/Swip.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace btree
+{
+// -------------------------------------------------------------------------------------
+template <typename KeyT, typename ValueT>
+struct BTreeFixedNode;
+// -------------------------------------------------------------------------------------
+template <typename KeyT, typename ValueT>
+struct BTreeFixedNodeHeader {
+   Swip<BTreeFixedNode<KeyT, ValueT>> upper = nullptr;  // rightmost child of inner nodes, the meta node points to the root with it
+   KeyT lower_fence = 0;                                 // exclusive
+   KeyT upper_fence = 0;                                 // inclusive
+   u16 count = 0;
+   bool is_leaf;
+   bool lower_fence_infinity = true;
+   bool upper_fence_infinity = true;
+   // -------------------------------------------------------------------------------------
+   BTreeFixedNodeHeader(bool is_leaf) : is_leaf(is_leaf) {}
+};
+// -------------------------------------------------------------------------------------
+// Node of a B-Tree with fixed-width integer keys: a sorted key array followed by a value array (leaf) or a child swip array (inner).
+// Both capacities are known at compile time, so there are no slots, offsets, prefixes or heads to decode.
+// Inner nodes follow BTreeNode: keys[i] is the largest key in children[i], upper holds everything greater than keys[count - 1]
+template <typename KeyT, typename ValueT>
+struct BTreeFixedNode : public BTreeFixedNodeHeader<KeyT, ValueT> {
+   static_assert(std::is_integral_v<KeyT>, "BTreeFixed supports integral keys only");
+   static_assert(std::is_trivially_copyable_v<ValueT>, "BTreeFixed stores values by memcpy");
+   // -------------------------------------------------------------------------------------
+   using Header = BTreeFixedNodeHeader<KeyT, ValueT>;
+   using ChildSwip = Swip<BTreeFixedNode>;
+   static_assert(alignof(ValueT) <= alignof(Header), "");
+   // -------------------------------------------------------------------------------------
+   static constexpr u64 data_size = EFFECTIVE_PAGE_SIZE - sizeof(Header);
+   static constexpr u64 alignUp(u64 offset, u64 alignment) { return (offset + alignment - 1) / alignment * alignment; }
+   static constexpr u16 capacityFor(u64 entry_size, u64 entry_alignment)
+   {
+      u64 capacity = data_size / (sizeof(KeyT) + entry_size);
+      while (alignUp(capacity * sizeof(KeyT), entry_alignment) + capacity * entry_size > data_size) {
+         capacity--;
+      }
+      return capacity;
+   }
+   static constexpr u16 leaf_capacity = capacityFor(sizeof(ValueT), alignof(ValueT));
+   static constexpr u16 inner_capacity = capacityFor(sizeof(ChildSwip), alignof(ChildSwip));
+   static constexpr u64 leaf_values_offset = alignUp(leaf_capacity * sizeof(KeyT), alignof(ValueT));
+   static constexpr u64 inner_children_offset = alignUp(inner_capacity * sizeof(KeyT), alignof(ChildSwip));
+   static_assert(leaf_capacity >= 4, "ValueT is too large for a BTreeFixed leaf");
+   // -------------------------------------------------------------------------------------
+   alignas(alignof(Header)) u8 data[data_size];  // without alignas the array would start in the tail padding of Header
+   // -------------------------------------------------------------------------------------
+   BTreeFixedNode(bool is_leaf) : Header(is_leaf) {}
+   // -------------------------------------------------------------------------------------
+   inline KeyT* keys() { return reinterpret_cast<KeyT*>(data); }
+   inline ValueT* values() { return reinterpret_cast<ValueT*>(data + leaf_values_offset); }
+   inline ChildSwip* children() { return reinterpret_cast<ChildSwip*>(data + inner_children_offset); }
+   inline u16 capacity() { return this->is_leaf ? leaf_capacity : inner_capacity; }
+   inline bool isFull() { return this->count >= capacity(); }
+   inline ChildSwip& getChild(u16 pos) { return (pos == this->count) ? this->upper : children()[pos]; }
+   // -------------------------------------------------------------------------------------
+   // Branchless binary search: the trip count only depends on count and the comparison compiles to a conditional move.
+   // count is clamped because optimistic readers may observe it while a writer is changing the node
+   inline u16 lowerBound(KeyT key)
+   {
+      const KeyT* base = keys();
+      u16 length = std::min(this->count, capacity());
+      if (length == 0) {
+         return 0;
+      }
+      while (length > 1) {
+         const u16 half = length / 2;
+         base = (base[half] < key) ? base + half : base;
+         length -= half;
+      }
+      return (base - keys()) + (*base < key);
+   }
+   // Returns the position of key or -1
+   inline s16 find(KeyT key)
+   {
+      const u16 pos = lowerBound(key);
+      return (pos < this->count && keys()[pos] == key) ? pos : -1;
+   }
+   inline ChildSwip& lookupInner(KeyT key) { return getChild(lowerBound(key)); }
+   // -------------------------------------------------------------------------------------
+   void insert(u16 pos, KeyT key, const ValueT& value)
+   {
+      assert(this->is_leaf && !isFull() && pos <= this->count);
+      std::memmove(keys() + pos + 1, keys() + pos, (this->count - pos) * sizeof(KeyT));
+      std::memmove(values() + pos + 1, values() + pos, (this->count - pos) * sizeof(ValueT));
+      keys()[pos] = key;
+      std::memcpy(values() + pos, &value, sizeof(ValueT));
+      this->count++;
+   }
+   void insertSeparator(u16 pos, KeyT key, BufferFrame* child)
+   {
+      assert(!this->is_leaf && !isFull() && pos <= this->count);
+      std::memmove(keys() + pos + 1, keys() + pos, (this->count - pos) * sizeof(KeyT));
+      std::memmove(children() + pos + 1, children() + pos, (this->count - pos) * sizeof(ChildSwip));
+      keys()[pos] = key;
+      children()[pos] = child;
+      this->count++;
+   }
+   void remove(u16 pos)
+   {
+      assert(this->is_leaf && pos < this->count);
+      std::memmove(keys() + pos, keys() + pos + 1, (this->count - pos - 1) * sizeof(KeyT));
+      std::memmove(values() + pos, values() + pos + 1, (this->count - pos - 1) * sizeof(ValueT));
+      this->count--;
+   }
+   // -------------------------------------------------------------------------------------
+   // Moves everything up to keys[sep_pos] into new_left and posts keys[sep_pos] as separator into parent.
+   // In inner nodes the separator's child becomes new_left->upper
+   void split(BTreeFixedNode& parent, BTreeFixedNode& new_left, BufferFrame* new_left_bf, u16 sep_pos)
+   {
+      assert(sep_pos < this->count - 1);
+      const KeyT sep_key = keys()[sep_pos];
+      new_left.lower_fence = this->lower_fence;
+      new_left.lower_fence_infinity = this->lower_fence_infinity;
+      new_left.upper_fence = sep_key;
+      new_left.upper_fence_infinity = false;
+      const u16 right_begin = sep_pos + 1;
+      const u16 right_count = this->count - right_begin;
+      if (this->is_leaf) {
+         new_left.count = sep_pos + 1;
+         std::memcpy(new_left.keys(), keys(), new_left.count * sizeof(KeyT));
+         std::memcpy(new_left.values(), values(), new_left.count * sizeof(ValueT));
+         std::memmove(values(), values() + right_begin, right_count * sizeof(ValueT));
+      } else {
+         new_left.count = sep_pos;
+         std::memcpy(new_left.keys(), keys(), new_left.count * sizeof(KeyT));
+         std::memcpy(new_left.children(), children(), new_left.count * sizeof(ChildSwip));
+         new_left.upper = children()[sep_pos];
+         std::memmove(children(), children() + right_begin, right_count * sizeof(ChildSwip));
+      }
+      std::memmove(keys(), keys() + right_begin, right_count * sizeof(KeyT));
+      this->count = right_count;
+      this->lower_fence = sep_key;
+      this->lower_fence_infinity = false;
+      parent.insertSeparator(parent.lowerBound(sep_key), sep_key, new_left_bf);
+   }
+};
+static_assert(sizeof(BTreeFixedNode<u64, u64>) == EFFECTIVE_PAGE_SIZE, "");
+// -------------------------------------------------------------------------------------
+}  // namespace btree
+}  // namespace storage
+}  // namespace leanstore
@@ -17,6 +17,9 @@ void BTreeGeneric::create(DTID dtid, Config config)
 {
    this->dt_id = dtid;
    this->config = config;
+   if (FLAGS_btree_ahi) {
+      ahi = std::make_unique<BTreeAdaptiveHashIndex>(dt_id, FLAGS_btree_ahi_entries);
+   }
    // -------------------------------------------------------------------------------------
    meta_node_bf = &BMC::global_bf->allocatePage();
    Guard guard(meta_node_bf.asBufferFrame().header.latch, GUARD_STATE::EXCLUSIVE);
@@ -38,7 +41,7 @@ void BTreeGeneric::create(DTID dtid, Config config)
    meta_page.incrementGSN();
 }
 // -------------------------------------------------------------------------------------
-void BTreeGeneric::trySplit(BufferFrame& to_split, s16 favored_split_pos)
+void BTreeGeneric::trySplit(BufferFrame& to_split, s16 favored_split_pos, Slice key_hint)
 {
    cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
    auto parent_handler = findParentEager(*this, to_split);
@@ -47,6 +50,11 @@ void BTreeGeneric::trySplit(BufferFrame& to_split, s16 favored_split_pos)
    if (c_guard->count <= 1)
       return;
    // -------------------------------------------------------------------------------------
+   bool skewed = false;
+   if (favored_split_pos < 0 && FLAGS_btree_skewed_splits && key_hint.data() != nullptr && !config.use_bulk_insert) {
+      favored_split_pos = skewedSplitPos(c_guard, key_hint);
+      skewed = favored_split_pos >= 0;
+   }
    BTreeNode::SeparatorInfo sep_info;
    if (favored_split_pos < 0 || favored_split_pos >= c_guard->count - 1) {
       if (config.use_bulk_insert) {
@@ -56,7 +64,7 @@ void BTreeGeneric::trySplit(BufferFrame& to_split, s16 favored_split_pos)
          sep_info = c_guard->findSep();
       }
    } else {
-      // Split on a specified position, used by contention management
+      // Split on a specified position, used by contention management and skewed splits
       sep_info = BTreeNode::SeparatorInfo{c_guard->getFullKeyLen(favored_split_pos), static_cast<u16>(favored_split_pos), false};
    }
    u8 sep_key[sep_info.length];
@@ -127,7 +135,11 @@ void BTreeGeneric::trySplit(BufferFrame& to_split, s16 favored_split_pos)
       }
       // -------------------------------------------------------------------------------------
       height++;
-      COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_split[dt_id]++; }
+      COUNTERS_BLOCK()
+      {
+         WorkerCounters::myCounters().dt_split[dt_id]++;
+         WorkerCounters::myCounters().dt_split_skewed[dt_id] += skewed;
+      }
       return;
    } else {
       // Parent is not root
@@ -194,13 +206,39 @@ void BTreeGeneric::trySplit(BufferFrame& to_split, s16 favored_split_pos)
          } else {
             exec();
          }
-         COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_split[dt_id]++; }
+         COUNTERS_BLOCK()
+         {
+            WorkerCounters::myCounters().dt_split[dt_id]++;
+            WorkerCounters::myCounters().dt_split_skewed[dt_id] += skewed;
+         }
       } else {
          p_guard.unlock();
          c_guard.unlock();
-         trySplit(*p_guard.bf);  // Must split parent head to make space for separator
+         trySplit(*p_guard.bf, -1, key_hint);  // Must split parent head to make space for separator
+      }
+   }
+}
+// -------------------------------------------------------------------------------------
+// Middle splits leave nodes half empty when keys only grow. When the key that did not fit sorts behind the last entry, the
+// rightmost node of a level keeps all but its last entry on the left (monotonic keys never come back to it). Any other node
+// only does so after the previous splits of the tree were of the same kind, i.e. ascending keys within hot spots such as
+// one district, and keeps 10% free for stragglers. Returns -1 for a regular split
+s16 BTreeGeneric::skewedSplitPos(HybridPageGuard<BTreeNode>& node, Slice key_hint)
+{
+   if (node->lowerBound<false>(key_hint.data(), key_hint.length()) < node->count) {
+      if (append_splits.load(std::memory_order_relaxed) != 0) {
+         append_splits.store(0, std::memory_order_relaxed);
       }
+      return -1;
+   }
+   const u64 previous_append_splits = append_splits.fetch_add(1, std::memory_order_relaxed);
+   if (node->upper_fence.offset == 0) {
+      return node->count - 2;
    }
+   if (previous_append_splits >= 2) {
+      return std::min<s16>(node->count * 9 / 10, node->count - 2);
+   }
+   return -1;
 }
 // -------------------------------------------------------------------------------------
 struct ParentSwipHandler BTreeGeneric::findParentJump(BTreeGeneric& btree, BufferFrame& to_find)
@@ -384,7 +422,8 @@ s16 BTreeGeneric::mergeLeftIntoRight(ExclusivePageGuard<BTreeNode>& parent,
       return 0;  // false
    // -------------------------------------------------------------------------------------
    {
-      BTreeNode tmp(true);
+      BTreeNode tmp(true, to_right->headsCapacityFor(copy_from_count + to_right->count),
+                    to_right->fingerprintsCapacityFor(copy_from_count + to_right->count));
       tmp.setFences(new_left_uf_key, new_left_uf_length, to_right->getUpperFenceKey(), to_right->upper_fence.length);
       // -------------------------------------------------------------------------------------
       from_left->copyKeyValueRange(&tmp, 0, till_slot_id, copy_from_count);
@@ -396,7 +435,8 @@ s16 BTreeGeneric::mergeLeftIntoRight(ExclusivePageGuard<BTreeNode>& parent,
       assert(to_right->compareKeyWithBoundaries(new_left_uf_key, new_left_uf_length) == 1);
    }
    {
-      BTreeNode tmp(true);
+      BTreeNode tmp(true, from_left->headsCapacityFor(from_left->count - copy_from_count),
+                    from_left->fingerprintsCapacityFor(from_left->count - copy_from_count));
       tmp.setFences(from_left->getLowerFenceKey(), from_left->lower_fence.length, new_left_uf_key, new_left_uf_length);
       // -------------------------------------------------------------------------------------
       from_left->copyKeyValueRange(&tmp, 0, 0, from_left->count - copy_from_count);
@@ -506,6 +546,37 @@ BTreeGeneric::XMergeReturnCode BTreeGeneric::XMerge(HybridPageGuard<BTreeNode>&
    return ret_code;
 }
 // -------------------------------------------------------------------------------------
+bool BTreeGeneric::tryShrinkHeight()
+{
+   jumpmuTry()
+   {
+      HybridPageGuard<BTreeNode> meta_guard(meta_node_bf);
+      HybridPageGuard<BTreeNode> root_guard(meta_guard, meta_guard->upper);
+      if (root_guard->is_leaf || root_guard->count > 0) {
+         jumpmu_return false;
+      }
+      HybridPageGuard<BTreeNode> child_guard(root_guard, root_guard->upper);
+      auto meta_x_guard = ExclusivePageGuard(std::move(meta_guard));
+      auto root_x_guard = ExclusivePageGuard(std::move(root_guard));
+      auto child_x_guard = ExclusivePageGuard(std::move(child_guard));
+      // The child of a root without separators has no fences, it can become the root as it is
+      assert(child_x_guard->lower_fence.length == 0 && child_x_guard->upper_fence.length == 0);
+      if (config.enable_wal) {
+         meta_x_guard.incrementGSN();
+         child_x_guard.incrementGSN();
+      } else {
+         meta_x_guard.markAsDirty();
+         child_x_guard.markAsDirty();
+      }
+      meta_x_guard->upper = root_x_guard->upper;
+      root_x_guard.reclaim();
+      height--;
+      jumpmu_return true;
+   }
+   jumpmuCatch() {}
+   return false;
+}
+// -------------------------------------------------------------------------------------
 BTreeGeneric::~BTreeGeneric() {}
 // -------------------------------------------------------------------------------------
 // Called by buffer manager before eviction
@@ -516,8 +587,11 @@ SpaceCheckResult BTreeGeneric::checkSpaceUtilization(void* btree_object, BufferF
    if (!FLAGS_xmerge) {
       return SpaceCheckResult::NOTHING;
    }
-   // -------------------------------------------------------------------------------------
-   auto& btree = *reinterpret_cast<BTreeGeneric*>(btree_object);
+   return compactPage(*reinterpret_cast<BTreeGeneric*>(btree_object), bf);
+}
+// -------------------------------------------------------------------------------------
+SpaceCheckResult BTreeGeneric::compactPage(BTreeGeneric& btree, BufferFrame& bf)
+{
    ParentSwipHandler parent_handler = btree.findParentJump(btree, bf);
    HybridPageGuard<BTreeNode> p_guard = parent_handler.getParentReadPageGuard<BTreeNode>();
    HybridPageGuard<BTreeNode> c_guard(p_guard, parent_handler.swip.cast<BTreeNode>(), LATCH_FALLBACK_MODE::JUMP);
@@ -563,6 +637,9 @@ void BTreeGeneric::deserialize(BTreeGeneric& btree, std::unordered_map<std::stri
 {
    btree.dt_id = std::stol(map["dt_id"]);
    btree.height = std::stol(map["height"]);
+   if (FLAGS_btree_ahi) {
+      btree.ahi = std::make_unique<BTreeAdaptiveHashIndex>(btree.dt_id, FLAGS_btree_ahi_entries);
+   }
    btree.meta_node_bf.evict(std::stol(map["meta_pid"]));
    HybridLatch dummy_latch;
    Guard dummy_guard(&dummy_latch);
@@ -1,4 +1,5 @@
 #pragma once
+#include "BTreeAdaptiveHashIndex.hpp"
 #include "BTreeIteratorInterface.hpp"
 #include "BTreeNode.hpp"
 #include "leanstore/Config.hpp"
@@ -25,6 +26,8 @@ enum class WAL_LOG_TYPE : u8 {
    WALRemove = 3,
    WALAfterBeforeImage = 4,
    WALAfterImage = 5,
+   WALReplace = 6,
+   WALMerge = 7,
    WALLogicalSplit = 10,
    WALInitPage = 11
 };
@@ -54,8 +57,11 @@ class BTreeGeneric
    struct Config {
       bool enable_wal = true;
       bool use_bulk_insert = false;
+      bool separate_values = false;  // BTreeLL only: values go to a blob::ValueLog, leaves keep pointers to them
    };
    Config config;
+   std::unique_ptr<BTreeAdaptiveHashIndex> ahi;  // only with FLAGS_btree_ahi
+   atomic<u64> append_splits = 0;                // consecutive splits caused by keys behind the last entry, see skewedSplitPos
    // -------------------------------------------------------------------------------------
    BTreeGeneric() = default;
    // -------------------------------------------------------------------------------------
@@ -63,7 +69,9 @@ class BTreeGeneric
    // -------------------------------------------------------------------------------------
    bool tryMerge(BufferFrame& to_split, bool swizzle_sibling = true);
    // -------------------------------------------------------------------------------------
-   void trySplit(BufferFrame& to_split, s16 pos = -1);
+   // key_hint: the key that did not fit, lets FLAGS_btree_skewed_splits recognize ascending inserts
+   void trySplit(BufferFrame& to_split, s16 pos = -1, Slice key_hint = {});
+   s16 skewedSplitPos(HybridPageGuard<BTreeNode>& node, Slice key_hint);
    s16 mergeLeftIntoRight(ExclusivePageGuard<BTreeNode>& parent,
                           s16 left_pos,
                           ExclusivePageGuard<BTreeNode>& from_left,
@@ -71,8 +79,11 @@ class BTreeGeneric
                           bool full_merge_or_nothing);
    enum class XMergeReturnCode : u8 { NOTHING, FULL_MERGE, PARTIAL_MERGE };
    XMergeReturnCode XMerge(HybridPageGuard<BTreeNode>& p_guard, HybridPageGuard<BTreeNode>& c_guard, ParentSwipHandler&);
+   // Replaces a root without separators by its only child
+   bool tryShrinkHeight();
    // -------------------------------------------------------------------------------------
    static SpaceCheckResult checkSpaceUtilization(void* btree_object, BufferFrame&);
+   static SpaceCheckResult compactPage(BTreeGeneric& btree, BufferFrame& bf);  // checkSpaceUtilization without the FLAGS_xmerge check
    static ParentSwipHandler findParent(BTreeGeneric& btree_object, BufferFrame& to_find);
    static void iterateChildrenSwips(void* btree_object, BufferFrame& bf, std::function<bool(Swip<BufferFrame>&)> callback);
    static void checkpoint(BTreeGeneric&, BufferFrame& bf, u8* dest);
@@ -106,6 +117,28 @@ class BTreeGeneric
       p_guard.unlock();
    }
    // -------------------------------------------------------------------------------------
+   // Point lookups: returns the position of key in the optimistically latched leaf or -1.
+   // Hot keys skip the descent through the adaptive hash index
+   inline s16 findLeafAndSlotCanJump(HybridPageGuard<BTreeNode>& target_guard, const u8* key, const u16 key_length)
+   {
+      if (!ahi) {
+         findLeafCanJump(target_guard, key, key_length);
+         return target_guard->lowerBound<true>(key, key_length);
+      }
+      const u64 key_hash = BTreeAdaptiveHashIndex::hash(key, key_length);
+      s16 pos;
+      if (ahi->lookup(target_guard, pos, key, key_length, key_hash)) {
+         return pos;
+      }
+      findLeafCanJump(target_guard, key, key_length);
+      pos = target_guard->lowerBound<true>(key, key_length);
+      if (pos != -1) {
+         target_guard.recheck();
+         ahi->admit(target_guard.bf, pos, key_hash);
+      }
+      return pos;
+   }
+   // -------------------------------------------------------------------------------------
    template <LATCH_FALLBACK_MODE mode = LATCH_FALLBACK_MODE::SHARED>
    void findLeafAndLatch(HybridPageGuard<BTreeNode>& target_guard, const u8* key, u16 key_length)
    {
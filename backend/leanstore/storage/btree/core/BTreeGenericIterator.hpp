@@ -38,7 +38,65 @@ class BTreePessimisticIterator : public BTreePessimisticIteratorInterface
    u16 fence_length = 0;
    bool is_using_upper_fence;
    // -------------------------------------------------------------------------------------
+   // Read-ahead (FLAGS_scan_readahead_max): whenever next() leaves a leaf, the following readahead_depth children of p_guard
+   // are loaded asynchronously. The depth doubles when the scan catches up with the reads and shrinks by one when it does not
+   u64 readahead_depth = 1;
+   BufferFrame* readahead_parent = nullptr;
+   u64 readahead_parent_version = 0;
+   s32 readahead_until = -1;                         // last position in readahead_parent that was considered
+   std::vector<std::pair<s32, PID>> readahead_pids;  // reads issued for positions right of the current leaf
+   // -------------------------------------------------------------------------------------
   protected:
+   void readAhead()
+   {
+      jumpmuTry()
+      {
+         if (readahead_parent != p_guard.bf || readahead_parent_version != p_guard.guard.version) {
+            cancelReadAhead();
+            readahead_parent = p_guard.bf;
+            readahead_parent_version = p_guard.guard.version;
+            readahead_until = leaf_pos_in_parent;
+         }
+         while (!readahead_pids.empty() && readahead_pids.front().first <= leaf_pos_in_parent) {
+            readahead_pids.erase(readahead_pids.begin());
+         }
+         const s32 count = p_guard->count;
+         auto child = [&](s32 pos) -> Swip<BufferFrame>& {
+            return ((pos < count) ? p_guard->getChild(pos) : p_guard->upper).template cast<BufferFrame>();
+         };
+         if (leaf_pos_in_parent + 1 <= count) {
+            Swip<BufferFrame>& next_swip = child(leaf_pos_in_parent + 1);
+            if (next_swip.isEVICTED()) {
+               const PID pid = next_swip.asPageID();
+               p_guard.recheck();
+               if (BMC::global_bf->isPageReady(pid)) {
+                  readahead_depth = std::max<u64>(readahead_depth - 1, 1);
+               } else {
+                  readahead_depth = std::min<u64>(readahead_depth * 2, FLAGS_scan_readahead_max);
+                  COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_readahead_stalls[btree.dt_id]++; }
+               }
+            }
+         }
+         const s32 until = std::min<s32>(leaf_pos_in_parent + readahead_depth, count);
+         for (s32 pos = std::max(readahead_until, leaf_pos_in_parent) + 1; pos <= until; pos++) {
+            Swip<BufferFrame>& c_swip = child(pos);
+            const PID pid = c_swip.asPageID();
+            if (BMC::global_bf->prefetchSwip(p_guard.guard, c_swip)) {
+               readahead_pids.push_back({pos, pid});
+               COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_readahead_pages[btree.dt_id]++; }
+            }
+            readahead_until = pos;
+         }
+      }
+      jumpmuCatch() {}
+   }
+   void cancelReadAhead()
+   {
+      for (const auto& [pos, pid] : readahead_pids) {
+         BMC::global_bf->cancelPrefetch(pid);
+      }
+      readahead_pids.clear();
+   }
    // We need a custom findLeafAndLatch to track the position in parent node
    template <LATCH_FALLBACK_MODE mode = LATCH_FALLBACK_MODE::SHARED>
    void findLeafAndLatch(HybridPageGuard<BTreeNode>& target_guard, const u8* key, u16 key_length)
@@ -112,6 +170,13 @@ class BTreePessimisticIterator : public BTreePessimisticIteratorInterface
    // -------------------------------------------------------------------------------------
   public:
    BTreePessimisticIterator(BTreeGeneric& btree, const LATCH_FALLBACK_MODE mode = LATCH_FALLBACK_MODE::SHARED) : btree(btree), mode(mode) {}
+   ~BTreePessimisticIterator()
+   {
+      // The scan stopped early, do not let pages that nobody is going to look at occupy frames
+      if (!readahead_pids.empty()) {
+         cancelReadAhead();
+      }
+   }
    // -------------------------------------------------------------------------------------
    void enterLeafCallback(std::function<void(HybridPageGuard<BTreeNode>& leaf)> cb) { enter_leaf_cb = cb; }
    void exitLeafCallback(std::function<void(HybridPageGuard<BTreeNode>& leaf)> cb) { exit_leaf_cb = cb; }
@@ -208,6 +273,10 @@ class BTreePessimisticIterator : public BTreePessimisticIteratorInterface
                cleanup_cb = nullptr;
             }
             // -------------------------------------------------------------------------------------
+            if (FLAGS_scan_readahead_max && leaf_pos_in_parent != -1) {
+               readAhead();
+            }
+            // -------------------------------------------------------------------------------------
             if (FLAGS_optimistic_scan && leaf_pos_in_parent != -1) {
                jumpmuTry()
                {
@@ -462,7 +531,7 @@ class BTreeExclusiveIterator : public BTreePessimisticIterator
             leaf.unlock();
             cur = -1;
             // -------------------------------------------------------------------------------------
-            btree.trySplit(*bf);
+            btree.trySplit(*bf, -1, key);
             jumpmu_break;
          }
          jumpmuCatch() {}
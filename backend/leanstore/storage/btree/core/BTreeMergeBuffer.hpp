@@ -0,0 +1,150 @@
+#pragma once
+#include "Units.hpp"
+#include "leanstore/KVInterface.hpp"
+#include "leanstore/utils/FNVHash.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace btree
+{
+// -------------------------------------------------------------------------------------
+// Merge operands that were written blindly and not applied to the tree yet. Each worker collects its operands in its own stripe,
+// combining repeated merges into the same key into one operand. Readers of a key take the pending operands of all stripes and
+// apply them before they look at the tree (see BTreeLL::foldPendingMerges).
+// The filter counts the pending keys per hash slot, so readers of keys without pending merges only pay for one atomic load
+class BTreeMergeBuffer
+{
+  public:
+   struct Operand {
+      MergeOperator op;
+      std::string bytes;
+   };
+   // -------------------------------------------------------------------------------------
+   static constexpr u64 filter_slots = 1 << 12;
+   static constexpr u64 fold_latches = 64;
+   // -------------------------------------------------------------------------------------
+   BTreeMergeBuffer(u64 stripes_count) : stripes_count(stripes_count), stripes(std::make_unique<Stripe[]>(stripes_count)) {}
+   // -------------------------------------------------------------------------------------
+   static inline u64 hash(Slice key) { return utils::FNV::hash(key.data(), key.length()); }
+   inline bool empty() const { return pending_keys.load(std::memory_order_acquire) == 0; }
+   inline bool mayBePending(Slice key) const { return !empty() && filter[hash(key) % filter_slots].load(std::memory_order_acquire) != 0; }
+   // Serializes the folding of keys in the same slot, a key is never applied twice or out of order
+   inline std::mutex& foldLatch(u64 key_hash) { return fold_mutexes[key_hash % fold_latches]; }
+   // -------------------------------------------------------------------------------------
+   // Combines the operand with the one pending for key in the stripe and returns the number of keys pending in the stripe.
+   // Returns 0 without doing anything when the key has a pending operand of another operator, the caller folds the key first
+   u64 add(u64 stripe_i, Slice key, u64 key_hash, MergeOperator op, Slice operand)
+   {
+      Stripe& stripe = stripes[stripe_i];
+      std::unique_lock<std::mutex> guard(stripe.mutex);
+      auto [it, inserted] = stripe.pending.try_emplace(std::string(reinterpret_cast<const char*>(key.data()), key.length()));
+      if (inserted) {
+         it->second.op = op;
+         it->second.bytes.assign(reinterpret_cast<const char*>(operand.data()), operand.length());
+         filter[key_hash % filter_slots]++;
+         pending_keys++;
+      } else if (it->second.op != op) {
+         return 0;
+      } else {
+         combine(it->second, operand);
+      }
+      return stripe.pending.size();
+   }
+   // Removes the pending operands of key from all stripes, the caller holds foldLatch(key_hash) and calls folded() once they are
+   // applied. Operands of different workers commute, so the order of the stripes does not matter
+   std::vector<Operand> take(Slice key)
+   {
+      std::vector<Operand> operands;
+      const std::string key_str(reinterpret_cast<const char*>(key.data()), key.length());
+      for (u64 s_i = 0; s_i < stripes_count; s_i++) {
+         Stripe& stripe = stripes[s_i];
+         std::unique_lock<std::mutex> guard(stripe.mutex);
+         auto it = stripe.pending.find(key_str);
+         if (it != stripe.pending.end()) {
+            operands.push_back(std::move(it->second));
+            stripe.pending.erase(it);
+         }
+      }
+      return operands;
+   }
+   void folded(u64 key_hash, u64 operands_count)
+   {
+      filter[key_hash % filter_slots] -= operands_count;
+      pending_keys -= operands_count;
+   }
+   // Bytes of the operands pending for key in all stripes, the caller holds foldLatch(hash(key))
+   u64 pendingLength(Slice key) { return pendingLength(key, false); }
+   u64 pendingAppendLength(Slice key) { return pendingLength(key, true); }
+   // Snapshot of the keys pending in a stripe
+   std::vector<std::string> pendingKeys(u64 stripe_i)
+   {
+      Stripe& stripe = stripes[stripe_i];
+      std::unique_lock<std::mutex> guard(stripe.mutex);
+      std::vector<std::string> keys;
+      keys.reserve(stripe.pending.size());
+      for (auto& [key, operand] : stripe.pending) {
+         keys.push_back(key);
+      }
+      return keys;
+   }
+   u64 stripesCount() const { return stripes_count; }
+   // -------------------------------------------------------------------------------------
+   // ADD and MAX work on native s64 values, APPEND concatenates bytes
+   static void combine(Operand& into, Slice operand)
+   {
+      if (into.op == MergeOperator::APPEND) {
+         into.bytes.append(reinterpret_cast<const char*>(operand.data()), operand.length());
+      } else {
+         combineNumeric(into.op, reinterpret_cast<u8*>(into.bytes.data()), operand.data());
+      }
+   }
+   static void combineNumeric(MergeOperator op, u8* value, const u8* operand)
+   {
+      s64 current, delta;
+      std::memcpy(&current, value, sizeof(s64));
+      std::memcpy(&delta, operand, sizeof(s64));
+      current = (op == MergeOperator::ADD) ? current + delta : std::max(current, delta);
+      std::memcpy(value, &current, sizeof(s64));
+   }
+
+  private:
+   struct alignas(64) Stripe {
+      std::mutex mutex;
+      std::unordered_map<std::string, Operand> pending;
+   };
+   u64 pendingLength(Slice key, bool only_append)
+   {
+      u64 length = 0;
+      const std::string key_str(reinterpret_cast<const char*>(key.data()), key.length());
+      for (u64 s_i = 0; s_i < stripes_count; s_i++) {
+         Stripe& stripe = stripes[s_i];
+         std::unique_lock<std::mutex> guard(stripe.mutex);
+         auto it = stripe.pending.find(key_str);
+         if (it != stripe.pending.end() && (!only_append || it->second.op == MergeOperator::APPEND)) {
+            length += it->second.bytes.length();
+         }
+      }
+      return length;
+   }
+   const u64 stripes_count;
+   std::unique_ptr<Stripe[]> stripes;
+   std::unique_ptr<std::atomic<u64>[]> filter = std::make_unique<std::atomic<u64>[]>(filter_slots);
+   std::unique_ptr<std::mutex[]> fold_mutexes = std::make_unique<std::mutex[]>(fold_latches);
+   std::atomic<u64> pending_keys = 0;
+};
+// -------------------------------------------------------------------------------------
+}  // namespace btree
+}  // namespace storage
+}  // namespace leanstore
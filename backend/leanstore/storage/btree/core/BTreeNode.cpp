@@ -4,6 +4,9 @@
 // -------------------------------------------------------------------------------------
 #include "gflags/gflags.h"
 // -------------------------------------------------------------------------------------
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
 namespace leanstore
@@ -13,6 +16,173 @@ namespace storage
 namespace btree
 {
 // -------------------------------------------------------------------------------------
+// Heads rank kernels: return the number of heads that are smaller than key_head
+static u16 headsRankScalar(const HeadType* heads, u16 heads_count, HeadType key_head)
+{
+   u16 rank = 0;
+   for (u16 i = 0; i < heads_count; i++) {
+      rank += heads[i] < key_head;
+   }
+   return rank;
+}
+#if defined(__x86_64__)
+// AVX2 has only signed 32-bit compares, flipping the sign bit of both sides gives the unsigned order
+__attribute__((target("avx2"))) static u16 headsRankAVX2(const HeadType* heads, u16 heads_count, HeadType key_head)
+{
+   const __m256i sign_bit = _mm256_set1_epi32(std::numeric_limits<s32>::min());
+   const __m256i key_head_reg = _mm256_xor_si256(_mm256_set1_epi32(key_head), sign_bit);
+   u16 rank = 0, i = 0;
+   for (; i + 8 <= heads_count; i += 8) {
+      const __m256i chunk = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(heads + i)), sign_bit);
+      const __m256i less = _mm256_cmpgt_epi32(key_head_reg, chunk);
+      rank += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(less)));
+   }
+   return rank + headsRankScalar(heads + i, heads_count - i, key_head);
+}
+__attribute__((target("avx512f"))) static u16 headsRankAVX512(const HeadType* heads, u16 heads_count, HeadType key_head)
+{
+   const __m512i key_head_reg = _mm512_set1_epi32(key_head);
+   u16 rank = 0, i = 0;
+   for (; i + 16 <= heads_count; i += 16) {
+      const __m512i chunk = _mm512_loadu_si512(heads + i);
+      rank += __builtin_popcount(_mm512_cmplt_epu32_mask(chunk, key_head_reg));
+   }
+   if (i < heads_count) {
+      const __mmask16 tail_mask = (1u << (heads_count - i)) - 1;
+      const __m512i chunk = _mm512_maskz_loadu_epi32(tail_mask, heads + i);
+      rank += __builtin_popcount(_mm512_mask_cmplt_epu32_mask(tail_mask, chunk, key_head_reg));
+   }
+   return rank;
+}
+#endif
+#if defined(__aarch64__)
+static u16 headsRankNEON(const HeadType* heads, u16 heads_count, HeadType key_head)
+{
+   const uint32x4_t key_head_reg = vdupq_n_u32(key_head);
+   u16 rank = 0, i = 0;
+   for (; i + 4 <= heads_count; i += 4) {
+      const uint32x4_t less = vcltq_u32(vld1q_u32(heads + i), key_head_reg);
+      rank += vaddvq_u32(vshrq_n_u32(less, 31));
+   }
+   return rank + headsRankScalar(heads + i, heads_count - i, key_head);
+}
+#endif
+// -------------------------------------------------------------------------------------
+// Fingerprints match kernels: bit i is set if fingerprints[i] == key_fingerprint, always 64 fingerprints wide
+// The scalar kernel works on 8 fingerprints per word: zero bytes of word ^ key get their high bit set, and the multiplication
+// gathers the 8 high bits into the top byte
+static u64 fingerprintsMatchScalar(const u8* fingerprints, u8 key_fingerprint)
+{
+   constexpr u64 low_bits = 0x7F7F7F7F7F7F7F7Full;
+   const u64 key_word = 0x0101010101010101ull * key_fingerprint;
+   u64 matches = 0;
+   for (u16 i = 0; i < BTreeNode::fingerprints_growth; i += sizeof(u64)) {
+      u64 word;
+      std::memcpy(&word, fingerprints + i, sizeof(u64));
+      word ^= key_word;
+      const u64 zero_bytes = ~(((word & low_bits) + low_bits) | word | low_bits);
+      matches |= (((zero_bytes >> 7) * 0x0102040810204080ull) >> 56) << i;
+   }
+   return matches;
+}
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) static u64 fingerprintsMatchAVX2(const u8* fingerprints, u8 key_fingerprint)
+{
+   const __m256i key_fingerprint_reg = _mm256_set1_epi8(key_fingerprint);
+   const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(fingerprints));
+   const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(fingerprints + 32));
+   const u32 low_matches = _mm256_movemask_epi8(_mm256_cmpeq_epi8(low, key_fingerprint_reg));
+   const u32 high_matches = _mm256_movemask_epi8(_mm256_cmpeq_epi8(high, key_fingerprint_reg));
+   return (static_cast<u64>(high_matches) << 32) | low_matches;
+}
+__attribute__((target("avx512bw"))) static u64 fingerprintsMatchAVX512(const u8* fingerprints, u8 key_fingerprint)
+{
+   return _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(fingerprints), _mm512_set1_epi8(key_fingerprint));
+}
+#endif
+#if defined(__aarch64__)
+static u64 fingerprintsMatchNEON(const u8* fingerprints, u8 key_fingerprint)
+{
+   // NEON has no movemask, weighting each matching lane with its bit and adding up the halves gives one mask byte each
+   static const uint8x16_t lane_bits = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+   const uint8x16_t key_fingerprint_reg = vdupq_n_u8(key_fingerprint);
+   u64 matches = 0;
+   for (u16 i = 0; i < BTreeNode::fingerprints_growth; i += 16) {
+      const uint8x16_t lanes = vandq_u8(vceqq_u8(vld1q_u8(fingerprints + i), key_fingerprint_reg), lane_bits);
+      const u64 mask = vaddv_u8(vget_low_u8(lanes)) | (static_cast<u64>(vaddv_u8(vget_high_u8(lanes))) << 8);
+      matches |= mask << i;
+   }
+   return matches;
+}
+#endif
+// -------------------------------------------------------------------------------------
+// Flags are parsed after static initialization, so the kernels are picked on first use
+static u16 headsRankPickOnFirstUse(const HeadType* heads, u16 heads_count, HeadType key_head)
+{
+   BTreeNode::pickSIMDKernels();
+   return BTreeNode::heads_rank(heads, heads_count, key_head);
+}
+BTreeNode::HeadsRankFunction BTreeNode::heads_rank = headsRankPickOnFirstUse;
+static u64 fingerprintsMatchPickOnFirstUse(const u8* fingerprints, u8 key_fingerprint)
+{
+   BTreeNode::pickSIMDKernels();
+   return BTreeNode::fingerprints_match(fingerprints, key_fingerprint);
+}
+BTreeNode::FingerprintsMatchFunction BTreeNode::fingerprints_match = fingerprintsMatchPickOnFirstUse;
+// -------------------------------------------------------------------------------------
+void BTreeNode::pickSIMDKernels()
+{
+   // 0: best available, 1: scalar, 2: AVX2, 3: AVX-512, 4: NEON
+   switch (FLAGS_btree_heads_simd) {
+      case 1:
+         heads_rank = headsRankScalar;
+         fingerprints_match = fingerprintsMatchScalar;
+         return;
+#if defined(__x86_64__)
+      case 2:
+         ensure(__builtin_cpu_supports("avx2"));
+         heads_rank = headsRankAVX2;
+         fingerprints_match = fingerprintsMatchAVX2;
+         return;
+      case 3:
+         ensure(__builtin_cpu_supports("avx512f"));
+         heads_rank = headsRankAVX512;
+         // Byte compares need AVX-512BW on top of AVX-512F
+         fingerprints_match = __builtin_cpu_supports("avx512bw") ? fingerprintsMatchAVX512 : fingerprintsMatchAVX2;
+         return;
+      case 0:
+         if (__builtin_cpu_supports("avx512f")) {
+            heads_rank = headsRankAVX512;
+         } else if (__builtin_cpu_supports("avx2")) {
+            heads_rank = headsRankAVX2;
+         } else {
+            heads_rank = headsRankScalar;
+         }
+         if (__builtin_cpu_supports("avx512bw")) {
+            fingerprints_match = fingerprintsMatchAVX512;
+         } else if (__builtin_cpu_supports("avx2")) {
+            fingerprints_match = fingerprintsMatchAVX2;
+         } else {
+            fingerprints_match = fingerprintsMatchScalar;
+         }
+         return;
+#elif defined(__aarch64__)
+      case 0:
+      case 4:
+         heads_rank = headsRankNEON;
+         fingerprints_match = fingerprintsMatchNEON;
+         return;
+#else
+      case 0:
+         heads_rank = headsRankScalar;
+         fingerprints_match = fingerprintsMatchScalar;
+         return;
+#endif
+      default:
+         ensure(false);
+   }
+}
+// -------------------------------------------------------------------------------------
 void BTreeNode::makeHint()
 {
    u16 dist = count / (hint_count + 1);
@@ -39,7 +209,8 @@ u16 BTreeNode::spaceNeeded(u16 key_len, u16 payload_len, u16 prefix_len)
 // -------------------------------------------------------------------------------------
 u16 BTreeNode::spaceNeeded(u16 key_length, u16 payload_len)
 {
-   return spaceNeeded(key_length, payload_len, prefix_length);
+   return spaceNeeded(key_length, payload_len, prefix_length) + (headsFull() ? heads_growth * sizeof(HeadType) : 0) +
+          (fingerprintsFull() ? fingerprints_growth : 0);
 }
 // -------------------------------------------------------------------------------------
 bool BTreeNode::canInsert(u16 key_len, u16 payload_len)
@@ -56,8 +227,9 @@ bool BTreeNode::prepareInsert(u16 key_len, u16 payload_len)
    const u16 space_needed = spaceNeeded(key_len, payload_len);
    if (!requestSpaceFor(space_needed))
       return false;  // no space, insert fails
-   else
-      return true;
+   if (headsFull() || fingerprintsFull())
+      growArrays();
+   return true;
 }
 // -------------------------------------------------------------------------------------
 s16 BTreeNode::insertDoNotCopyPayload(const u8* key, u16 key_len, u16 payload_length, s32 pos)
@@ -67,11 +239,23 @@ s16 BTreeNode::insertDoNotCopyPayload(const u8* key, u16 key_len, u16 payload_le
    // -------------------------------------------------------------------------------------
    s32 slotId = (pos == -1) ? lowerBound<false>(key, key_len) : pos;
    memmove(slot + slotId + 1, slot + slotId, sizeof(Slot) * (count - slotId));
+   if (heads_capacity) {
+      memmove(heads() + slotId + 1, heads() + slotId, sizeof(HeadType) * (count - slotId));
+   }
+   if (fingerprints_capacity) {
+      memmove(fingerprints() + slotId + 1, fingerprints() + slotId, count - slotId);
+   }
    // -------------------------------------------------------------------------------------
    // StoreKeyValue
    key += prefix_length;
    key_len -= prefix_length;
    slot[slotId].head = head(key, key_len);
+   if (heads_capacity) {
+      heads()[slotId] = slot[slotId].head;
+   }
+   if (fingerprints_capacity) {
+      fingerprints()[slotId] = fingerprint(key, key_len);
+   }
    slot[slotId].key_len = key_len;
    slot[slotId].payload_len = payload_length;
    const u16 space = key_len + payload_length;
@@ -98,6 +282,12 @@ s32 BTreeNode::insert(const u8* key, u16 key_len, const u8* payload, u16 payload
    prepareInsert(key_len, payload_length);
    s32 slotId = lowerBound<false>(key, key_len);
    memmove(slot + slotId + 1, slot + slotId, sizeof(Slot) * (count - slotId));
+   if (heads_capacity) {
+      memmove(heads() + slotId + 1, heads() + slotId, sizeof(HeadType) * (count - slotId));
+   }
+   if (fingerprints_capacity) {
+      memmove(fingerprints() + slotId + 1, fingerprints() + slotId, count - slotId);
+   }
    storeKeyValue(slotId, key, key_len, payload, payload_length);
    count++;
    updateHint(slotId);
@@ -115,7 +305,7 @@ void BTreeNode::compactify()
 {
    u16 should = freeSpaceAfterCompaction();
    static_cast<void>(should);
-   BTreeNode tmp(is_leaf);
+   BTreeNode tmp(is_leaf, heads_capacity, fingerprints_capacity);
    tmp.setFences(getLowerFenceKey(), lower_fence.length, getUpperFenceKey(), upper_fence.length);
    copyKeyValueRange(&tmp, 0, 0, count);
    tmp.upper = upper;
@@ -124,6 +314,20 @@ void BTreeNode::compactify()
    assert(freeSpace() == should);
 }
 // -------------------------------------------------------------------------------------
+// Moving the data area down by one cache line is as expensive as a compaction, so we do both at once
+void BTreeNode::growArrays()
+{
+   assert(headsFull() || fingerprintsFull());
+   BTreeNode tmp(is_leaf, headsCapacityFor(count + 1), fingerprintsCapacityFor(count + 1));
+   assert(freeSpaceAfterCompaction() >= tmp.arraysBytes() - arraysBytes());
+   tmp.setFences(getLowerFenceKey(), lower_fence.length, getUpperFenceKey(), upper_fence.length);
+   copyKeyValueRange(&tmp, 0, 0, count);
+   tmp.upper = upper;
+   tmp.has_garbage = has_garbage;
+   memcpy(reinterpret_cast<char*>(this), &tmp, sizeof(BTreeNode));
+   makeHint();
+}
+// -------------------------------------------------------------------------------------
 u32 BTreeNode::mergeSpaceUpperBound(ExclusivePageGuard<BTreeNode>& right)
 {
    assert(right->is_leaf);
@@ -131,7 +335,10 @@ u32 BTreeNode::mergeSpaceUpperBound(ExclusivePageGuard<BTreeNode>& right)
    tmp.setFences(getLowerFenceKey(), lower_fence.length, right->getUpperFenceKey(), right->upper_fence.length);
    u32 leftGrow = (prefix_length - tmp.prefix_length) * count;
    u32 rightGrow = (right->prefix_length - tmp.prefix_length) * right->count;
-   u32 spaceUpperBound = space_used + right->space_used + (reinterpret_cast<u8*>(slot + count + right->count) - ptr()) + leftGrow + rightGrow;
+   s32 arraysGrow = right->headsCapacityFor(count + right->count) * sizeof(HeadType) + right->fingerprintsCapacityFor(count + right->count) -
+                    arraysBytes() - right->arraysBytes();
+   u32 spaceUpperBound =
+       space_used + right->space_used + (reinterpret_cast<u8*>(slot + count + right->count) - ptr()) + leftGrow + rightGrow + arraysGrow;
    return spaceUpperBound;
 }
 // -------------------------------------------------------------------------------------
@@ -147,11 +354,13 @@ bool BTreeNode::merge(u16 slotId, ExclusivePageGuard<BTreeNode>& parent, Exclusi
    if (is_leaf) {
       assert(right->is_leaf);
       assert(parent->isInner());
-      BTreeNode tmp(is_leaf);
+      BTreeNode tmp(is_leaf, right->headsCapacityFor(count + right->count), right->fingerprintsCapacityFor(count + right->count));
       tmp.setFences(getLowerFenceKey(), lower_fence.length, right->getUpperFenceKey(), right->upper_fence.length);
       u16 leftGrow = (prefix_length - tmp.prefix_length) * count;
       u16 rightGrow = (right->prefix_length - tmp.prefix_length) * right->count;
-      u16 spaceUpperBound = space_used + right->space_used + (reinterpret_cast<u8*>(slot + count + right->count) - ptr()) + leftGrow + rightGrow;
+      s32 arraysGrow = tmp.arraysBytes() - arraysBytes() - right->arraysBytes();
+      u16 spaceUpperBound =
+          space_used + right->space_used + (reinterpret_cast<u8*>(slot + count + right->count) - ptr()) + leftGrow + rightGrow + arraysGrow;
       if (spaceUpperBound > EFFECTIVE_PAGE_SIZE) {
          return false;
       }
@@ -167,13 +376,14 @@ bool BTreeNode::merge(u16 slotId, ExclusivePageGuard<BTreeNode>& parent, Exclusi
    } else {  // Inner node
       assert(!right->is_leaf);
       assert(parent->isInner());
-      BTreeNode tmp(is_leaf);
+      BTreeNode tmp(is_leaf, right->headsCapacityFor(count + right->count + 1), 0);
       tmp.setFences(getLowerFenceKey(), lower_fence.length, right->getUpperFenceKey(), right->upper_fence.length);
       u16 leftGrow = (prefix_length - tmp.prefix_length) * count;
       u16 rightGrow = (right->prefix_length - tmp.prefix_length) * right->count;
+      s32 arraysGrow = tmp.arraysBytes() - arraysBytes() - right->arraysBytes();
       u16 extraKeyLength = parent->getFullKeyLen(slotId);
       u16 spaceUpperBound = space_used + right->space_used + (reinterpret_cast<u8*>(slot + count + right->count) - ptr()) + leftGrow + rightGrow +
-                            spaceNeeded(extraKeyLength, sizeof(SwipType), tmp.prefix_length);
+                            arraysGrow + spaceNeeded(extraKeyLength, sizeof(SwipType), tmp.prefix_length);
       if (spaceUpperBound > EFFECTIVE_PAGE_SIZE)
          return false;
       copyKeyValueRange(&tmp, 0, 0, count);
@@ -199,6 +409,14 @@ void BTreeNode::storeKeyValue(u16 slotId, const u8* key, u16 key_len, const u8*
    slot[slotId].head = head(key, key_len);
    slot[slotId].key_len = key_len;
    slot[slotId].payload_len = payload_len;
+   if (heads_capacity) {
+      assert(slotId < heads_capacity);
+      heads()[slotId] = slot[slotId].head;
+   }
+   if (fingerprints_capacity) {
+      assert(slotId < fingerprints_capacity);
+      fingerprints()[slotId] = fingerprint(key, key_len);
+   }
    // Value
    const u16 space = key_len + payload_len;
    data_offset -= space;
@@ -219,7 +437,7 @@ void BTreeNode::copyKeyValueRange(BTreeNode* dst, u16 dstSlot, u16 srcSlot, u16
       memcpy(dst->slot + dstSlot, slot + srcSlot, sizeof(Slot) * count);
       DEBUG_BLOCK()
       {
-         u32 total_space_used = upper_fence.length + lower_fence.length;
+         u32 total_space_used = upper_fence.length + lower_fence.length + arraysBytes();
          for (u16 i = 0; i < this->count; i++) {
             total_space_used += getKeyLen(i) + getPayloadLength(i);
          }
@@ -237,6 +455,23 @@ void BTreeNode::copyKeyValueRange(BTreeNode* dst, u16 dstSlot, u16 srcSlot, u16
          }
          memcpy(dst->ptr() + dst->data_offset, ptr() + slot[srcSlot + i].offset, kv_size);
       }
+      if (dst->heads_capacity) {
+         assert(dstSlot + count <= dst->heads_capacity);
+         for (u16 i = 0; i < count; i++) {
+            dst->heads()[dstSlot + i] = dst->slot[dstSlot + i].head;
+         }
+      }
+      // Same prefix, so the fingerprints stay valid
+      if (dst->fingerprints_capacity) {
+         assert(dstSlot + count <= dst->fingerprints_capacity);
+         if (fingerprints_capacity) {
+            memcpy(dst->fingerprints() + dstSlot, fingerprints() + srcSlot, count);
+         } else {
+            for (u16 i = 0; i < count; i++) {
+               dst->fingerprints()[dstSlot + i] = fingerprint(getKey(srcSlot + i), getKeyLen(srcSlot + i));
+            }
+         }
+      }
    } else {
       for (u16 i = 0; i < count; i++)
          copyKeyValue(srcSlot + i, dst, dstSlot + i);
@@ -370,8 +605,15 @@ void BTreeNode::split(ExclusivePageGuard<BTreeNode>& parent, ExclusivePageGuard<
    // assert(sepSlot > 0); TODO: really ?
    assert(sepSlot < (EFFECTIVE_PAGE_SIZE / sizeof(SwipType)));
    // -------------------------------------------------------------------------------------
+   // Both halves keep the layout of the node being split
+   const u16 left_count = is_leaf ? sepSlot + 1 : sepSlot;
+   const u16 right_count = is_leaf ? count - left_count : count - left_count - 1;
+   if (nodeLeft->heads_capacity != headsCapacityFor(left_count) || nodeLeft->fingerprints_capacity != fingerprintsCapacityFor(left_count)) {
+      assert(nodeLeft->count == 0);
+      nodeLeft.init(is_leaf, headsCapacityFor(left_count), fingerprintsCapacityFor(left_count));
+   }
    nodeLeft->setFences(getLowerFenceKey(), lower_fence.length, sepKey, sepLength);
-   BTreeNode tmp(is_leaf);
+   BTreeNode tmp(is_leaf, headsCapacityFor(right_count), fingerprintsCapacityFor(right_count));
    BTreeNode* nodeRight = &tmp;
    nodeRight->setFences(sepKey, sepLength, getUpperFenceKey(), upper_fence.length);
    assert(parent->canInsert(sepLength, sizeof(SwipType)));
@@ -399,6 +641,12 @@ bool BTreeNode::removeSlot(u16 slotId)
 {
    space_used -= getKeyLen(slotId) + getPayloadLength(slotId);
    memmove(slot + slotId, slot + slotId + 1, sizeof(Slot) * (count - slotId - 1));
+   if (heads_capacity) {
+      memmove(heads() + slotId, heads() + slotId + 1, sizeof(HeadType) * (count - slotId - 1));
+   }
+   if (fingerprints_capacity) {
+      memmove(fingerprints() + slotId, fingerprints() + slotId + 1, count - slotId - 1);
+   }
    count--;
    makeHint();
    return true;
@@ -414,7 +662,7 @@ bool BTreeNode::remove(const u8* key, const u16 keyLength)
 // -------------------------------------------------------------------------------------
 void BTreeNode::reset()
 {
-   space_used = upper_fence.length + lower_fence.length;
+   space_used = upper_fence.length + lower_fence.length + arraysBytes();
    data_offset = EFFECTIVE_PAGE_SIZE - space_used;
    count = 0;
 }
@@ -12,6 +12,7 @@
 #include <cassert>
 #include <cstring>
 #include <fstream>
+#include <limits>
 #include <string>
 // -------------------------------------------------------------------------------------
 using namespace std;
@@ -69,6 +70,8 @@ struct BTreeNodeHeader {
    u16 space_used = 0;  // does not include the header, but includes fences !!!!!
    u16 data_offset = static_cast<u16>(EFFECTIVE_PAGE_SIZE);
    u16 prefix_length = 0;
+   u16 heads_capacity = 0;  // 0: heads are only kept in the slots, otherwise the size of the heads array at the end of the page
+   u16 fingerprints_capacity = 0;  // leaves only, 0: no fingerprints, otherwise the size of the fingerprints array below the heads array
 
    static const u16 hint_count = 16;
    u32 hint[hint_count];
@@ -103,8 +106,69 @@ struct BTreeNode : public BTreeNodeHeader {
    static constexpr u64 left_space_to_waste = (EFFECTIVE_PAGE_SIZE - sizeof(BTreeNodeHeader)) % (sizeof(Slot));
    Slot slot[max_theorical_slots_capacity];
    u8 padding[left_space_to_waste];
-
-   BTreeNode(bool is_leaf) : BTreeNodeHeader(is_leaf) {}
+   // -------------------------------------------------------------------------------------
+   // Heads array layout: a copy of the slot heads is kept contiguous at the end of the page so that lowerBound
+   // can scan it with SIMD compares. It grows in steps of one cache line and its bytes are accounted in space_used
+   static constexpr u16 heads_growth = 64 / sizeof(HeadType);
+   static constexpr u16 heads_simd_window = 32;
+   using HeadsRankFunction = u16 (*)(const HeadType* heads, u16 heads_count, HeadType key_head);
+   static HeadsRankFunction heads_rank;  // Number of heads < key_head, kernel picked at runtime (FLAGS_btree_heads_simd)
+   // -------------------------------------------------------------------------------------
+   // Fingerprints layout (leaves only): a 1-byte hash of each key without prefix, kept right below the heads array.
+   // Equality lookups compare 64 fingerprints at once and only check the full key of the matches
+   static constexpr u16 fingerprints_growth = 64;
+   using FingerprintsMatchFunction = u64 (*)(const u8* fingerprints, u8 key_fingerprint);
+   static FingerprintsMatchFunction fingerprints_match;  // Bitmask of the 64 fingerprints == key_fingerprint
+   static void pickSIMDKernels();  // FLAGS_btree_heads_simd
+   // -------------------------------------------------------------------------------------
+   BTreeNode(bool is_leaf)
+       : BTreeNode(is_leaf, FLAGS_btree_heads_array ? heads_growth : 0, (is_leaf && FLAGS_btree_fingerprints) ? fingerprints_growth : 0)
+   {
+   }
+   BTreeNode(bool is_leaf, u16 initial_heads_capacity, u16 initial_fingerprints_capacity) : BTreeNodeHeader(is_leaf)
+   {
+      assert(is_leaf || initial_fingerprints_capacity == 0);
+      heads_capacity = initial_heads_capacity;
+      fingerprints_capacity = initial_fingerprints_capacity;
+      space_used = arraysBytes();
+      data_offset = EFFECTIVE_PAGE_SIZE - space_used;
+   }
+   // -------------------------------------------------------------------------------------
+   inline HeadType* heads() { return reinterpret_cast<HeadType*>(ptr() + EFFECTIVE_PAGE_SIZE) - heads_capacity; }
+   inline u16 headsCapacityFor(u16 slots_count)
+   {
+      if (!heads_capacity)
+         return 0;
+      return std::max<u16>(heads_growth, (slots_count + heads_growth - 1) & ~(heads_growth - 1));
+   }
+   inline u16 headsBytes() { return heads_capacity * sizeof(HeadType); }
+   inline bool headsFull() { return heads_capacity && count == heads_capacity; }
+   // -------------------------------------------------------------------------------------
+   inline u8* fingerprints() { return reinterpret_cast<u8*>(heads()) - fingerprints_capacity; }
+   inline u16 fingerprintsCapacityFor(u16 slots_count)
+   {
+      if (!fingerprints_capacity)
+         return 0;
+      return std::max<u16>(fingerprints_growth, (slots_count + fingerprints_growth - 1) & ~(fingerprints_growth - 1));
+   }
+   inline bool fingerprintsFull() { return fingerprints_capacity && count == fingerprints_capacity; }
+   static inline u8 fingerprint(const u8* key, u16 key_length)
+   {
+      constexpr u64 multiplier = 0x9E3779B97F4A7C15ull;
+      u64 h = key_length;
+      for (; key_length >= sizeof(u64); key += sizeof(u64), key_length -= sizeof(u64)) {
+         u64 word;
+         std::memcpy(&word, key, sizeof(u64));
+         h = (h ^ word) * multiplier;
+         h ^= h >> 32;
+      }
+      u64 tail = 0;
+      std::memcpy(&tail, key, key_length);
+      return ((h ^ tail) * multiplier) >> 56;
+   }
+   // -------------------------------------------------------------------------------------
+   inline u16 arraysBytes() { return headsBytes() + fingerprints_capacity; }
+   void growArrays();
 
    u16 freeSpace() { return data_offset - (reinterpret_cast<u8*>(slot + count) - ptr()); }
    u16 freeSpaceAfterCompaction() { return EFFECTIVE_PAGE_SIZE - (reinterpret_cast<u8*>(slot + count) - ptr()) - space_used; }
@@ -325,6 +389,81 @@ struct BTreeNode : public BTreeNodeHeader {
       }
    }
    // -------------------------------------------------------------------------------------
+   // Returns the first position whose head is >= key_head
+   u16 headsLowerBound(HeadType key_head)
+   {
+      const HeadType* heads_array = heads();
+      u16 lower = 0;
+      u16 upper = count;
+      while (upper - lower > heads_simd_window) {
+         u16 mid = ((upper - lower) / 2) + lower;
+         if (heads_array[mid] < key_head) {
+            lower = mid + 1;
+         } else {
+            upper = mid;
+         }
+      }
+      return lower + heads_rank(heads_array + lower, upper - lower, key_head);
+   }
+   // Key is already without prefix, full keys are only compared for the slots that share the same head
+   template <bool equalityOnly = false>
+   s16 lowerBoundHeads(const u8* key, u16 keyLength, HeadType keyHead, bool* is_equal)
+   {
+      u16 lower = headsLowerBound(keyHead);
+      if (lower == count || heads()[lower] != keyHead) {
+         return equalityOnly ? -1 : lower;
+      }
+      // Heads are mostly unique, so check the neighbour before searching for the end of the tie range
+      u16 upper = lower + 1;
+      if (upper < count && heads()[upper] == keyHead) {
+         upper = (keyHead == std::numeric_limits<HeadType>::max()) ? count : headsLowerBound(keyHead + 1);
+      }
+      while (lower < upper) {
+         u16 mid = ((upper - lower) / 2) + lower;
+         int cmp = cmpKeys(key, getKey(mid), keyLength, getKeyLen(mid));
+         if (cmp < 0) {
+            upper = mid;
+         } else if (cmp > 0) {
+            lower = mid + 1;
+         } else {
+            if (is_equal != nullptr && is_leaf) {
+               *is_equal = true;
+            }
+            return mid;  // It is even equal
+         }
+      }
+      if (equalityOnly)
+         return -1;
+      return lower;
+   }
+   // Key is already without prefix, returns the position of the key or -1
+   s16 findWithFingerprints(const u8* key, u16 keyLength, bool* is_equal)
+   {
+      assert(is_leaf);
+      const u8 key_fingerprint = fingerprint(key, keyLength);
+      const u8* fingerprints_array = fingerprints();
+      const u16 fingerprints_count = std::min(count, fingerprints_capacity);  // optimistic readers may see a count that is being changed
+      // The capacity is a multiple of fingerprints_growth, so every 64-byte window lies inside the array
+      for (u16 window = 0; window < fingerprints_count; window += fingerprints_growth) {
+         u64 matches = fingerprints_match(fingerprints_array + window, key_fingerprint);
+         const u16 window_count = fingerprints_count - window;
+         if (window_count < fingerprints_growth) {
+            matches &= (1ull << window_count) - 1;
+         }
+         while (matches) {
+            const u16 pos = window + __builtin_ctzll(matches);
+            if (cmpKeys(key, getKey(pos), keyLength, getKeyLen(pos)) == 0) {
+               if (is_equal != nullptr) {
+                  *is_equal = true;
+               }
+               return pos;
+            }
+            matches &= matches - 1;
+         }
+      }
+      return -1;
+   }
+   // -------------------------------------------------------------------------------------
    // Returns the position where the key[pos] (if exists) >= key (not less than the given key)
    // Asc: (2) (2) (1) -> (2) (2) (1) (0) -> (2) (2) (1) (0) (0) -> ...  -> (2) (2) (2)
    template <bool equalityOnly = false>
@@ -347,9 +486,15 @@ struct BTreeNode : public BTreeNodeHeader {
       key += prefix_length;
       keyLength -= prefix_length;
 
+      if (equalityOnly && fingerprints_capacity) {
+         return findWithFingerprints(key, keyLength, is_equal);
+      }
+      HeadType keyHead = head(key, keyLength);
+      if (heads_capacity) {
+         return lowerBoundHeads<equalityOnly>(key, keyLength, keyHead, is_equal);
+      }
       u16 lower = 0;
       u16 upper = count;
-      HeadType keyHead = head(key, keyLength);
       searchHint(keyHead, lower, upper);
       while (lower < upper) {
          u16 mid = ((upper - lower) / 2) + lower;
@@ -407,7 +552,7 @@ struct BTreeNode : public BTreeNodeHeader {
    s16 insertDoNotCopyPayload(const u8* key, u16 key_len, u16 payload_len, s32 pos = -1);
    s32 insert(const u8* key, u16 key_len, const u8* payload, u16 payload_len);
    static u16 spaceNeeded(u16 keyLength, u16 payload_len, u16 prefixLength);
-   u16 spaceNeeded(u16 key_length, u16 payload_len);
+   u16 spaceNeeded(u16 key_length, u16 payload_len);  // includes the growth of the heads and fingerprints arrays when they are full
    bool canInsert(u16 key_length, u16 payload_len);
    bool prepareInsert(u16 keyLength, u16 payload_len);
    // -------------------------------------------------------------------------------------
@@ -0,0 +1,73 @@
+#include "AsyncReadBuffer.hpp"
+
+#include "Exceptions.hpp"
+#include "leanstore/profiling/counters/WorkerCounters.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <cstring>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+// -------------------------------------------------------------------------------------
+AsyncReadBuffer::AsyncReadBuffer(int fd, u64 page_size, u64 batch_max_size) : fd(fd), page_size(page_size), batch_max_size(batch_max_size)
+{
+   read_commands = make_unique<ReadCommand[]>(batch_max_size);
+   iocbs = make_unique<struct iocb[]>(batch_max_size);
+   events = make_unique<struct io_event[]>(batch_max_size);
+   free_slots.reserve(batch_max_size);
+   for (u64 slot = batch_max_size; slot > 0; slot--) {
+      free_slots.push_back(slot - 1);
+   }
+   // -------------------------------------------------------------------------------------
+   memset(&aio_context, 0, sizeof(aio_context));
+   const int ret = io_setup(batch_max_size, &aio_context);
+   if (ret != 0) {
+      throw ex::GenericException("io_setup failed, ret code = " + std::to_string(ret));
+   }
+}
+// -------------------------------------------------------------------------------------
+AsyncReadBuffer::~AsyncReadBuffer()
+{
+   io_destroy(aio_context);
+}
+// -------------------------------------------------------------------------------------
+void AsyncReadBuffer::submit(BufferFrame& bf, PID pid)
+{
+   assert(!full());
+   assert(u64(&bf.page) % 512 == 0);
+   const u64 slot = free_slots.back();
+   free_slots.pop_back();
+   read_commands[slot].bf = &bf;
+   read_commands[slot].pid = pid;
+   io_prep_pread(&iocbs[slot], fd, &bf.page, page_size, page_size * pid);
+   iocbs[slot].data = reinterpret_cast<void*>(slot);
+   struct iocb* iocb_ptr = &iocbs[slot];
+   const int ret_code = io_submit(aio_context, 1, &iocb_ptr);
+   ensure(ret_code == 1);
+   pending_requests++;
+   COUNTERS_BLOCK() { WorkerCounters::myCounters().read_operations_counter++; }
+}
+// -------------------------------------------------------------------------------------
+u64 AsyncReadBuffer::pollEvents(u64 min_events, std::function<void(BufferFrame&, PID)> callback)
+{
+   if (pending_requests == 0) {
+      return 0;
+   }
+   struct timespec no_wait = {0, 0};
+   const int done_requests = io_getevents(aio_context, std::min(min_events, pending_requests), pending_requests, events.get(), min_events ? NULL : &no_wait);
+   ensure(done_requests >= 0);
+   for (s32 e_i = 0; e_i < done_requests; e_i++) {
+      const u64 slot = reinterpret_cast<u64>(events[e_i].data);
+      ensure(u64(events[e_i].res) == page_size);
+      explainIfNot(events[e_i].res2 == 0);
+      free_slots.push_back(slot);
+      pending_requests--;
+      callback(*read_commands[slot].bf, read_commands[slot].pid);
+   }
+   return done_requests;
+}
+// -------------------------------------------------------------------------------------
+}  // namespace storage
+}  // namespace leanstore
@@ -0,0 +1,48 @@
+#pragma once
+#include "BufferFrame.hpp"
+#include "Units.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <libaio.h>
+#include <functional>
+#include <memory>
+#include <vector>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+// -------------------------------------------------------------------------------------
+// Reads pages straight into buffer frames with libaio, used for read-ahead.
+// Unlike AsyncWriteBuffer, requests are submitted one by one and complete in any order
+class AsyncReadBuffer
+{
+  private:
+   struct ReadCommand {
+      BufferFrame* bf;
+      PID pid;
+   };
+   io_context_t aio_context;
+   int fd;
+   u64 page_size, batch_max_size;
+   u64 pending_requests = 0;
+   std::vector<u64> free_slots;
+
+  public:
+   std::unique_ptr<ReadCommand[]> read_commands;
+   std::unique_ptr<struct iocb[]> iocbs;
+   std::unique_ptr<struct io_event[]> events;
+   // -------------------------------------------------------------------------------------
+   AsyncReadBuffer(int fd, u64 page_size, u64 batch_max_size);
+   ~AsyncReadBuffer();
+   // Caller takes care of sync
+   bool full() { return free_slots.empty(); }
+   u64 pendingRequests() { return pending_requests; }
+   void submit(BufferFrame& bf, PID pid);
+   // Reaps at least min_events completed reads (without blocking if 0) and returns how many it reaped
+   u64 pollEvents(u64 min_events, std::function<void(BufferFrame&, PID)> callback);
+};
+// -------------------------------------------------------------------------------------
+}  // namespace storage
+}  // namespace leanstore
+// -------------------------------------------------------------------------------------
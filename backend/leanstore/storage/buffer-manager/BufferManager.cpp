@@ -66,6 +66,11 @@ BufferManager::BufferManager(s32 ssd_fd) : ssd_fd(ssd_fd)
          }
       });
    }
+   // -------------------------------------------------------------------------------------
+   if (FLAGS_scan_readahead_max) {
+      read_ahead_buffer_size = std::min<u64>(FLAGS_scan_readahead_max * FLAGS_worker_threads, 4096);
+      read_ahead_buffer = std::make_unique<AsyncReadBuffer>(ssd_fd, PAGE_SIZE, read_ahead_buffer_size);
+   }
 }
 // -------------------------------------------------------------------------------------
 void BufferManager::startBackgroundThreads()
@@ -277,6 +282,134 @@ void BufferManager::reclaimPage(BufferFrame& bf)
    }
 }
 // -------------------------------------------------------------------------------------
+void BufferManager::reclaimPID(PID pid)
+{
+   if (FLAGS_recycle_pages) {
+      getPartition(pid).freePage(pid);
+   }
+}
+// -------------------------------------------------------------------------------------
+bool BufferManager::prefetchSwip(Guard& swip_guard, Swip<BufferFrame>& swip_value)
+{
+   if (!read_ahead_buffer || !swip_value.isEVICTED()) {
+      return false;
+   }
+   if (read_ahead_in_flight.fetch_add(1) >= read_ahead_buffer_size) {
+      read_ahead_in_flight--;
+      return false;
+   }
+   jumpmuTry()
+   {
+      const PID pid = swip_value.asPageID();
+      Partition& partition = getPartition(pid);
+      Partition& free_partition = randomPartition();
+      // Speculative reads must not take frames away from demand reads
+      if (free_partition.dram_free_list.counter < free_partition.free_bfs_limit) {
+         read_ahead_in_flight--;
+         jumpmu_return false;
+      }
+      JMUW<std::unique_lock<std::mutex>> g_guard(partition.ht_mutex);
+      swip_guard.recheck();
+      if (partition.io_ht.lookup(pid)) {
+         read_ahead_in_flight--;
+         jumpmu_return false;
+      }
+      BufferFrame& bf = free_partition.dram_free_list.tryPop();
+      IOFrame& io_frame = partition.io_ht.insert(pid);
+      io_frame.state = IOFrame::STATE::READING;
+      io_frame.readers_counter = 1;
+      io_frame.prefetched = true;
+      g_guard->unlock();
+      {
+         std::unique_lock<std::mutex> ra_guard(read_ahead_mutex);
+         read_ahead_buffer->submit(bf, pid);
+      }
+      jumpmu_return true;
+   }
+   jumpmuCatch() { read_ahead_in_flight--; }
+   return false;
+}
+// -------------------------------------------------------------------------------------
+void BufferManager::reapPrefetches(bool wait)
+{
+   if (!read_ahead_buffer) {
+      return;
+   }
+   std::unique_lock<std::mutex> ra_guard(read_ahead_mutex, std::defer_lock);
+   if (wait) {
+      ra_guard.lock();
+   } else if (!ra_guard.try_lock()) {
+      return;
+   }
+   read_ahead_buffer->pollEvents(wait ? 1 : 0, [&](BufferFrame& bf, PID pid) { finishPrefetch(bf, pid); });
+}
+// -------------------------------------------------------------------------------------
+// Same as the tail of a synchronous read that could not swizzle the page in
+void BufferManager::finishPrefetch(BufferFrame& bf, PID pid)
+{
+   paranoid(bf.header.state == BufferFrame::STATE::FREE);
+   paranoid(bf.page.magic_debugging_number == pid);
+   COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_page_reads[bf.page.dt_id]++; }
+   bf.header.last_written_plsn = bf.page.PLSN;
+   bf.header.state = BufferFrame::STATE::LOADED;
+   bf.header.pid = pid;
+   if (FLAGS_crc_check) {
+      bf.header.crc = utils::CRC(bf.page.dt, EFFECTIVE_PAGE_SIZE);
+   }
+   // -------------------------------------------------------------------------------------
+   Partition& partition = getPartition(pid);
+   std::unique_lock<std::mutex> g_guard(partition.ht_mutex);
+   auto frame_handler = partition.io_ht.lookup(pid);
+   ensure(frame_handler);
+   IOFrame& io_frame = frame_handler.frame();
+   if (io_frame.prefetch_cancelled && io_frame.readers_counter == 1) {
+      partition.io_ht.remove(frame_handler);
+      g_guard.unlock();
+      freePrefetchedFrame(bf);
+   } else {
+      io_frame.bf = &bf;
+      io_frame.state = IOFrame::STATE::READY;
+   }
+   read_ahead_in_flight--;
+}
+// -------------------------------------------------------------------------------------
+void BufferManager::freePrefetchedFrame(BufferFrame& bf)
+{
+   Partition& partition = getPartition(bf.header.pid);
+   Guard bf_guard(bf.header.latch);
+   bf_guard.toExclusive();
+   bf.reset();
+   bf_guard.unlock();
+   partition.dram_free_list.push(bf);
+}
+// -------------------------------------------------------------------------------------
+bool BufferManager::isPageReady(PID pid)
+{
+   Partition& partition = getPartition(pid);
+   std::unique_lock<std::mutex> g_guard(partition.ht_mutex);
+   auto frame_handler = partition.io_ht.lookup(pid);
+   return frame_handler && frame_handler.frame().state == IOFrame::STATE::READY;
+}
+// -------------------------------------------------------------------------------------
+void BufferManager::cancelPrefetch(PID pid)
+{
+   Partition& partition = getPartition(pid);
+   std::unique_lock<std::mutex> g_guard(partition.ht_mutex);
+   auto frame_handler = partition.io_ht.lookup(pid);
+   if (!frame_handler || !frame_handler.frame().prefetched) {
+      return;
+   }
+   IOFrame& io_frame = frame_handler.frame();
+   if (io_frame.state == IOFrame::STATE::READING) {
+      io_frame.prefetch_cancelled = true;  // finishPrefetch frees it
+   } else if (io_frame.state == IOFrame::STATE::READY && io_frame.readers_counter == 1) {
+      BufferFrame& bf = *io_frame.bf;
+      partition.io_ht.remove(frame_handler);
+      g_guard.unlock();
+      freePrefetchedFrame(bf);
+   }
+}
+// -------------------------------------------------------------------------------------
 // Returns a non-latched BufferFrame, called by worker threads
 BufferFrame& BufferManager::resolveSwip(Guard& swip_guard, Swip<BufferFrame>& swip_value)
 {
@@ -370,6 +503,12 @@ BufferFrame& BufferManager::resolveSwip(Guard& swip_guard, Swip<BufferFrame>& sw
    IOFrame& io_frame = frame_handler.frame();
    // -------------------------------------------------------------------------------------
    if (io_frame.state == IOFrame::STATE::READING) {
+      if (io_frame.prefetched) {
+         // Nobody holds io_frame.mutex during read-ahead, whoever needs the page reaps completions
+         g_guard->unlock();
+         reapPrefetches(true);
+         jumpmu::jump();
+      }
       io_frame.readers_counter++;  // incremented while holding partition lock
       g_guard->unlock();
       io_frame.mutex.lock();
@@ -468,6 +607,12 @@ void BufferManager::stopBackgroundThreads()
 BufferManager::~BufferManager()
 {
    stopBackgroundThreads();
+   if (read_ahead_buffer) {
+      std::unique_lock<std::mutex> ra_guard(read_ahead_mutex);
+      while (read_ahead_buffer->pendingRequests()) {
+         read_ahead_buffer->pollEvents(1, [](BufferFrame&, PID) {});
+      }
+   }
    // -------------------------------------------------------------------------------------
    const u64 dram_total_size = sizeof(BufferFrame) * (dram_pool_size + safety_pages);
    munmap(bfs, dram_total_size);
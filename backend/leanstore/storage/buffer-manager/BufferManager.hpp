@@ -1,4 +1,5 @@
 #pragma once
+#include "AsyncReadBuffer.hpp"
 #include "BMPlainGuard.hpp"
 #include "BufferFrame.hpp"
 #include "DTRegistry.hpp"
@@ -25,6 +26,7 @@ class LeanStore;  // Forward declaration
 namespace profiling
 {
 class BMTable;  // Forward declaration
+class DTTable;  // Forward declaration
 }
 namespace storage
 {
@@ -72,6 +74,7 @@ class BufferManager
   private:
    friend class leanstore::LeanStore;
    friend class leanstore::profiling::BMTable;
+   friend class leanstore::profiling::DTTable;
    // -------------------------------------------------------------------------------------
    BufferFrame* bfs;
    // -------------------------------------------------------------------------------------
@@ -87,6 +90,14 @@ class BufferManager
    u64 partitions_mask;
    std::vector<std::unique_ptr<Partition>> partitions;
    std::atomic<u64> clock_cursor = 0;
+   // -------------------------------------------------------------------------------------
+   // Read-ahead (FLAGS_scan_readahead_max), shared by all workers
+   std::mutex read_ahead_mutex;
+   std::unique_ptr<AsyncReadBuffer> read_ahead_buffer;
+   u64 read_ahead_buffer_size = 0;
+   atomic<u64> read_ahead_in_flight = 0;  // slots reserved in read_ahead_buffer
+   void finishPrefetch(BufferFrame& bf, PID pid);
+   void freePrefetchedFrame(BufferFrame& bf);
 
    // -------------------------------------------------------------------------------------
    // Threads managements
@@ -122,6 +133,14 @@ class BufferManager
    BufferFrame& resolveSwip(Guard& swip_guard, Swip<BufferFrame>& swip_value);
    void evictLastPage();
    void reclaimPage(BufferFrame& bf);
+   void reclaimPID(PID pid);  // for pages that are not resident, e.g. evicted pages dropped by their owner
+   // -------------------------------------------------------------------------------------
+   // Read-ahead: loads an evicted page asynchronously into a READY IOFrame, resolveSwip swizzles it in once somebody needs it.
+   // Best effort, never jumps. Returns true if a read was issued
+   bool prefetchSwip(Guard& swip_guard, Swip<BufferFrame>& swip_value);
+   void reapPrefetches(bool wait);
+   bool isPageReady(PID pid);     // an earlier read left the page in a READY IOFrame
+   void cancelPrefetch(PID pid);  // gives the frame back if the page was prefetched but never swizzled in
    // -------------------------------------------------------------------------------------
    /*
     * Life cycle of a fix:
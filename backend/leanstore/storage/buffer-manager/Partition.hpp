@@ -25,6 +25,9 @@ struct IOFrame {
    std::mutex mutex;
    STATE state = STATE::UNDEFINED;
    BufferFrame* bf = nullptr;
+   // Read-ahead: nobody holds mutex while the read is in flight, see BufferManager::prefetchSwip
+   bool prefetched = false;
+   bool prefetch_cancelled = false;
    // -------------------------------------------------------------------------------------
    // Everything in CIOFrame is protected by partition lock
    // except the following counter which is decremented outside to determine
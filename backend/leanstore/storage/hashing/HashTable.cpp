@@ -0,0 +1,688 @@
+#include "HashTable.hpp"
+
+#include "leanstore/concurrency-recovery/CRMG.hpp"
+#include "leanstore/profiling/counters/WorkerCounters.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+using namespace std;
+using namespace leanstore::storage;
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace hashing
+{
+// -------------------------------------------------------------------------------------
+void HashTable::create(DTID dtid, Config config)
+{
+   this->dt_id = dtid;
+   this->config = config;
+   // -------------------------------------------------------------------------------------
+   meta_bf = &BMC::global_bf->allocatePage();
+   Guard guard(meta_bf.asBufferFrame().header.latch, GUARD_STATE::EXCLUSIVE);
+   meta_bf.asBufferFrame().header.keep_in_memory = true;
+   meta_bf.asBufferFrame().page.dt_id = dtid;
+   guard.unlock();
+   // -------------------------------------------------------------------------------------
+   HybridPageGuard<HashMeta> meta(meta_bf);
+   meta.toExclusive();
+   new (meta.ptr()) HashMeta();
+   addBucket(meta, 0);
+   markStructureChanged(meta);
+}
+// -------------------------------------------------------------------------------------
+void HashTable::findBucketPage(HybridPageGuard<HashMeta>& meta, HybridPageGuard<HashBucket>& page, u64 bucket)
+{
+   const u64 l0_index = bucket / HashDirectory::capacity;
+   HybridPageGuard<HashDirectory> l1(meta, meta->directories[l0_index / HashDirectory::capacity]);
+   HybridPageGuard<HashDirectory> l0(l1, l1->children[l0_index % HashDirectory::capacity].cast<HashDirectory>());
+   HybridPageGuard<HashBucket> primary(l0, l0->children[bucket % HashDirectory::capacity].cast<HashBucket>());
+   page = std::move(primary);
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT HashTable::lookup(u8* key, u16 key_length, LookupCallback payload_callback)
+{
+   const u64 key_hash = hash(key, key_length);
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<HashMeta> meta(meta_bf);
+         const u64 bucket = bucketFor(meta->level, meta->split, key_hash);
+         meta.recheck();
+         HybridPageGuard<HashBucket> page;
+         findBucketPage(meta, page, bucket);
+         while (true) {
+            const s32 pos = page->find(key_hash, key, key_length);
+            if (pos != -1) {
+               payload_callback(page->getValue(pos), page->slots[pos].value_length);
+               page.recheck();
+               jumpmu_return OP_RESULT::OK;
+            }
+            if (!page->has_next) {
+               break;
+            }
+            HybridPageGuard<HashBucket> next(page, page->next);
+            page = std::move(next);
+         }
+         page.recheck();
+         // A split may have moved the key to a page we already passed
+         meta.recheck();
+         jumpmu_return OP_RESULT::NOT_FOUND;
+      }
+      jumpmuCatch()
+      {
+         WorkerCounters::myCounters().dt_restarts_read[dt_id]++;
+      }
+   }
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT HashTable::insert(u8* o_key, u16 o_key_length, u8* o_value, u16 o_value_length)
+{
+   if (!HashBucket::fitsIntoEmptyPage(o_key_length, o_value_length)) {
+      return OP_RESULT::NOT_ENOUGH_SPACE;
+   }
+   cr::activeTX().markAsWrite();
+   if (config.enable_wal) {
+      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+   }
+   const Slice key(o_key, o_key_length), value(o_value, o_value_length);
+   const u64 key_hash = hash(o_key, o_key_length);
+   bool overflowed = false;
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<HashMeta> meta(meta_bf);
+         const u64 bucket = bucketFor(meta->level, meta->split, key_hash);
+         meta.recheck();
+         HybridPageGuard<HashBucket> primary, page, target;
+         findBucketPage(meta, primary, bucket);
+         // The key must be in none of the pages, it goes to the first one with enough space or to a new overflow page
+         bool target_is_primary = false;
+         HybridPageGuard<HashBucket>* current = &primary;
+         while (true) {
+            if ((*current)->find(key_hash, o_key, o_key_length) != -1) {
+               current->recheck();
+               jumpmu_return OP_RESULT::DUPLICATE;
+            }
+            if (!target_is_primary && target.bf == nullptr && (*current)->canInsert(o_key_length, o_value_length)) {
+               if (current == &primary) {
+                  target_is_primary = true;
+               } else {
+                  target = std::move(page);
+                  current = &target;
+               }
+            }
+            if (!(*current)->has_next) {
+               break;
+            }
+            HybridPageGuard<HashBucket> next(*current, (*current)->next);
+            page = std::move(next);
+            current = &page;
+         }
+         // -------------------------------------------------------------------------------------
+         // Nothing changed in the chain if the primary page did not
+         primary.toExclusive();
+         meta.recheck();
+         HybridPageGuard<HashBucket>* destination = &primary;
+         if (!target_is_primary) {
+            if (target.bf != nullptr) {
+               target.toExclusive();
+            } else {
+               current->toExclusive();
+               HybridPageGuard<HashBucket> overflow(dt_id);
+               new (overflow.ptr()) HashBucket(primary->bucket, true);
+               (*current)->next = overflow.swip();
+               (*current)->has_next = true;
+               markStructureChanged(*current);
+               target = std::move(overflow);
+               overflowed = true;
+            }
+            destination = &target;
+         }
+         (*destination)->insert(key_hash, key, value);
+         if (config.enable_wal) {
+            logKeyValue(*destination, WAL_LOG_TYPE::WALInsert, key, value);
+         } else {
+            destination->markAsDirty();
+         }
+         jumpmu_break;
+      }
+      jumpmuCatch()
+      {
+         WorkerCounters::myCounters().dt_restarts_structural_change[dt_id]++;
+      }
+   }
+   // Litwin's linear hashing: every new overflow page splits the next bucket in line
+   if (overflowed) {
+      split();
+   }
+   return OP_RESULT::OK;
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT HashTable::updateSameSizeInPlace(u8* o_key, u16 o_key_length, UpdateCallback callback, UpdateSameSizeInPlaceDescriptor&)
+{
+   cr::activeTX().markAsWrite();
+   if (config.enable_wal) {
+      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+   }
+   const u64 key_hash = hash(o_key, o_key_length);
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<HashMeta> meta(meta_bf);
+         const u64 bucket = bucketFor(meta->level, meta->split, key_hash);
+         meta.recheck();
+         HybridPageGuard<HashBucket> primary, page;
+         findBucketPage(meta, primary, bucket);
+         HybridPageGuard<HashBucket>* current = &primary;
+         s32 pos = (*current)->find(key_hash, o_key, o_key_length);
+         while (pos == -1 && (*current)->has_next) {
+            HybridPageGuard<HashBucket> next(*current, (*current)->next);
+            page = std::move(next);
+            current = &page;
+            pos = (*current)->find(key_hash, o_key, o_key_length);
+         }
+         if (pos == -1) {
+            current->recheck();
+            meta.recheck();
+            jumpmu_return OP_RESULT::NOT_FOUND;
+         }
+         primary.toExclusive();
+         meta.recheck();
+         current->toExclusive();
+         // The after image is logged, the values of point-lookup tables are small
+         callback((*current)->getValue(pos), (*current)->slots[pos].value_length);
+         if (config.enable_wal) {
+            logKeyValue(*current, WAL_LOG_TYPE::WALUpdate, Slice(o_key, o_key_length),
+                        Slice((*current)->getValue(pos), (*current)->slots[pos].value_length));
+         } else {
+            current->markAsDirty();
+         }
+         jumpmu_return OP_RESULT::OK;
+      }
+      jumpmuCatch()
+      {
+         WorkerCounters::myCounters().dt_restarts_update_same_size[dt_id]++;
+      }
+   }
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
+// Empty overflow pages stay in the chain, later inserts into the bucket fill them again
+OP_RESULT HashTable::remove(u8* o_key, u16 o_key_length)
+{
+   cr::activeTX().markAsWrite();
+   if (config.enable_wal) {
+      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+   }
+   const u64 key_hash = hash(o_key, o_key_length);
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<HashMeta> meta(meta_bf);
+         const u64 bucket = bucketFor(meta->level, meta->split, key_hash);
+         meta.recheck();
+         HybridPageGuard<HashBucket> primary, page;
+         findBucketPage(meta, primary, bucket);
+         HybridPageGuard<HashBucket>* current = &primary;
+         s32 pos = (*current)->find(key_hash, o_key, o_key_length);
+         while (pos == -1 && (*current)->has_next) {
+            HybridPageGuard<HashBucket> next(*current, (*current)->next);
+            page = std::move(next);
+            current = &page;
+            pos = (*current)->find(key_hash, o_key, o_key_length);
+         }
+         if (pos == -1) {
+            current->recheck();
+            meta.recheck();
+            jumpmu_return OP_RESULT::NOT_FOUND;
+         }
+         primary.toExclusive();
+         meta.recheck();
+         current->toExclusive();
+         if (config.enable_wal) {
+            logKeyValue(*current, WAL_LOG_TYPE::WALRemove, Slice(o_key, o_key_length),
+                        Slice((*current)->getValue(pos), (*current)->slots[pos].value_length));
+         } else {
+            current->markAsDirty();
+         }
+         (*current)->remove(pos);
+         jumpmu_return OP_RESULT::OK;
+      }
+      jumpmuCatch()
+      {
+         WorkerCounters::myCounters().dt_restarts_structural_change[dt_id]++;
+      }
+   }
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
+void HashTable::logKeyValue(HybridPageGuard<HashBucket>& page, WAL_LOG_TYPE type, Slice key, Slice value)
+{
+   auto wal_entry = page.reserveWALEntry<WALKeyValue>(key.length() + value.length());
+   wal_entry->type = type;
+   wal_entry->key_length = key.length();
+   wal_entry->value_length = value.length();
+   std::memcpy(wal_entry->payload, key.data(), key.length());
+   std::memcpy(wal_entry->payload + key.length(), value.data(), value.length());
+   wal_entry.submit();
+}
+// -------------------------------------------------------------------------------------
+// Like the splits of the B-Trees, splits are not logged
+void HashTable::split()
+{
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<HashMeta> meta(meta_bf);
+         meta.toExclusive();
+         const u64 from = meta->split;
+         const u64 to = meta->bucketCount();
+         if (to == max_buckets) {
+            jumpmu_return;  // the chains grow from now on
+         }
+         addBucket(meta, to);
+         moveEntries(meta, from, to);
+         if (++meta->split == (u64(1) << meta->level)) {
+            meta->level++;
+            meta->split = 0;
+         }
+         markStructureChanged(meta);
+         COUNTERS_BLOCK()
+         {
+            WorkerCounters::myCounters().dt_split[dt_id]++;
+         }
+         jumpmu_return;
+      }
+      jumpmuCatch() {}
+   }
+}
+// -------------------------------------------------------------------------------------
+void HashTable::addBucket(HybridPageGuard<HashMeta>& meta, u64 bucket)
+{
+   const u64 l0_index = bucket / HashDirectory::capacity;
+   const u64 l1_index = l0_index / HashDirectory::capacity;
+   while (true) {
+      jumpmuTry()
+      {
+         if (l1_index == meta->count) {
+            HybridPageGuard<HashDirectory> new_l1(dt_id);
+            new_l1.bf->header.keep_in_memory = true;
+            new (new_l1.ptr()) HashDirectory(1, l1_index);
+            meta->directories[l1_index] = new_l1.swip();
+            meta->count++;
+            markStructureChanged(new_l1);
+         }
+         HybridPageGuard<HashDirectory> l1(meta, meta->directories[l1_index]);
+         l1.toExclusive();
+         if (l0_index % HashDirectory::capacity == l1->count) {
+            HybridPageGuard<HashDirectory> new_l0(dt_id);
+            new_l0.bf->header.keep_in_memory = true;
+            new (new_l0.ptr()) HashDirectory(0, l0_index);
+            l1->children[l1->count++] = new_l0.bf;
+            markStructureChanged(new_l0);
+            markStructureChanged(l1);
+         }
+         HybridPageGuard<HashDirectory> l0(l1, l1->children[l0_index % HashDirectory::capacity].cast<HashDirectory>());
+         l0.toExclusive();
+         if (bucket % HashDirectory::capacity == l0->count) {
+            HybridPageGuard<HashBucket> new_bucket(dt_id);
+            new (new_bucket.ptr()) HashBucket(bucket, false);
+            l0->children[l0->count++] = new_bucket.bf;
+            markStructureChanged(new_bucket);
+            markStructureChanged(l0);
+         }
+         jumpmu_return;
+      }
+      jumpmuCatch() {}
+   }
+}
+// -------------------------------------------------------------------------------------
+// Moves the entries of one page of the chain at a time. Entries that moved are gone from the old chain, so after a jump
+// it simply starts over with the first page
+void HashTable::moveEntries(HybridPageGuard<HashMeta>& meta, u64 from, u64 to)
+{
+   const u8 level = meta->level;
+   u64 pages_done = 0;
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<HashBucket> source, destination;
+         findBucketPage(meta, source, from);
+         for (u64 page_i = 0; page_i < pages_done; page_i++) {
+            HybridPageGuard<HashBucket> next(source, source->next);
+            source = std::move(next);
+         }
+         findBucketPage(meta, destination, to);
+         while (destination->has_next) {
+            HybridPageGuard<HashBucket> next(destination, destination->next);
+            destination = std::move(next);
+         }
+         source.toExclusive();
+         destination.toExclusive();
+         // Backwards, remove moves the last slot into the gap
+         for (s32 slot = source->count - 1; slot >= 0; slot--) {
+            if (bucketFor(level + 1, 0, source->slots[slot].hash) != to) {
+               continue;
+            }
+            const u16 key_length = source->slots[slot].key_length, value_length = source->slots[slot].value_length;
+            if (!destination->canInsert(key_length, value_length)) {
+               HybridPageGuard<HashBucket> overflow(dt_id);
+               new (overflow.ptr()) HashBucket(to, true);
+               destination->next = overflow.swip();
+               destination->has_next = true;
+               markStructureChanged(destination);
+               destination = std::move(overflow);
+            }
+            destination->insert(source->slots[slot].hash, Slice(source->getKey(slot), key_length), Slice(source->getValue(slot), value_length));
+            source->remove(slot);
+         }
+         markStructureChanged(source);
+         markStructureChanged(destination);
+         if (!source->has_next) {
+            jumpmu_return;
+         }
+         pages_done++;
+      }
+      jumpmuCatch() {}
+   }
+}
+// -------------------------------------------------------------------------------------
+u64 HashTable::countEntries()
+{
+   u64 buckets;
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<HashMeta> meta(meta_bf);
+         buckets = meta->bucketCount();
+         meta.recheck();
+         jumpmu_break;
+      }
+      jumpmuCatch() {}
+   }
+   u64 entries = 0;
+   for (u64 bucket = 0; bucket < buckets; bucket++) {
+      while (true) {
+         jumpmuTry()
+         {
+            HybridPageGuard<HashMeta> meta(meta_bf);
+            HybridPageGuard<HashBucket> page;
+            findBucketPage(meta, page, bucket);
+            u64 bucket_entries = page->count;
+            while (page->has_next) {
+               HybridPageGuard<HashBucket> next(page, page->next);
+               page = std::move(next);
+               bucket_entries += page->count;
+            }
+            page.recheck();
+            entries += bucket_entries;
+            jumpmu_break;
+         }
+         jumpmuCatch() {}
+      }
+   }
+   return entries;
+}
+// -------------------------------------------------------------------------------------
+u64 HashTable::countPages()
+{
+   u64 buckets;
+   while (true) {
+      jumpmuTry()
+      {
+         HybridPageGuard<HashMeta> meta(meta_bf);
+         buckets = meta->bucketCount();
+         meta.recheck();
+         jumpmu_break;
+      }
+      jumpmuCatch() {}
+   }
+   const u64 l0_directories = (buckets + HashDirectory::capacity - 1) / HashDirectory::capacity;
+   u64 pages = 1 + l0_directories + (l0_directories + HashDirectory::capacity - 1) / HashDirectory::capacity;
+   for (u64 bucket = 0; bucket < buckets; bucket++) {
+      while (true) {
+         jumpmuTry()
+         {
+            HybridPageGuard<HashMeta> meta(meta_bf);
+            HybridPageGuard<HashBucket> page;
+            findBucketPage(meta, page, bucket);
+            u64 chain_length = 1;
+            while (page->has_next) {
+               HybridPageGuard<HashBucket> next(page, page->next);
+               page = std::move(next);
+               chain_length++;
+            }
+            page.recheck();
+            pages += chain_length;
+            jumpmu_break;
+         }
+         jumpmuCatch() {}
+      }
+   }
+   return pages;
+}
+// -------------------------------------------------------------------------------------
+struct DTRegistry::DTMeta HashTable::getMeta()
+{
+   DTRegistry::DTMeta ht_meta = {.iterate_children = iterateChildrenSwips,
+                                 .find_parent = findParent,
+                                 .check_space_utilization = checkSpaceUtilization,
+                                 .checkpoint = checkpoint,
+                                 .undo = undo,
+                                 .todo = todo,
+                                 .unlock = unlock,
+                                 .serialize = serialize,
+                                 .deserialize = deserialize};
+   return ht_meta;
+}
+// -------------------------------------------------------------------------------------
+void HashTable::iterateChildrenSwips(void*, BufferFrame& bf, std::function<bool(Swip<BufferFrame>&)> callback)
+{
+   // Pre: bf is read locked
+   switch (*reinterpret_cast<HashPageType*>(bf.page.dt)) {
+      case HashPageType::META: {
+         auto& meta = *reinterpret_cast<HashMeta*>(bf.page.dt);
+         for (u64 i = 0; i < meta.count; i++) {
+            if (!callback(meta.directories[i].cast<BufferFrame>())) {
+               return;
+            }
+         }
+         break;
+      }
+      case HashPageType::DIRECTORY: {
+         auto& directory = *reinterpret_cast<HashDirectory*>(bf.page.dt);
+         for (u64 i = 0; i < directory.count; i++) {
+            if (!callback(directory.children[i])) {
+               return;
+            }
+         }
+         break;
+      }
+      case HashPageType::BUCKET: {
+         auto& bucket = *reinterpret_cast<HashBucket*>(bf.page.dt);
+         if (bucket.has_next) {
+            callback(bucket.next.cast<BufferFrame>());
+         }
+         break;
+      }
+   }
+}
+// -------------------------------------------------------------------------------------
+// The fields read from to_find are not latched, the swip that is found must point to it
+struct ParentSwipHandler HashTable::findParent(void* ht_object, BufferFrame& to_find)
+{
+   auto& table = *reinterpret_cast<HashTable*>(ht_object);
+   // The meta page stays exclusively latched during a split, which may itself wait for free pages
+   HybridPageGuard<HashMeta> meta(table.meta_bf, LATCH_FALLBACK_MODE::JUMP);
+   if (table.dt_id != to_find.page.dt_id) {
+      jumpmu::jump();
+   }
+   auto found = [&](auto& p_guard, Swip<BufferFrame>& swip) {
+      if (&swip.asBufferFrameMasked() != &to_find) {
+         jumpmu::jump();
+      }
+      return ParentSwipHandler{.swip = swip, .parent_guard = std::move(p_guard.guard), .parent_bf = p_guard.bf};
+   };
+   const HashPageType type = *reinterpret_cast<HashPageType*>(to_find.page.dt);
+   if (type == HashPageType::DIRECTORY) {
+      const auto& directory = *reinterpret_cast<HashDirectory*>(to_find.page.dt);
+      const u8 level = directory.level;
+      const u64 index = directory.index;
+      if (level == 1) {
+         if (index >= meta->count) {
+            jumpmu::jump();
+         }
+         return found(meta, meta->directories[index].cast<BufferFrame>());
+      }
+      if (index / HashDirectory::capacity >= meta->count) {
+         jumpmu::jump();
+      }
+      HybridPageGuard<HashDirectory> l1(meta, meta->directories[index / HashDirectory::capacity], LATCH_FALLBACK_MODE::JUMP);
+      if (index % HashDirectory::capacity >= l1->count) {
+         jumpmu::jump();
+      }
+      return found(l1, l1->children[index % HashDirectory::capacity]);
+   } else if (type != HashPageType::BUCKET) {
+      jumpmu::jump();  // the meta page is never evicted
+   }
+   // -------------------------------------------------------------------------------------
+   const auto& bucket_page = *reinterpret_cast<HashBucket*>(to_find.page.dt);
+   const u64 bucket = bucket_page.bucket;
+   const bool is_overflow = bucket_page.is_overflow;
+   if (bucket >= meta->bucketCount()) {
+      jumpmu::jump();
+   }
+   const u64 l0_index = bucket / HashDirectory::capacity;
+   HybridPageGuard<HashDirectory> l1(meta, meta->directories[l0_index / HashDirectory::capacity], LATCH_FALLBACK_MODE::JUMP);
+   HybridPageGuard<HashDirectory> l0(l1, l1->children[l0_index % HashDirectory::capacity].cast<HashDirectory>(), LATCH_FALLBACK_MODE::JUMP);
+   Swip<BufferFrame>& primary_swip = l0->children[bucket % HashDirectory::capacity];
+   if (!is_overflow) {
+      return found(l0, primary_swip);
+   }
+   // Overflow pages hang off their predecessor, which is only resident while it is hot
+   if (!primary_swip.isHOT()) {
+      jumpmu::jump();
+   }
+   HybridPageGuard<HashBucket> page(l0, primary_swip.cast<HashBucket>(), LATCH_FALLBACK_MODE::JUMP);
+   while (true) {
+      if (!page->has_next) {
+         jumpmu::jump();
+      }
+      if (&page->next.asBufferFrameMasked() == &to_find) {
+         return found(page, page->next.cast<BufferFrame>());
+      }
+      if (!page->next.isHOT()) {
+         jumpmu::jump();
+      }
+      HybridPageGuard<HashBucket> next(page, page->next, LATCH_FALLBACK_MODE::JUMP);
+      page = std::move(next);
+   }
+}
+// -------------------------------------------------------------------------------------
+// pre: source buffer frame is shared latched
+void HashTable::checkpoint(void*, BufferFrame& bf, u8* dest)
+{
+   std::memcpy(dest, bf.page.dt, EFFECTIVE_PAGE_SIZE);
+   auto unswizzle = [](Swip<BufferFrame>& swip) {
+      if (!swip.isEVICTED()) {
+         auto& child_bf = swip.asBufferFrameMasked();
+         swip.evict(child_bf.header.pid);
+      }
+   };
+   switch (*reinterpret_cast<HashPageType*>(dest)) {
+      case HashPageType::META: {
+         auto& meta = *reinterpret_cast<HashMeta*>(dest);
+         for (u64 i = 0; i < meta.count; i++) {
+            unswizzle(meta.directories[i].cast<BufferFrame>());
+         }
+         break;
+      }
+      case HashPageType::DIRECTORY: {
+         auto& directory = *reinterpret_cast<HashDirectory*>(dest);
+         for (u64 i = 0; i < directory.count; i++) {
+            unswizzle(directory.children[i]);
+         }
+         break;
+      }
+      case HashPageType::BUCKET: {
+         auto& bucket = *reinterpret_cast<HashBucket*>(dest);
+         if (bucket.has_next) {
+            unswizzle(bucket.next.cast<BufferFrame>());
+         }
+         break;
+      }
+   }
+}
+// -------------------------------------------------------------------------------------
+void HashTable::undo(void*, const u8*, const u64)
+{
+   // TODO: undo for storage
+   TODOException();
+}
+// -------------------------------------------------------------------------------------
+void HashTable::todo(void*, const u8*, const u64, const u64, const bool)
+{
+   UNREACHABLE();
+}
+// -------------------------------------------------------------------------------------
+void HashTable::unlock(void*, const u8*)
+{
+   UNREACHABLE();
+}
+// -------------------------------------------------------------------------------------
+std::unordered_map<std::string, std::string> HashTable::serialize(void* ht_object)
+{
+   auto& table = *reinterpret_cast<HashTable*>(ht_object);
+   assert(table.meta_bf.asBufferFrame().page.dt_id == table.dt_id);
+   return {{"dt_id", std::to_string(table.dt_id)}, {"meta_pid", std::to_string(table.meta_bf.asBufferFrame().header.pid)}};
+}
+// -------------------------------------------------------------------------------------
+// Loads the meta page and the directories and keeps them in memory, as if they had never been evicted
+void HashTable::deserialize(void* ht_object, std::unordered_map<std::string, std::string> map)
+{
+   auto& table = *reinterpret_cast<HashTable*>(ht_object);
+   table.dt_id = std::stol(map["dt_id"]);
+   table.meta_bf.evict(std::stol(map["meta_pid"]));
+   auto& meta = *reinterpret_cast<HashMeta*>(pin(table.meta_bf).page.dt);
+   for (u64 i = 0; i < meta.count; i++) {
+      auto& l1 = *reinterpret_cast<HashDirectory*>(pin(meta.directories[i].cast<BufferFrame>()).page.dt);
+      for (u64 j = 0; j < l1.count; j++) {
+         pin(l1.children[j]);
+      }
+   }
+   assert(table.meta_bf.asBufferFrame().page.dt_id == table.dt_id);
+}
+// -------------------------------------------------------------------------------------
+BufferFrame& HashTable::pin(Swip<BufferFrame>& swip)
+{
+   HybridLatch dummy_latch;
+   Guard dummy_guard(&dummy_latch);
+   dummy_guard.toOptimisticSpin();
+   u16 failcounter = 0;
+   while (true) {
+      jumpmuTry()
+      {
+         BufferFrame& bf = BMC::global_bf->resolveSwip(dummy_guard, swip);
+         bf.header.keep_in_memory = true;
+         jumpmu_return bf;
+      }
+      jumpmuCatch()
+      {
+         failcounter++;
+         if (failcounter >= 200) {
+            cerr << "Failed to load a hash table directory, Buffer might be to small" << endl;
+            assert(false);
+         }
+      }
+   }
+}
+// -------------------------------------------------------------------------------------
+}  // namespace hashing
+}  // namespace storage
+}  // namespace leanstore
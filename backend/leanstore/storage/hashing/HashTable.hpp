@@ -0,0 +1,209 @@
+#pragma once
+#include "Units.hpp"
+#include "leanstore/Config.hpp"
+#include "leanstore/KVInterface.hpp"
+#include "leanstore/storage/buffer-manager/BufferManager.hpp"
+#include "leanstore/sync-primitives/PageGuard.hpp"
+#include "leanstore/utils/FNVHash.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <cstring>
+#include <unordered_map>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace hashing
+{
+// -------------------------------------------------------------------------------------
+// All pages of a hash table start with their type, so that the buffer manager callbacks can tell them apart
+enum class HashPageType : u8 { META = 0, DIRECTORY = 1, BUCKET = 2 };
+struct HashDirectory;
+// -------------------------------------------------------------------------------------
+// Linear hashing: the table has 2^level + split buckets, bucket split is the next one to be split into split + 2^level
+struct HashMeta {
+   static constexpr u64 capacity = (EFFECTIVE_PAGE_SIZE - 3 * sizeof(u64)) / sizeof(u64);
+   HashPageType type = HashPageType::META;
+   u8 level = 0;
+   u64 split = 0;
+   u64 count = 0;  // level 1 directories
+   Swip<HashDirectory> directories[capacity];
+   // -------------------------------------------------------------------------------------
+   u64 bucketCount() const { return (u64(1) << level) + split; }
+};
+static_assert(sizeof(HashMeta) <= EFFECTIVE_PAGE_SIZE, "");
+// Level 1 directories point to level 0 directories, those point to the primary pages of the buckets.
+// Directories are kept in memory like the meta page, only bucket pages are evicted
+struct HashDirectory {
+   static constexpr u64 capacity = (EFFECTIVE_PAGE_SIZE - 3 * sizeof(u64)) / sizeof(u64);
+   HashPageType type = HashPageType::DIRECTORY;
+   u8 level;
+   u64 index;  // among the directories of its level
+   u64 count = 0;
+   Swip<BufferFrame> children[capacity];
+   // -------------------------------------------------------------------------------------
+   HashDirectory(u8 level, u64 index) : level(level), index(index) {}
+};
+static_assert(sizeof(HashDirectory) <= EFFECTIVE_PAGE_SIZE, "");
+// -------------------------------------------------------------------------------------
+// Slotted page of a bucket. Payloads grow from the end of the page, removed ones leave holes until the page is compacted.
+// Entries that do not fit into the primary page go to a chain of overflow pages
+struct HashBucket {
+   struct Slot {
+      u32 hash;  // lower half of the key hash, enough to address any bucket
+      u16 offset;
+      u16 key_length;
+      u16 value_length;
+   };
+   HashPageType type = HashPageType::BUCKET;
+   bool is_overflow;
+   bool has_next = false;
+   u16 count = 0;
+   u16 data_offset = EFFECTIVE_PAGE_SIZE;
+   u16 space_used = 0;  // by the payloads of live entries
+   u64 bucket;
+   Swip<HashBucket> next;
+   Slot slots[];
+   // -------------------------------------------------------------------------------------
+   HashBucket(u64 bucket, bool is_overflow) : is_overflow(is_overflow), bucket(bucket) {}
+   // -------------------------------------------------------------------------------------
+   static constexpr u64 spaceNeeded(u16 key_length, u16 value_length) { return sizeof(Slot) + key_length + value_length; }
+   static constexpr bool fitsIntoEmptyPage(u16 key_length, u16 value_length)
+   {
+      return sizeof(HashBucket) + spaceNeeded(key_length, value_length) <= EFFECTIVE_PAGE_SIZE;
+   }
+   u8* ptr() { return reinterpret_cast<u8*>(this); }
+   u8* getKey(u16 slot) { return ptr() + slots[slot].offset; }
+   u8* getValue(u16 slot) { return ptr() + slots[slot].offset + slots[slot].key_length; }
+   u64 freeSpace() const { return data_offset - (sizeof(HashBucket) + count * sizeof(Slot)); }
+   u64 freeSpaceAfterCompaction() const { return EFFECTIVE_PAGE_SIZE - (sizeof(HashBucket) + count * sizeof(Slot)) - space_used; }
+   bool canInsert(u16 key_length, u16 value_length) const { return freeSpaceAfterCompaction() >= spaceNeeded(key_length, value_length); }
+   // -------------------------------------------------------------------------------------
+   s32 find(u32 hash, const u8* key, u16 key_length)
+   {
+      for (u16 slot = 0; slot < count; slot++) {
+         if (slots[slot].hash == hash && slots[slot].key_length == key_length && std::memcmp(getKey(slot), key, key_length) == 0) {
+            return slot;
+         }
+      }
+      return -1;
+   }
+   // Pre: canInsert
+   void insert(u32 hash, Slice key, Slice value)
+   {
+      if (freeSpace() < spaceNeeded(key.length(), value.length())) {
+         compactify();
+      }
+      data_offset -= key.length() + value.length();
+      space_used += key.length() + value.length();
+      slots[count] = {
+          .hash = hash, .offset = data_offset, .key_length = static_cast<u16>(key.length()), .value_length = static_cast<u16>(value.length())};
+      std::memcpy(ptr() + data_offset, key.data(), key.length());
+      std::memcpy(ptr() + data_offset + key.length(), value.data(), value.length());
+      count++;
+   }
+   // Moves the last slot into the gap, entries are unordered
+   void remove(u16 slot)
+   {
+      space_used -= slots[slot].key_length + slots[slot].value_length;
+      slots[slot] = slots[count - 1];
+      count--;
+   }
+   void compactify()
+   {
+      u8 payloads[EFFECTIVE_PAGE_SIZE];
+      u16 offset = EFFECTIVE_PAGE_SIZE;
+      for (u16 slot = 0; slot < count; slot++) {
+         const u16 length = slots[slot].key_length + slots[slot].value_length;
+         offset -= length;
+         std::memcpy(payloads + offset, getKey(slot), length);
+         slots[slot].offset = offset;
+      }
+      std::memcpy(ptr() + offset, payloads + offset, EFFECTIVE_PAGE_SIZE - offset);
+      data_offset = offset;
+   }
+};
+// -------------------------------------------------------------------------------------
+// Buffer-managed hash index for tables that only see point operations. It uses linear hashing, so every bucket page has
+// exactly one swip pointing to it: the primary page of a bucket hangs off a level 0 directory, an overflow page off its
+// predecessor in the chain. Bucket pages are evicted and recovered like B-Tree nodes, directories stay in memory.
+// Writers of a bucket serialize on the exclusive latch of its primary page. A split latches the meta page exclusively, so
+// everybody else restarts or waits until the entries have moved. Operations recheck the meta page before they return
+class HashTable : public KVInterface
+{
+  public:
+   struct Config {
+      bool enable_wal = true;
+   };
+   enum class WAL_LOG_TYPE : u8 { WALInsert = 1, WALUpdate = 2, WALRemove = 3 };
+   struct WALEntry {
+      WAL_LOG_TYPE type;
+   };
+   // The same layout for all of them: key | value, for updates the value after the update
+   struct WALKeyValue : WALEntry {
+      u16 key_length;
+      u16 value_length;
+      u8 payload[];
+   };
+   static constexpr u64 max_buckets = HashMeta::capacity * HashDirectory::capacity * HashDirectory::capacity;
+   // -------------------------------------------------------------------------------------
+   Swip<BufferFrame> meta_bf;  // kept in memory
+   DTID dt_id;
+   Config config;
+   // -------------------------------------------------------------------------------------
+   HashTable() = default;
+   void create(DTID dtid, Config config);
+   // -------------------------------------------------------------------------------------
+   virtual OP_RESULT lookup(u8* key, u16 key_length, LookupCallback payload_callback) override;
+   virtual OP_RESULT insert(u8* key, u16 key_length, u8* value, u16 value_length) override;
+   virtual OP_RESULT updateSameSizeInPlace(u8* key, u16 key_length, UpdateCallback, UpdateSameSizeInPlaceDescriptor&) override;
+   virtual OP_RESULT remove(u8* key, u16 key_length) override;
+   // Entries are unordered
+   virtual OP_RESULT scanAsc(u8*, u16, ScanCallback, std::function<void()>) override { return OP_RESULT::OTHER; }
+   virtual OP_RESULT scanDesc(u8*, u16, ScanCallback, std::function<void()>) override { return OP_RESULT::OTHER; }
+   // -------------------------------------------------------------------------------------
+   virtual u64 countPages() override;
+   virtual u64 countEntries() override;
+   virtual u64 getHeight() override { return 3; }  // two directory levels above the buckets
+   // -------------------------------------------------------------------------------------
+   static void iterateChildrenSwips(void*, BufferFrame& bf, std::function<bool(Swip<BufferFrame>&)> callback);
+   static ParentSwipHandler findParent(void* ht_object, BufferFrame& to_find);
+   static SpaceCheckResult checkSpaceUtilization(void*, BufferFrame&) { return SpaceCheckResult::NOTHING; }
+   static void checkpoint(void*, BufferFrame& bf, u8* dest);
+   static void undo(void* ht_object, const u8* wal_entry_ptr, const u64 tts);
+   static void todo(void* ht_object, const u8* entry_ptr, const u64 version_worker_id, const u64 tx_id, const bool called_before);
+   static void unlock(void* ht_object, const u8* entry_ptr);
+   static std::unordered_map<std::string, std::string> serialize(void* ht_object);
+   static void deserialize(void* ht_object, std::unordered_map<std::string, std::string> serialized);
+   static DTRegistry::DTMeta getMeta();
+
+  private:
+   static inline u64 hash(const u8* key, u16 key_length) { return utils::FNV::hash(key, key_length); }
+   static inline u64 bucketFor(u8 level, u64 split, u64 key_hash)
+   {
+      const u64 bucket = key_hash & ((u64(1) << level) - 1);
+      return (bucket < split) ? key_hash & ((u64(2) << level) - 1) : bucket;
+   }
+   // Couples from meta through the directories to the primary page of bucket, all optimistically
+   void findBucketPage(HybridPageGuard<HashMeta>& meta, HybridPageGuard<HashBucket>& page, u64 bucket);
+   // Pre: meta is exclusively latched. Both can jump, but repeating them after a jump is harmless
+   void addBucket(HybridPageGuard<HashMeta>& meta, u64 bucket);
+   void moveEntries(HybridPageGuard<HashMeta>& meta, u64 from, u64 to);
+   void split();
+   template <typename T>
+   void markStructureChanged(HybridPageGuard<T>& guard)
+   {
+      if (config.enable_wal) {
+         guard.incrementGSN();
+      } else {
+         guard.markAsDirty();
+      }
+   }
+   void logKeyValue(HybridPageGuard<HashBucket>& page, WAL_LOG_TYPE type, Slice key, Slice value);
+   static BufferFrame& pin(Swip<BufferFrame>& swip);
+};
+// -------------------------------------------------------------------------------------
+}  // namespace hashing
+}  // namespace storage
+}  // namespace leanstore
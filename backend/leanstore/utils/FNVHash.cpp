@@ -21,5 +21,15 @@ u64 FNV::hash(u64 val)
    return hash_val;
 }
 // -------------------------------------------------------------------------------------
+u64 FNV::hash(const u8* data, u64 length)
+{
+   u64 hash_val = FNV_OFFSET_BASIS_64;
+   for (u64 i = 0; i < length; i++) {
+      hash_val = hash_val ^ data[i];
+      hash_val = hash_val * FNV_PRIME_64;
+   }
+   return hash_val;
+}
+// -------------------------------------------------------------------------------------
 }  // namespace utils
 }  // namespace leanstore
@@ -1,3 +1,4 @@
+#pragma once
 #include "Units.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
@@ -15,6 +16,7 @@ class FNV
 
   public:
    static u64 hash(u64 val);
+   static u64 hash(const u8* data, u64 length);
 };
 // -------------------------------------------------------------------------------------
 }  // namespace utils
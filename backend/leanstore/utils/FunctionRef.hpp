@@ -0,0 +1,37 @@
+#pragma once
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <memory>
+#include <type_traits>
+#include <utility>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace utils
+{
+// -------------------------------------------------------------------------------------
+template <typename Signature>
+class FunctionRef;
+// -------------------------------------------------------------------------------------
+// Non-owning reference to a callable, two words that are passed in registers.
+// Unlike std::function it never allocates and copying it is free, but the callable must outlive the reference,
+// so only use it for parameters that are not stored beyond the call
+template <typename R, typename... Args>
+class FunctionRef<R(Args...)>
+{
+   void* callable;
+   R (*trampoline)(void*, Args...);
+
+  public:
+   template <typename F,
+             typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, FunctionRef> && std::is_invocable_r_v<R, F&, Args...>>>
+   FunctionRef(F&& f)
+       : callable(const_cast<void*>(static_cast<const void*>(std::addressof(f)))),
+         trampoline([](void* c, Args... args) -> R { return (*reinterpret_cast<std::remove_reference_t<F>*>(c))(std::forward<Args>(args)...); })
+   {
+   }
+   R operator()(Args... args) const { return trampoline(callable, std::forward<Args>(args)...); }
+};
+// -------------------------------------------------------------------------------------
+}  // namespace utils
+}  // namespace leanstore
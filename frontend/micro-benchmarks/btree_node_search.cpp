@@ -0,0 +1,177 @@
+#include "Units.hpp"
+#include "leanstore/Config.hpp"
+#include "leanstore/storage/btree/core/BTreeFixedNode.hpp"
+#include "leanstore/storage/btree/core/BTreeNode.hpp"
+#include "leanstore/utils/RandomGenerator.hpp"
+// -------------------------------------------------------------------------------------
+#include <gflags/gflags.h>
+// -------------------------------------------------------------------------------------
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+// -------------------------------------------------------------------------------------
+// Lookups into full inner and leaf nodes: classic slot heads vs. the contiguous heads array with each SIMD kernel vs. the
+// key array of BTreeFixed (8 byte values).
+// Equality lookups (hits and misses) into full leaves: slot heads vs. fingerprints with each SIMD kernel
+// -------------------------------------------------------------------------------------
+using namespace leanstore;
+using namespace leanstore::storage::btree;
+// -------------------------------------------------------------------------------------
+DEFINE_uint64(search_nodes, 10000, "Number of full nodes to search in (more nodes -> more cache misses)");
+DEFINE_uint64(search_lookups, 10000000, "Lookups per run");
+DEFINE_uint64(search_payload_size, 8, "Leaf payload size");
+// -------------------------------------------------------------------------------------
+using FixedNode = BTreeFixedNode<u64, std::array<u8, 8>>;
+struct Node {
+   std::unique_ptr<BufferFrame::Page> page = std::make_unique<BufferFrame::Page>();
+   std::vector<u64> keys;
+   BTreeNode& node() { return *reinterpret_cast<BTreeNode*>(page->dt); }
+   FixedNode& fixedNode() { return *reinterpret_cast<FixedNode*>(page->dt); }
+};
+// -------------------------------------------------------------------------------------
+std::vector<Node> fillNodes(bool is_leaf, u16 heads_capacity, u16 fingerprints_capacity = 0)
+{
+   const u16 payload_size = is_leaf ? FLAGS_search_payload_size : sizeof(SwipType);
+   u8 payload[payload_size];
+   std::memset(payload, 0, payload_size);
+   std::vector<Node> nodes(FLAGS_search_nodes);
+   for (auto& n : nodes) {
+      new (n.page->dt) BTreeNode(is_leaf, heads_capacity, fingerprints_capacity);
+      u8 key[sizeof(u64)];
+      while (true) {
+         const u64 k = utils::RandomGenerator::getRandU64();
+         *reinterpret_cast<u64*>(key) = __builtin_bswap64(k);
+         if (!n.node().prepareInsert(sizeof(key), payload_size) || n.node().lowerBound<true>(key, sizeof(key)) != -1) {
+            break;
+         }
+         n.node().insert(key, sizeof(key), payload, payload_size);
+         n.keys.push_back(k);
+      }
+   }
+   return nodes;
+}
+// -------------------------------------------------------------------------------------
+std::vector<Node> fillFixedNodes(bool is_leaf)
+{
+   std::vector<Node> nodes(FLAGS_search_nodes);
+   for (auto& n : nodes) {
+      auto& node = *new (n.page->dt) FixedNode(is_leaf);
+      while (!node.isFull()) {
+         const u64 k = utils::RandomGenerator::getRandU64();
+         const u16 pos = node.lowerBound(k);
+         if (pos < node.count && node.keys()[pos] == k) {
+            continue;
+         }
+         if (is_leaf) {
+            node.insert(pos, k, {});
+         } else {
+            node.insertSeparator(pos, k, nullptr);
+         }
+         n.keys.push_back(k);
+      }
+   }
+   return nodes;
+}
+// -------------------------------------------------------------------------------------
+template <bool fixed = false>
+double run(std::vector<Node>& nodes)
+{
+   std::vector<std::pair<u32, u64>> probes(FLAGS_search_lookups);
+   for (auto& probe : probes) {
+      const u32 n_i = utils::RandomGenerator::getRandU64(0, nodes.size());
+      const u64 key = nodes[n_i].keys[utils::RandomGenerator::getRandU64(0, nodes[n_i].keys.size())];
+      probe = {n_i, fixed ? key : __builtin_bswap64(key)};
+   }
+   u64 checksum = 0;
+   const auto begin = std::chrono::high_resolution_clock::now();
+   for (auto& probe : probes) {
+      if constexpr (fixed) {
+         checksum += nodes[probe.first].fixedNode().lowerBound(probe.second);
+      } else {
+         checksum += nodes[probe.first].node().lowerBound<false>(reinterpret_cast<u8*>(&probe.second), sizeof(u64));
+      }
+   }
+   const auto end = std::chrono::high_resolution_clock::now();
+   DO_NOT_OPTIMIZE(checksum);
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() * 1.0 / probes.size();
+}
+// -------------------------------------------------------------------------------------
+// Misses draw random keys, which are absent with overwhelming probability
+double runEquality(std::vector<Node>& nodes, bool hits)
+{
+   std::vector<std::pair<u32, u64>> probes(FLAGS_search_lookups);
+   for (auto& probe : probes) {
+      const u32 n_i = utils::RandomGenerator::getRandU64(0, nodes.size());
+      const u64 key = hits ? nodes[n_i].keys[utils::RandomGenerator::getRandU64(0, nodes[n_i].keys.size())] : utils::RandomGenerator::getRandU64();
+      probe = {n_i, __builtin_bswap64(key)};
+   }
+   u64 checksum = 0;
+   const auto begin = std::chrono::high_resolution_clock::now();
+   for (auto& probe : probes) {
+      checksum += nodes[probe.first].node().lowerBound<true>(reinterpret_cast<u8*>(&probe.second), sizeof(u64));
+   }
+   const auto end = std::chrono::high_resolution_clock::now();
+   DO_NOT_OPTIMIZE(checksum);
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() * 1.0 / probes.size();
+}
+// -------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+   gflags::SetUsageMessage("BTreeNode search micro-benchmark");
+   gflags::ParseCommandLineFlags(&argc, &argv, true);
+   // -------------------------------------------------------------------------------------
+   struct Kernel {
+      std::string name;
+      s64 flag;
+   };
+   std::vector<Kernel> kernels = {{"scalar", 1}};
+#if defined(__x86_64__)
+   if (__builtin_cpu_supports("avx2"))
+      kernels.push_back({"avx2", 2});
+   if (__builtin_cpu_supports("avx512f"))
+      kernels.push_back({"avx512", 3});
+#elif defined(__aarch64__)
+   kernels.push_back({"neon", 4});
+#endif
+   // -------------------------------------------------------------------------------------
+   cout << "node,layout,entries_per_node,ns_per_lookup" << endl;
+   for (bool is_leaf : {false, true}) {
+      const std::string node_type = is_leaf ? "leaf" : "inner";
+      {
+         auto nodes = fillNodes(is_leaf, 0);
+         const double ns = run(nodes);
+         cout << node_type << ",slots," << nodes[0].keys.size() << "," << ns << endl;
+      }
+      auto nodes = fillNodes(is_leaf, BTreeNode::heads_growth);
+      for (auto& kernel : kernels) {
+         FLAGS_btree_heads_simd = kernel.flag;
+         BTreeNode::pickSIMDKernels();
+         const double ns = run(nodes);
+         cout << node_type << ",heads_" << kernel.name << "," << nodes[0].keys.size() << "," << ns << endl;
+      }
+      {
+         auto fixed_nodes = fillFixedNodes(is_leaf);
+         const double ns = run<true>(fixed_nodes);
+         cout << node_type << ",fixed," << fixed_nodes[0].keys.size() << "," << ns << endl;
+      }
+   }
+   for (bool hits : {true, false}) {
+      const std::string lookup_type = hits ? "leaf_equal_hit" : "leaf_equal_miss";
+      {
+         auto nodes = fillNodes(true, 0);
+         const double ns = runEquality(nodes, hits);
+         cout << lookup_type << ",slots," << nodes[0].keys.size() << "," << ns << endl;
+      }
+      auto nodes = fillNodes(true, 0, BTreeNode::fingerprints_growth);
+      for (auto& kernel : kernels) {
+         FLAGS_btree_heads_simd = kernel.flag;
+         BTreeNode::pickSIMDKernels();
+         const double ns = runEquality(nodes, hits);
+         cout << lookup_type << ",fingerprints_" << kernel.name << "," << nodes[0].keys.size() << "," << ns << endl;
+      }
+   }
+   return 0;
+}
@@ -0,0 +1,70 @@
+#include "Units.hpp"
+#include "leanstore/Config.hpp"
+#include "leanstore/concurrency-recovery/HistoryLog.hpp"
+#include "leanstore/concurrency-recovery/HistoryTree.hpp"
+// -------------------------------------------------------------------------------------
+#include <gflags/gflags.h>
+// -------------------------------------------------------------------------------------
+#include <cstring>
+#include <iostream>
+#include <memory>
+// -------------------------------------------------------------------------------------
+// Purges of the in-memory history log: fills the log with one version up to a few segments, purges it completely, inserts
+// more versions and purges half of them again. Covers the fill levels that leave the oldest segment exactly full, after which
+// the next insert takes a new segment while the purged one stays in front of it
+// -------------------------------------------------------------------------------------
+using namespace leanstore;
+// -------------------------------------------------------------------------------------
+DEFINE_uint64(hl_max_versions, 64, "Largest number of versions before the full purge, should span a few segments");
+DEFINE_uint64(hl_more_versions, 20, "Versions inserted after the full purge");
+// -------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+   gflags::ParseCommandLineFlags(&argc, &argv, true);
+   FLAGS_history_tree_inserts = true;
+   FLAGS_history_log_segment_kib = 1;
+   // -------------------------------------------------------------------------------------
+   constexpr WORKERID worker_id = 0;
+   constexpr DTID dt_id = 0;
+   constexpr u64 payload_length = 40;
+   // Nothing spills with in-order inserts of the own thread, the history tree is never touched
+   auto history_tree = std::make_unique<cr::HistoryTree>();
+   for (u64 fill = 1; fill <= FLAGS_hl_max_versions; fill++) {
+      cr::HistoryLog history_log(*history_tree, 1);
+      auto insert = [&](TXID tx_id) {
+         history_log.insertVersion(
+             worker_id, tx_id, 0, dt_id, true, payload_length, [&](u8* payload) { std::memset(payload, u8(tx_id), payload_length); }, true);
+      };
+      u64 purged = 0;
+      auto purge = [&](TXID to_tx_id) {
+         history_log.purgeVersions(
+             worker_id, 0, to_tx_id, [&](const TXID, const DTID, const u8*, u64, const bool) { purged++; }, 0);
+      };
+      auto retrievable = [&](TXID tx_id) {
+         return history_log.retrieveVersion(worker_id, tx_id, 0, true, [&](const u8* payload, u64 length) {
+            ensure(length == payload_length && payload[0] == u8(tx_id));
+         });
+      };
+      // -------------------------------------------------------------------------------------
+      for (TXID tx_id = 1; tx_id <= fill; tx_id++) {
+         insert(tx_id);
+      }
+      purge(fill);
+      ensure(purged == fill);
+      const TXID first = fill + 1, last = fill + FLAGS_hl_more_versions, middle = fill + FLAGS_hl_more_versions / 2;
+      for (TXID tx_id = first; tx_id <= last; tx_id++) {
+         insert(tx_id);
+      }
+      purged = 0;
+      purge(middle);
+      ensure(purged == middle - fill);
+      for (TXID tx_id = first; tx_id <= last; tx_id++) {
+         ensure(retrievable(tx_id) == (tx_id > middle));
+      }
+      purged = 0;
+      purge(last);
+      ensure(purged == last - middle);
+   }
+   std::cout << "history log purges passed for up to " << FLAGS_hl_max_versions << " versions" << std::endl;
+   return 0;
+}
@@ -22,6 +22,8 @@ using Payload = u64;
 using KVTable = Relation<Key, Payload>;
 // -------------------------------------------------------------------------------------
 DEFINE_uint64(sleep_for_seconds, 0, "");
+DEFINE_bool(queue_dt, false, "use QueueDT instead of emulating the queue with a B-Tree");
+DEFINE_uint64(queue_batch, 1, "entries popped per transaction with queue_dt");
 // -------------------------------------------------------------------------------------
 int main(int argc, char** argv)
 {
@@ -30,7 +32,14 @@ int main(int argc, char** argv)
    LeanStore db;
    auto& crm = db.getCRManager();
    LeanStoreAdapter<KVTable> table;
-   crm.scheduleJobSync(0, [&]() { table = LeanStoreAdapter<KVTable>(db, "queue"); });
+   storage::blob::QueueDT* queue = nullptr;
+   crm.scheduleJobSync(0, [&]() {
+      if (FLAGS_queue_dt) {
+         queue = &db.registerQueue("queue", {.enable_wal = FLAGS_wal});
+      } else {
+         table = LeanStoreAdapter<KVTable>(db, "queue");
+      }
+   });
    // -------------------------------------------------------------------------------------
    const u64 N = FLAGS_target_gib * 1024 * 1024 * 1024 * 1.0 / 2.0 / (sizeof(Key) + sizeof(Payload));
    // Insert values
@@ -41,7 +50,11 @@ int main(int argc, char** argv)
          {
             cr::Worker::my().startTX(TX_MODE::OLTP, leanstore::TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION);
             for (u64 i = begin; i < end; i++) {
-               table.insert({i}, {i});
+               if (FLAGS_queue_dt) {
+                  queue->push(reinterpret_cast<const u8*>(&i), sizeof(i));
+               } else {
+                  table.insert({i}, {i});
+               }
             }
             cr::Worker::my().commitTX();
          }
@@ -73,28 +86,39 @@ int main(int argc, char** argv)
    });
    crm.scheduleJobAsync(1, [&]() {
       running_threads_counter++;
+      Key next_key = N;
       while (keep_running) {
          jumpmuTry()
          {
             cr::Worker::my().startTX(leanstore::TX_MODE::OLTP, leanstore::TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION);
-            Key oldest = 0, newest = 0;
-            table.scan(
-                {0},
-                [&](const KVTable::Key& key, const KVTable&) {
-                   oldest = key.my_key;
-                   return false;
-                },
-                [&]() {});
-            table.scanDesc(
-                {std::numeric_limits<Key>::max()},
-                [&](const KVTable::Key& key, const KVTable&) {
-                   newest = key.my_key;
-                   return false;
-                },
-                [&]() {});
-            bool ret = table.erase({oldest});
-            ensure(ret);
-            table.insert({newest + 1}, {});
+            if (FLAGS_queue_dt) {
+               // Same work as with the B-Tree: consume the oldest entries and append as many new ones
+               const u64 count = queue->popBatch(FLAGS_queue_batch, [&](const u8*, u16) {});
+               ensure(count == FLAGS_queue_batch);
+               for (u64 i = 0; i < count; i++) {
+                  queue->push(reinterpret_cast<const u8*>(&next_key), sizeof(Key));
+                  next_key++;
+               }
+            } else {
+               Key oldest = 0, newest = 0;
+               table.scan(
+                   {0},
+                   [&](const KVTable::Key& key, const KVTable&) {
+                      oldest = key.my_key;
+                      return false;
+                   },
+                   [&]() {});
+               table.scanDesc(
+                   {std::numeric_limits<Key>::max()},
+                   [&](const KVTable::Key& key, const KVTable&) {
+                      newest = key.my_key;
+                      return false;
+                   },
+                   [&]() {});
+               bool ret = table.erase({oldest});
+               ensure(ret);
+               table.insert({newest + 1}, {});
+            }
             cr::Worker::my().commitTX();
             COUNTERS_BLOCK() { WorkerCounters::myCounters().tx++; }
          }
@@ -0,0 +1,82 @@
+#include "Units.hpp"
+#include "leanstore/Config.hpp"
+#include "leanstore/LeanStore.hpp"
+#include "leanstore/utils/Parallelize.hpp"
+// -------------------------------------------------------------------------------------
+#include <gflags/gflags.h>
+// -------------------------------------------------------------------------------------
+#include <chrono>
+#include <functional>
+#include <iostream>
+// -------------------------------------------------------------------------------------
+// Full ascending scan over a BTreeLL of u64 -> u64 tuples, once per way of passing the per-tuple code:
+// std::function (what KVInterface used to take), KVInterface with FunctionRef, the templated overload and the Cursor
+// -------------------------------------------------------------------------------------
+using namespace leanstore;
+using namespace leanstore::storage::btree;
+// -------------------------------------------------------------------------------------
+DEFINE_uint64(scan_tuples, 100000000, "Number of tuples to load and scan");
+DEFINE_uint64(scan_runs, 3, "Scans per variant, the fastest one is reported");
+// -------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+   gflags::SetUsageMessage("scanAsc callback micro-benchmark");
+   gflags::ParseCommandLineFlags(&argc, &argv, true);
+   // -------------------------------------------------------------------------------------
+   LeanStore db;
+   auto& crm = db.getCRManager();
+   BTreeLL* btree;
+   crm.scheduleJobSync(0, [&]() { btree = &db.registerBTreeLL("scan", {.enable_wal = false, .use_bulk_insert = false}); });
+   // -------------------------------------------------------------------------------------
+   cout << "Inserting " << FLAGS_scan_tuples << " tuples" << endl;
+   utils::Parallelize::range(FLAGS_worker_threads, FLAGS_scan_tuples, [&](u64 t_i, u64 begin, u64 end) {
+      crm.scheduleJobAsync(t_i, [&, begin, end]() {
+         cr::Worker::my().startTX(TX_MODE::OLTP, TX_ISOLATION_LEVEL::READ_UNCOMMITTED);
+         for (u64 i = begin; i < end; i++) {
+            u64 key = __builtin_bswap64(i);
+            btree->insert(reinterpret_cast<u8*>(&key), sizeof(key), reinterpret_cast<u8*>(&i), sizeof(i));
+         }
+         cr::Worker::my().commitTX();
+      });
+   });
+   crm.joinAll();
+   // -------------------------------------------------------------------------------------
+   u64 start_key = 0;
+   u64 sum = 0;
+   auto tuple_cb = [&](const u8*, u16, const u8* value, u16) {
+      sum += *reinterpret_cast<const u64*>(value);
+      return true;
+   };
+   auto measure = [&](const std::string& variant, std::function<void()> scan) {
+      double best_ns = std::numeric_limits<double>::max();
+      for (u64 r_i = 0; r_i < FLAGS_scan_runs; r_i++) {
+         crm.scheduleJobSync(0, [&]() {
+            sum = 0;
+            cr::Worker::my().startTX(TX_MODE::OLTP, TX_ISOLATION_LEVEL::READ_UNCOMMITTED);
+            const auto begin = std::chrono::high_resolution_clock::now();
+            scan();
+            const auto end = std::chrono::high_resolution_clock::now();
+            cr::Worker::my().commitTX();
+            ensure(sum == FLAGS_scan_tuples * (FLAGS_scan_tuples - 1) / 2);
+            best_ns = std::min<double>(best_ns, std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+         });
+      }
+      cout << variant << "," << best_ns / FLAGS_scan_tuples << "," << FLAGS_scan_tuples * 1e3 / best_ns << endl;
+   };
+   cout << "variant,ns_per_tuple,mtuples_per_second" << endl;
+   measure("std_function", [&]() {
+      std::function<bool(const u8*, u16, const u8*, u16)> callback = tuple_cb;
+      btree->scanAsc<decltype(callback)&>(reinterpret_cast<u8*>(&start_key), sizeof(start_key), callback);
+   });
+   measure("kvinterface_function_ref", [&]() {
+      static_cast<KVInterface*>(btree)->scanAsc(reinterpret_cast<u8*>(&start_key), sizeof(start_key), tuple_cb, {});
+   });
+   measure("template", [&]() { btree->scanAsc(reinterpret_cast<u8*>(&start_key), sizeof(start_key), tuple_cb); });
+   measure("cursor", [&]() {
+      BTreeLL::Cursor cursor(*btree);
+      for (bool valid = cursor.seek(Slice(reinterpret_cast<u8*>(&start_key), sizeof(start_key))); valid; valid = cursor.next()) {
+         sum += *reinterpret_cast<const u64*>(cursor.value().data());
+      }
+   });
+   return 0;
+}
@@ -0,0 +1,94 @@
+#include "Units.hpp"
+#include "leanstore/Config.hpp"
+#include "leanstore/LeanStore.hpp"
+// -------------------------------------------------------------------------------------
+#include <gflags/gflags.h>
+// -------------------------------------------------------------------------------------
+#include <cstring>
+#include <iostream>
+// -------------------------------------------------------------------------------------
+// Secondary index entries of a tuple whose indexed column moves A -> B -> A: within one transaction, over two transactions
+// before the removed entry is garbage collected, and rolled back. Each run must commit and leave exactly one entry under A
+// -------------------------------------------------------------------------------------
+using namespace leanstore;
+using storage::btree::BTreeVI;
+// -------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+   gflags::ParseCommandLineFlags(&argc, &argv, true);
+   FLAGS_vi = true;
+   // -------------------------------------------------------------------------------------
+   LeanStore db;
+   auto& crm = db.getCRManager();
+   crm.scheduleJobSync(0, [&]() {
+      BTreeVI& table = db.registerBTreeVI("si_table", {.enable_wal = FLAGS_wal, .use_bulk_insert = false});
+      BTreeVI& index = db.registerBTreeVI("si_index", {.enable_wal = FLAGS_wal, .use_bulk_insert = false});
+      // The value is the secondary key
+      const u64 index_id = table.addSecondaryIndex(index, [](Slice, Slice value, u8* secondary_key) {
+         std::memcpy(secondary_key, value.data(), value.length());
+         return static_cast<u16>(value.length());
+      });
+      u64 key = 1;
+      u64 a = 0xAAAA, b = 0xBBBB;
+      auto put = [&](u64& value) {
+         return table.update(reinterpret_cast<u8*>(&key), sizeof(key), reinterpret_cast<u8*>(&value), sizeof(value));
+      };
+      auto entries = [&](u64 secondary) {
+         u64 count = 0;
+         table.scanIndexAsc(index_id, reinterpret_cast<u8*>(&secondary), sizeof(secondary),
+                            [&](const u8* secondary_key, u16 secondary_key_length, const u8* primary_key, u16 primary_key_length) {
+                               if (secondary_key_length != sizeof(secondary) || std::memcmp(secondary_key, &secondary, sizeof(secondary)) != 0) {
+                                  return false;
+                               }
+                               ensure(primary_key_length == sizeof(key) && std::memcmp(primary_key, &key, sizeof(key)) == 0);
+                               count++;
+                               return true;
+                            });
+         return count;
+      };
+      auto check = [&](const char* run) {
+         cr::Worker::my().startTX(TX_MODE::OLTP, TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION, true);
+         ensure(entries(a) == 1 && entries(b) == 0);
+         ensure(cr::Worker::my().commitTX());
+         std::cout << run << " passed" << std::endl;
+      };
+      // -------------------------------------------------------------------------------------
+      jumpmuTry()
+      {
+         cr::Worker::my().startTX(TX_MODE::OLTP, TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION);
+         ensure(table.insert(reinterpret_cast<u8*>(&key), sizeof(key), reinterpret_cast<u8*>(&a), sizeof(a)) == OP_RESULT::OK);
+         ensure(cr::Worker::my().commitTX());
+         check("insert");
+         // -------------------------------------------------------------------------------------
+         cr::Worker::my().startTX(TX_MODE::OLTP, TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION);
+         ensure(put(b) == OP_RESULT::OK);
+         ensure(put(a) == OP_RESULT::OK);
+         ensure(cr::Worker::my().commitTX());
+         check("A -> B -> A in one transaction");
+         // -------------------------------------------------------------------------------------
+         cr::Worker::my().startTX(TX_MODE::OLTP, TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION);
+         ensure(put(b) == OP_RESULT::OK);
+         ensure(cr::Worker::my().commitTX());
+         cr::Worker::my().startTX(TX_MODE::OLTP, TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION);
+         ensure(put(a) == OP_RESULT::OK);
+         ensure(cr::Worker::my().commitTX());
+         check("A -> B -> A in two transactions");
+      }
+      jumpmuCatch() { ensure(false); }
+      // -------------------------------------------------------------------------------------
+      // abortTX jumps to the catch of its own
+      auto roll_back = [&]() {
+         jumpmuTry()
+         {
+            cr::Worker::my().startTX(TX_MODE::OLTP, TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION);
+            ensure(put(b) == OP_RESULT::OK);
+            ensure(put(a) == OP_RESULT::OK);
+            cr::Worker::my().abortTX();
+         }
+         jumpmuCatch() {}
+      };
+      roll_back();
+      check("A -> B -> A rolled back");
+   });
+   return 0;
+}
@@ -0,0 +1,72 @@
+#include "../shared/GenericSchema.hpp"
+#include "../shared/LeanStoreAdapter.hpp"
+#include "Units.hpp"
+#include "leanstore/Config.hpp"
+#include "leanstore/LeanStore.hpp"
+// -------------------------------------------------------------------------------------
+#include <gflags/gflags.h>
+// -------------------------------------------------------------------------------------
+#include <chrono>
+#include <iostream>
+#include <vector>
+// -------------------------------------------------------------------------------------
+// Cost of startTX + commitTX against the number of threads, for read-only and for writing transactions (one insert each),
+// with start timestamps read from the clock (--cc_read_start_ts) and drawn from it
+// -------------------------------------------------------------------------------------
+using namespace leanstore;
+// -------------------------------------------------------------------------------------
+using Key = u64;
+using Payload = u64;
+using KVTable = Relation<Key, Payload>;
+// -------------------------------------------------------------------------------------
+DEFINE_uint64(ts_tx_per_thread, 1000000, "Transactions per thread and run");
+// -------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+   gflags::ParseCommandLineFlags(&argc, &argv, true);
+   // -------------------------------------------------------------------------------------
+   LeanStore db;
+   auto& crm = db.getCRManager();
+   LeanStoreAdapter<KVTable> table;
+   crm.scheduleJobSync(0, [&]() { table = LeanStoreAdapter<KVTable>(db, "timestamps"); });
+   // -------------------------------------------------------------------------------------
+   u64 run_i = 0;  // keys of each run are new
+   auto run = [&](u64 threads, bool writing) {
+      const auto begin = std::chrono::high_resolution_clock::now();
+      for (u64 t_i = 0; t_i < threads; t_i++) {
+         crm.scheduleJobAsync(t_i, [&, t_i]() {
+            for (u64 tx_i = 0; tx_i < FLAGS_ts_tx_per_thread; tx_i++) {
+               jumpmuTry()
+               {
+                  cr::Worker::my().startTX(TX_MODE::OLTP, TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION, !writing);
+                  if (writing) {
+                     table.insert({(run_i << 48) | (t_i << 32) | tx_i}, {tx_i});
+                  }
+                  cr::Worker::my().commitTX();
+               }
+               jumpmuCatch() { ensure(false); }
+            }
+         });
+      }
+      crm.joinAll();
+      run_i++;
+      const auto end = std::chrono::high_resolution_clock::now();
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() * 1.0 / FLAGS_ts_tx_per_thread;
+   };
+   // -------------------------------------------------------------------------------------
+   cout << "threads,read_start_ts,read_only_ns_per_tx,writing_ns_per_tx" << endl;
+   std::vector<u64> thread_counts;
+   for (u64 threads = 1; threads < FLAGS_worker_threads; threads *= 2) {
+      thread_counts.push_back(threads);
+   }
+   thread_counts.push_back(FLAGS_worker_threads);
+   for (u64 threads : thread_counts) {
+      for (bool read_start_ts : {false, true}) {
+         FLAGS_cc_read_start_ts = read_start_ts;
+         const double read_only_ns = run(threads, false);
+         const double writing_ns = run(threads, true);
+         cout << threads << "," << read_start_ts << "," << read_only_ns << "," << writing_ns << endl;
+      }
+   }
+   return 0;
+}
@@ -0,0 +1,88 @@
+#include "Units.hpp"
+#include "leanstore/concurrency-recovery/WALCompression.hpp"
+#include "leanstore/utils/RandomGenerator.hpp"
+// -------------------------------------------------------------------------------------
+#include <gflags/gflags.h>
+// -------------------------------------------------------------------------------------
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+// -------------------------------------------------------------------------------------
+// Round trip of the WAL blocks the group committer writes with --wal_compression: a compressible piece, an incompressible one
+// that is stored raw, and a piece that wraps around the end of the WAL buffer and becomes two consecutive blocks
+// -------------------------------------------------------------------------------------
+using namespace leanstore;
+using cr::WALCompressedBlock;
+// -------------------------------------------------------------------------------------
+DEFINE_uint64(wc_wal_buffer_kib, 256, "Size of the simulated WAL buffer of a worker");
+// -------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+   gflags::ParseCommandLineFlags(&argc, &argv, true);
+   const u64 wal_buffer_size = FLAGS_wc_wal_buffer_kib * 1024;
+   constexpr WORKERID worker_id = 3;
+   // -------------------------------------------------------------------------------------
+   // Like the staging buffer of the group committer: aligned, and dirty so that missing padding would show
+   auto allocate = [](u64 size) {
+      std::unique_ptr<u8, decltype(&std::free)> buffer(reinterpret_cast<u8*>(std::aligned_alloc(512, size)), &std::free);
+      std::memset(buffer.get(), 0xFF, size);
+      return buffer;
+   };
+   auto check_block = [&](const WALCompressedBlock& block, u64 block_size, u64 wal_size, u64 wal_offset) {
+      ensure(block_size % 512 == 0 && block_size == block.blockSize() && block_size <= WALCompressedBlock::maxBlockSize(wal_size));
+      ensure(block.worker_id == worker_id && block.wal_size == wal_size && block.wal_offset == wal_offset);
+      const u8* padding = reinterpret_cast<const u8*>(&block) + sizeof(WALCompressedBlock) + block.stored_size;
+      for (const u8* byte = padding; byte < reinterpret_cast<const u8*>(&block) + block_size; byte++) {
+         ensure(*byte == 0);
+      }
+   };
+   // Writes the piece as one block, reads it back and returns whether it was compressed
+   auto round_trip = [&](const u8* wal, u64 wal_size) {
+      auto blocks = allocate(WALCompressedBlock::maxBlockSize(wal_size));
+      const u64 block_size = WALCompressedBlock::write(blocks.get(), worker_id, wal, wal_size, 0);
+      const auto& block = *reinterpret_cast<const WALCompressedBlock*>(blocks.get());
+      check_block(block, block_size, wal_size, 0);
+      std::vector<u8> restored(wal_size);
+      ensure(block.read(restored.data(), restored.size()) == wal_size);
+      ensure(std::memcmp(restored.data(), wal, wal_size) == 0);
+      return block.is_compressed;
+   };
+   // -------------------------------------------------------------------------------------
+   std::vector<u8> wal(wal_buffer_size);
+   for (u64 i = 0; i < wal_buffer_size; i++) {
+      wal[i] = u8(i % 64);  // repetitive like WAL entry headers
+   }
+   ensure(round_trip(wal.data(), wal_buffer_size));
+   std::cout << "compressed block passed" << std::endl;
+   // -------------------------------------------------------------------------------------
+   for (u64 i = 0; i < wal_buffer_size; i += sizeof(u64)) {
+      const u64 random = utils::RandomGenerator::getRandU64();
+      std::memcpy(wal.data() + i, &random, std::min<u64>(sizeof(u64), wal_buffer_size - i));
+   }
+   ensure(!round_trip(wal.data(), wal_buffer_size));
+   std::cout << "raw block passed" << std::endl;
+   // -------------------------------------------------------------------------------------
+   // The piece from cursor to the end of the buffer and the one from its start to written_offset, staged back to back
+   for (u64 i = 0; i < wal_buffer_size / 2; i++) {
+      wal[i] = u8(i % 64);
+   }
+   const u64 cursor = wal_buffer_size - 1000, written_offset = 3000;
+   auto blocks = allocate(WALCompressedBlock::maxBlockSize(wal_buffer_size - cursor) + WALCompressedBlock::maxBlockSize(written_offset));
+   u64 blocks_size = WALCompressedBlock::write(blocks.get(), worker_id, wal.data() + cursor, wal_buffer_size - cursor, cursor);
+   blocks_size += WALCompressedBlock::write(blocks.get() + blocks_size, worker_id, wal.data(), written_offset, 0);
+   std::vector<u8> restored(wal_buffer_size, 0);
+   u64 restored_size = 0;
+   for (u64 offset = 0; offset < blocks_size;) {
+      const auto& block = *reinterpret_cast<const WALCompressedBlock*>(blocks.get() + offset);
+      check_block(block, block.blockSize(), block.wal_size, block.wal_offset);
+      restored_size += block.read(restored.data() + block.wal_offset, wal_buffer_size - block.wal_offset);
+      offset += block.blockSize();
+   }
+   ensure(restored_size == wal_buffer_size - cursor + written_offset);
+   ensure(std::memcmp(restored.data() + cursor, wal.data() + cursor, wal_buffer_size - cursor) == 0);
+   ensure(std::memcmp(restored.data(), wal.data(), written_offset) == 0);
+   std::cout << "wrapped blocks passed" << std::endl;
+   return 0;
+}
@@ -34,6 +34,8 @@ struct LeanStoreAdapter : Adapter<Record> {
          }
       }
    }
+   // Any other data structure, e.g. a hash table for point operations
+   LeanStoreAdapter(leanstore::KVInterface& kv, string name) : btree(&kv), name(name) {}
    // -------------------------------------------------------------------------------------
    void printTreeHeight() { cout << name << " height = " << btree->getHeight() << endl; }
    // -------------------------------------------------------------------------------------
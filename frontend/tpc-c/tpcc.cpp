@@ -256,11 +256,12 @@ int main(int argc, char** argv)
                   tpcc.tx(w_id);
                   if (FLAGS_tpcc_abort_pct && tpcc.urand(0, 100) <= FLAGS_tpcc_abort_pct) {
                      cr::Worker::my().abortTX();
+                  } else if (cr::Worker::my().commitTX()) {
+                     WorkerCounters::myCounters().tx++;
+                     tx_acc = tx_acc + 1;
                   } else {
-                     cr::Worker::my().commitTX();
+                     WorkerCounters::myCounters().tx_abort++;  // failed its serializable validation
                   }
-                  WorkerCounters::myCounters().tx++;
-                  tx_acc = tx_acc + 1;
                }
                jumpmuCatch()
                {
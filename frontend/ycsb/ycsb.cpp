@@ -26,6 +26,7 @@ DEFINE_bool(ycsb_count_unique_lookup_keys, true, "");
 DEFINE_bool(ycsb_warmup, true, "");
 DEFINE_uint32(ycsb_sleepy_thread, 0, "");
 DEFINE_uint32(ycsb_ops_per_tx, 1, "");
+DEFINE_bool(ycsb_hash_table, false, "store the table in a hash table instead of a B-Tree, compare both with ycsb_read_ratio=100");
 // -------------------------------------------------------------------------------------
 using namespace leanstore;
 // -------------------------------------------------------------------------------------
@@ -50,10 +51,18 @@ int main(int argc, char** argv)
    LeanStore db;
    auto& crm = db.getCRManager();
    LeanStoreAdapter<KVTable> table;
-   crm.scheduleJobSync(0, [&]() { table = LeanStoreAdapter<KVTable>(db, "YCSB"); });
+   crm.scheduleJobSync(0, [&]() {
+      if (FLAGS_ycsb_hash_table) {
+         auto& hash_table = FLAGS_recover ? db.retrieveHashTable("YCSB") : db.registerHashTable("YCSB", {.enable_wal = FLAGS_wal});
+         table = LeanStoreAdapter<KVTable>(hash_table, "YCSB");
+      } else {
+         table = LeanStoreAdapter<KVTable>(db, "YCSB");
+      }
+   });
    db.registerConfigEntry("ycsb_read_ratio", FLAGS_ycsb_read_ratio);
    db.registerConfigEntry("ycsb_threads", FLAGS_ycsb_threads);
    db.registerConfigEntry("ycsb_ops_per_tx", FLAGS_ycsb_ops_per_tx);
+   db.registerConfigEntry("ycsb_hash_table", FLAGS_ycsb_hash_table);
    // -------------------------------------------------------------------------------------
    leanstore::TX_ISOLATION_LEVEL isolation_level = leanstore::parseIsolationLevel(FLAGS_isolation_level);
    const TX_MODE tx_type = TX_MODE::OLTP;
@@ -174,8 +183,11 @@ int main(int argc, char** argv)
                      leanstore::storage::BMC::global_bf->evictLastPage();  // to ignore the replacement strategy effect on MVCC experiment
                   }
                }
-               cr::Worker::my().commitTX();
-               WorkerCounters::myCounters().tx++;
+               if (cr::Worker::my().commitTX()) {
+                  WorkerCounters::myCounters().tx++;
+               } else {
+                  WorkerCounters::myCounters().tx_abort++;
+               }
             }
             jumpmuCatch() { WorkerCounters::myCounters().tx_abort++; }
          }
@@ -0,0 +1,7 @@
+for history_log in false true; do
+build/frontend/ycsb --ycsb_tuple_count=10000000 --ycsb_read_ratio=50 --zipf_factor=0.99 \
+--ssd_path=/home/ubuntu/data/test.txt \
+--worker_threads=120 --pp_threads=4 --dram_gib=8 \
+--csv_path=./log_history_log_${history_log} --csv_truncate --run_for_seconds=60 \
+--isolation_level=si --history_log=${history_log}
+done
\ No newline at end of file